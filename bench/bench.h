@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+//
+// Timing helpers shared by the benchmark programs in this directory. Each
+// benchmark is a standalone program that prints its own table:
+//
+//     g++ -std=c++17 -O3 -march=native -DNDEBUG -pthread -Iinclude bench/bench_xxx.cpp && ./a.out
+//
+
+// best wall-clock time of fn() over repeats runs, in seconds
+template<typename Fn>
+double bench_time(Fn fn, int repeats = 5)
+{
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto stop  = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+// keep the compiler from discarding a computed value
+template<typename T>
+void bench_keep(const T& value)
+{
+    static volatile T sink;
+    sink = value;
+}
@@ -0,0 +1,51 @@
+#include <numeric>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// time of evaluating an expression into an existing array
+template<typename Expr>
+double evaluate(const Expr& expr, array<float, 2>& dst)
+{
+    return bench_time([&] {
+        data_copy(expr, dst);
+        bench_keep(dst.data()[dst.size() - 1]);
+    }, 20);
+}
+
+// expressions with broadcast operands, against the same expressions with
+// the operands materialized first by repeat() or broadcast()
+void run(size_t m, size_t n)
+{
+    array<float, 2> a(std::array<size_t, 2>{m, n});
+    array<float, 1> v(std::array<size_t, 1>{n});
+    array<float, 2> col(std::array<size_t, 2>{m, 1});
+    std::iota(a.data(), a.data() + a.size(), 0.0f);
+    std::iota(v.data(), v.data() + v.size(), 1.0f);
+    std::iota(col.data(), col.data() + col.size(), 2.0f);
+    array<float, 2> dst(std::array<size_t, 2>{m, n});
+
+    const double ms = 1e3;
+    std::printf("%6zu %6zu %-28s %8.3f\n", m, n, "a + a", evaluate(a + a, dst) * ms);
+    std::printf("%6zu %6zu %-28s %8.3f\n", m, n, "a + v", evaluate(a + v, dst) * ms);
+    std::printf("%6zu %6zu %-28s %8.3f\n", m, n, "a + repeat(v, m)", bench_time([&] {
+        data_copy(a + repeat(v, m), dst);
+        bench_keep(dst.data()[dst.size() - 1]);
+    }, 20) * ms);
+    std::printf("%6zu %6zu %-28s %8.3f\n", m, n, "a + vbroadcast(col, m, n)",
+                evaluate(a + vbroadcast(col, m, n), dst) * ms);
+    std::printf("%6zu %6zu %-28s %8.3f\n", m, n, "a + broadcast(col, m, n)", bench_time([&] {
+        data_copy(a + broadcast(col, m, n), dst);
+        bench_keep(dst.data()[dst.size() - 1]);
+    }, 20) * ms);
+}
+
+int main()
+{
+    std::printf("%6s %6s %-28s %8s  (ms)\n", "m", "n", "expression", "time");
+    run(4096, 512);
+    run(512, 4096);
+    run(65536, 16);
+}
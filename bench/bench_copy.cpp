@@ -0,0 +1,89 @@
+#include <array>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+//
+// GB/s (bytes read + written) of the copy engine per kind of view, against a
+// plain loop over the same elements. Build once more with
+// -DNDARRAY_DISABLE_SIMD to compare with the scalar fallback.
+//
+
+template<typename T>
+void run(const char* type)
+{
+    const size_t n = size_t(1) << 22, stride = 8;
+    array<T, 1> src(std::array<size_t, 1>{n * stride}), dst(std::array<size_t, 1>{n * stride});
+    for (size_t i = 0; i < src.size(); ++i)
+        src.data()[i] = T(i);
+    const T* s = src.data();
+    T*       d = dst.data();
+    const double gb = 2e-9 * double(n) * double(sizeof(T));
+
+    auto report = [&](const char* name, auto naive, auto engine)
+    {
+        const double t_naive  = bench_time(naive);
+        const double t_engine = bench_time(engine);
+        std::printf("%-7s %-28s %9.2f %9.2f\n", type, name, gb / t_naive, gb / t_engine);
+    };
+
+    auto contiguous_src = src(span(0, n));
+    auto contiguous_dst = dst(span(0, n));
+    report("contiguous (memcpy)",
+           [&] { for (size_t i = 0; i < n; ++i) d[i] = s[i]; bench_keep(d[n - 1]); },
+           [&] { data_copy(contiguous_src, contiguous_dst); bench_keep(d[n - 1]); });
+
+    for (size_t step : {size_t(2), stride})
+    {
+        auto strided_src = src(span(0, n * step, step));
+        auto strided_dst = dst(span(0, n * step, step));
+        char name[64];
+        std::snprintf(name, sizeof(name), "gather, stride %zu", step);
+        report(name,
+               [&] { for (size_t i = 0; i < n; ++i) d[i] = s[i * step]; bench_keep(d[n - 1]); },
+               [&] { data_copy(strided_src, contiguous_dst); bench_keep(d[n - 1]); });
+        std::snprintf(name, sizeof(name), "scatter, stride %zu", step);
+        report(name,
+               [&] { for (size_t i = 0; i < n; ++i) d[i * step] = s[i]; bench_keep(d[0]); },
+               [&] { data_copy(contiguous_src, strided_dst); bench_keep(d[0]); });
+    }
+
+    // a column of a row-major matrix, one strided row per copy
+    const size_t cols = 64, rows = n / cols;
+    auto mat_src = make_array_ref(src.data(), std::array<size_t, 2>{rows, cols});
+    auto mat_dst = make_array_ref(dst.data(), std::array<size_t, 2>{cols, rows});
+    report("regular 2D (transpose)",
+           [&] { for (size_t i = 0; i < rows; ++i) for (size_t j = 0; j < cols; ++j) d[j * rows + i] = s[i * cols + j];
+                 bench_keep(d[0]); },
+           [&] { mat_dst = vtranspose(mat_src); bench_keep(d[0]); });
+
+    // an index list, which takes the scalar path
+    std::vector<size_t> idx(cols);
+    for (size_t j = 0; j < cols; ++j)
+        idx[j] = (j * 37) % cols;
+    auto irregular = mat_src(span(), span(idx));
+    auto mat_out   = make_array_ref(dst.data(), std::array<size_t, 2>{rows, cols});
+    report("irregular (index list)",
+           [&] { for (size_t i = 0; i < rows; ++i) for (size_t j = 0; j < cols; ++j) d[i * cols + j] = s[i * cols + idx[j]];
+                 bench_keep(d[0]); },
+           [&] { mat_out = irregular; bench_keep(d[0]); });
+}
+
+int main()
+{
+#if defined(NDARRAY_X86_SIMD)
+    const simd_level_type level = simd_level();
+    std::printf("simd level: %s\n", level == simd_level_type::avx512 ? "avx512" :
+                level == simd_level_type::avx2 ? "avx2" : "scalar");
+#else
+    std::printf("simd level: scalar\n");
+#endif
+    std::printf("%-7s %-28s %9s %9s  (GB/s)\n", "type", "copy", "naive", "engine");
+    run<float>("float");
+    run<double>("double");
+    run<int32_t>("int32");
+    run<int16_t>("int16");
+}
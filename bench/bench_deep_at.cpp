@@ -0,0 +1,94 @@
+#include <array>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// view of a with level1 on level 1 and every other index on the others
+template<typename Array, typename Indexer, size_t... Is>
+auto make_view(Array& a, Indexer level1, std::index_sequence<Is...>)
+{
+    return a(span(1, 0, 2), level1, ((void)Is, span(1, 0, 2))...);
+}
+
+// lookups per ns of at() at random positions of 4 to 6 level views, against
+// the offsets computed by hand; every level of the view takes every other
+// index of the array, and the irregular views take an index list on level 1;
+// the arrays are small enough to stay in cache
+template<size_t Depth, bool IsIrregular>
+void run(const char* name, size_t dim)
+{
+    std::array<size_t, Depth> dims;
+    dims.fill(dim);
+    array<float, Depth> a(dims);
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = float(i % 1000);
+
+    std::array<size_t, Depth> strides;
+    strides[Depth - 1] = 1;
+    for (size_t l = Depth - 1; l > 0; --l)
+        strides[l - 1] = strides[l] * dim;
+
+    std::vector<size_t> list;
+    for (size_t i = 0; i < dim / 2; ++i)
+        list.push_back(dim - 2 - 2 * i);
+
+    const auto view = [&]
+    {
+        if constexpr (IsIrregular)
+            return make_view(a, span(list), std::make_index_sequence<Depth - 2>{});
+        else
+            return make_view(a, span(0, 0, 2), std::make_index_sequence<Depth - 2>{});
+    }();
+
+    const size_t n_positions = size_t(1) << 14, n_rounds = 64;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> dist(0, dim / 2 - 1);
+    std::vector<std::array<size_t, Depth>> positions(n_positions);
+    for (auto& pos : positions)
+        for (auto& i : pos)
+            i = dist(rng);
+
+    const double t_at = bench_time([&]
+    {
+        float s = 0;
+        for (size_t r = 0; r < n_rounds; ++r)
+            for (const auto& pos : positions)
+                s += std::apply([&](auto... ints) { return view.at(ints...); }, pos);
+        bench_keep(s);
+    });
+    const double t_hand = bench_time([&]
+    {
+        const float* data = a.data();
+        float s = 0;
+        for (size_t r = 0; r < n_rounds; ++r)
+            for (const auto& pos : positions)
+            {
+                size_t offset = (1 + 2 * pos[0]) * strides[0];
+                offset += (IsIrregular ? list[pos[1]] : 2 * pos[1]) * strides[1];
+                for (size_t l = 2; l < Depth; ++l)
+                    offset += (1 + 2 * pos[l]) * strides[l];
+                s += data[offset];
+            }
+        bench_keep(s);
+    });
+
+    const double n = 1e-9 * double(n_positions * n_rounds);
+    std::printf("%-26s %10zu %9.3f %9.3f\n", name, view.size(), n / t_at, n / t_hand);
+}
+
+int main()
+{
+    std::printf("%-26s %10s %9s %9s  (lookups/ns)\n", "view", "size", "at()", "by hand");
+    run<4, false>("4 levels, regular", 16);
+    run<4, true >("4 levels, irregular", 16);
+    run<5, false>("5 levels, regular", 10);
+    run<5, true >("5 levels, irregular", 10);
+    run<6, false>("6 levels, regular", 6);
+    run<6, true >("6 levels, irregular", 6);
+}
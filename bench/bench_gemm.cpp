@@ -0,0 +1,72 @@
+#include <array>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// GFLOP/s of matmul() and dot() against naive loops over the same operands
+template<typename T>
+void run(const char* name, size_t n)
+{
+    array<T, 2> a(std::array<size_t, 2>{n, n}), b(std::array<size_t, 2>{n, n});
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a.data()[i] = T(i % 7);
+        b.data()[i] = T(i % 5);
+    }
+
+    array<T, 2> c(std::array<size_t, 2>{n, n});
+    const double t_naive = bench_time([&]
+    {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+            {
+                T s{};
+                for (size_t p = 0; p < n; ++p)
+                    s += a.data()[i * n + p] * b.data()[p * n + j];
+                c.data()[i * n + j] = s;
+            }
+    }, 1);
+    const double t_seq = bench_time([&] { bench_keep(matmul(a, b).data()[0]); });
+    const double t_par = bench_time([&] { bench_keep(matmul(par, a, b).data()[0]); });
+
+    const double gflop = 2e-9 * double(n) * double(n) * double(n);
+    std::printf("matmul %-7s %5zu %9.2f %9.2f %9.2f\n", name, n, gflop / t_naive, gflop / t_seq, gflop / t_par);
+}
+
+template<typename T>
+void run_dot(const char* name, size_t n)
+{
+    std::vector<T> x(n), y(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = T(i % 7);
+        y[i] = T(i % 5);
+    }
+    const double t_naive = bench_time([&]
+    {
+        T s{};
+        for (size_t i = 0; i < n; ++i)
+            s += x[i] * y[i];
+        bench_keep(s);
+    });
+    const double t_seq = bench_time([&] { bench_keep(dot(x, y)); });
+    const double t_par = bench_time([&] { bench_keep(dot(par, x, y)); });
+
+    const double gflop = 2e-9 * double(n);
+    std::printf("dot    %-7s %5zuM %8.2f %9.2f %9.2f\n", name, n >> 20, gflop / t_naive, gflop / t_seq, gflop / t_par);
+}
+
+int main()
+{
+    std::printf("%-6s %-7s %5s %9s %9s %9s  (GFLOP/s)\n", "", "type", "n", "naive", "seq", "par");
+    run<float>("float", 512);
+    run<double>("double", 512);
+    run<float>("float", 1024);
+    run<double>("double", 1024);
+    run<int>("int", 512);
+    run_dot<float>("float", size_t(1) << 24);
+    run_dot<double>("double", size_t(1) << 24);
+}
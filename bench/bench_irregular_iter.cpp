@@ -0,0 +1,76 @@
+#include <array>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// elements per ns of walking an irregular view by its element iterator,
+// against at() and against a loop over the index lists by hand
+template<typename Indexer0, typename Indexer2>
+void run(const char* name, const array<float, 3>& a, Indexer0 span0, Indexer2 span2)
+{
+    const auto view = a(span0, span(), span2);
+    const size_t d0 = view.template dimension<0>(), d1 = view.template dimension<1>(), d2 = view.template dimension<2>();
+    const double n = 1e-9 * double(view.size());
+
+    const double t_iter = bench_time([&]
+    {
+        float s = 0;
+        const auto end = view.element_cend();
+        for (auto iter = view.element_cbegin(); iter != end; ++iter)
+            s += *iter;
+        bench_keep(s);
+    });
+    const double t_at = bench_time([&]
+    {
+        float s = 0;
+        for (size_t i = 0; i < d0; ++i)
+            for (size_t j = 0; j < d1; ++j)
+                for (size_t k = 0; k < d2; ++k)
+                    s += view.at(i, j, k);
+        bench_keep(s);
+    });
+    const double t_copy = bench_time([&] { bench_keep(make_array(view).data()[0]); });
+
+    std::printf("%-26s %10zu %9.3f %9.3f %9.3f\n", name, view.size(), n / t_iter, n / t_at, n / t_copy);
+}
+
+int main()
+{
+    const size_t m = 64, k = 256;
+    array<float, 3> a(std::array<size_t, 3>{m, 64, k});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = float(i % 1000);
+
+    std::vector<size_t> rows(m / 2), cols(k / 2), pairs;
+    for (size_t i = 0; i < rows.size(); ++i)
+        rows[i] = (i * 7) % m;
+    for (size_t i = 0; i < cols.size(); ++i)
+        cols[i] = (i * 37) % k;
+    for (size_t i = 0; i < k / 2; ++i)
+        pairs.push_back(2 * i);
+
+    std::printf("%-26s %10s %9s %9s %9s  (elements/ns)\n", "view", "size", "iterator", "at()", "copy");
+    run("index list, last level", a, span(), span(cols));
+    run("even indices, last level", a, span(), span(pairs));
+    run("index list, first level", a, span(rows), span());
+    run("index lists, both levels", a, span(rows), span(cols));
+
+    // the same elements by hand, for reference
+    const double n = 1e-9 * double(m * 64 * cols.size());
+    const double t_hand = bench_time([&]
+    {
+        float s = 0;
+        for (size_t i = 0; i < m; ++i)
+            for (size_t j = 0; j < 64; ++j)
+            {
+                const float* row = a.data() + (i * 64 + j) * k;
+                for (size_t c : cols)
+                    s += row[c];
+            }
+        bench_keep(s);
+    });
+    std::printf("%-26s %10zu %9.3f\n", "by hand, last level", size_t(m * 64 * cols.size()), n / t_hand);
+}
@@ -0,0 +1,46 @@
+#include <memory>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// bandwidth of materializing a view into a new array, with storage that is
+// value-initialized first (std::allocator, the default) and storage left
+// uninitialized (default_init_allocator)
+template<typename Alloc, typename View>
+double materialize(const View& view)
+{
+    using T = array_elem_of_t<View>;
+    return bench_time([&] {
+        array<T, 2, Alloc> a(default_init, view.dimensions());
+        view.copy_to(a.data());
+        bench_keep(a.data()[a.size() - 1]);
+    });
+}
+
+template<typename T>
+void run(const char* name, size_t n)
+{
+    array<T, 2> src({n, n});
+    src = range(T(n * n));
+    auto full = src.vpart(span(), span());
+    auto half = src.vpart(span(), span(0, n, 2));
+
+    const double gb_full = 2.0 * sizeof(T) * n * n / 1e9;
+    const double gb_half = gb_full / 2;
+    const double t0 = materialize<std::allocator<T>>(full);
+    const double t1 = materialize<default_init_allocator<T>>(full);
+    const double t2 = materialize<std::allocator<T>>(half);
+    const double t3 = materialize<default_init_allocator<T>>(half);
+    std::printf("%-8s %-10s %8.2f GB/s %8.2f GB/s\n", name, "simple", gb_full / t0, gb_full / t1);
+    std::printf("%-8s %-10s %8.2f GB/s %8.2f GB/s\n", name, "regular", gb_half / t2, gb_half / t3);
+}
+
+int main()
+{
+    std::printf("%-8s %-10s %13s %13s\n", "type", "view", "value-init", "default-init");
+    run<float>("float", 4096);
+    run<double>("double", 4096);
+    run<int>("int", 4096);
+}
@@ -0,0 +1,46 @@
+#include <numeric>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// time of repeating a vector of n elements m times, as the former repeat()
+// did it (element by element through vrepeat()), with the doubling copies
+// of repeat(), and with repeat(par)
+void run(size_t n, size_t m, int repeats)
+{
+    array<float, 1> v(std::array<size_t, 1>{n});
+    std::iota(v.data(), v.data() + n, 0.0f);
+
+    const double t_elem = bench_time([&] {
+        for (int r = 0; r < repeats; ++r)
+        {
+            const auto lazy = vrepeat(v, m);
+            array<float, 2> a(default_init, lazy.dimensions());
+            auto src = lazy.element_cbegin();
+            for (size_t i = 0; i < a.size(); ++i, ++src)
+                a.data()[i] = *src;
+            bench_keep(a.data()[a.size() - 1]);
+        }
+    });
+    const double t_seq = bench_time([&] {
+        for (int r = 0; r < repeats; ++r)
+            bench_keep(repeat(v, m).data()[n * m - 1]);
+    });
+    const double t_par = bench_time([&] {
+        for (int r = 0; r < repeats; ++r)
+            bench_keep(repeat(par, v, m).data()[n * m - 1]);
+    });
+    const double us = 1e6 / repeats;
+    std::printf("%8zu %8zu %12.3f %12.3f %12.3f\n", n, m, t_elem * us, t_seq * us, t_par * us);
+}
+
+int main()
+{
+    std::printf("%8s %8s %12s %12s %12s  (us)\n", "n", "copies", "elementwise", "repeat", "repeat(par)");
+    run(16, 64, 10000);
+    run(512, 64, 1000);
+    run(512, 4096, 10);
+    run(4096, 4096, 2);
+}
@@ -0,0 +1,62 @@
+#include <array>
+#include <thread>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// speedup of the parallel operations on executors of 1, 2, 4, ... threads up
+// to the hardware concurrency, against the same operation under seq; the
+// seq column is in milliseconds
+template<typename Fn>
+void run(const char* name, const std::vector<size_t>& threads, Fn fn)
+{
+    const double t_seq = bench_time([&] { fn(seq); });
+    std::printf("%-30s %9.2f", name, 1e3 * t_seq);
+    for (size_t n : threads)
+    {
+        executor ex(n);
+        std::printf(" %7.2fx", t_seq / bench_time([&] { fn(ex); }));
+    }
+    std::printf("\n");
+}
+
+int main()
+{
+    const size_t hw = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<size_t> threads;
+    for (size_t n = 1; n < hw; n *= 2)
+        threads.push_back(n);
+    threads.push_back(hw);
+
+    std::printf("%-30s %9s", "operation", "seq (ms)");
+    for (size_t n : threads)
+        std::printf(" %6zuth", n);
+    std::printf("\n");
+
+    const size_t n = 2048;
+    const array<float, 2> a = table([](int i, int j) { return float((i * 7 + j * 3) % 101); }, int(n), int(n));
+    const array<float, 2> b = table([](int i, int j) { return float((i + j * 5) % 13); }, 512, 512);
+    array<float, 2> dst(default_init, std::array<size_t, 2>{n, n});
+
+    run("data_copy contiguous", threads, [&](auto& policy)
+        { data_copy(policy, a, dst); bench_keep(dst.data()[n]); });
+    run("data_copy a + 2 * a", threads, [&](auto& policy)
+        { data_copy(policy, a + 2.0f * a, dst); bench_keep(dst.data()[n]); });
+    run("make_array strided view", threads, [&](auto& policy)
+        { bench_keep(make_array(policy, a(span(0, 0, 2), span(0, 0, 3))).data()[n]); });
+    run("transpose", threads, [&](auto& policy)
+        { bench_keep(transpose(policy, a).data()[n]); });
+    run("table 2048 x 2048", threads, [&](auto& policy)
+        { bench_keep(table(policy, [](int i, int j) { return float(i) * 0.5f + float(j); }, int(n), int(n)).data()[n]); });
+    run("sum", threads, [&](auto& policy)
+        { bench_keep(sum(policy, a)); });
+    run("cumsum<1>", threads, [&](auto& policy)
+        { bench_keep(cumsum<1>(policy, a).data()[n]); });
+    run("sort rows", threads, [&](auto& policy)
+        { bench_keep(sort(policy, a).data()[n]); });
+    run("matmul 512", threads, [&](auto& policy)
+        { bench_keep(matmul(policy, b, b).data()[n]); });
+}
@@ -0,0 +1,70 @@
+#include <numeric>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// scans of an n x n array of doubles along level 0, level 1 and all
+// elements, against loops by hand that write into an existing array
+void run(size_t n)
+{
+    array<double, 2> a(std::array<size_t, 2>{n, n});
+    std::iota(a.data(), a.data() + a.size(), 0.5);
+    array<double, 2> out(std::array<size_t, 2>{n, n});
+
+    // by hand: at() on every element, and lanes of raw pointers
+    const double t_at = bench_time([&] {
+        for (size_t j = 0; j < n; ++j)
+            out.at(0, j) = a.at(0, j);
+        for (size_t i = 1; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                out.at(i, j) = out.at(i - 1, j) + a.at(i, j);
+        bench_keep(out.data()[n * n - 1]);
+    });
+    const double t_lanes = bench_time([&] {
+        const double* src = a.data();
+        double*       dst = out.data();
+        std::copy_n(src, n, dst);
+        for (size_t i = 1; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                dst[i * n + j] = dst[(i - 1) * n + j] + src[i * n + j];
+        bench_keep(out.data()[n * n - 1]);
+    });
+    const double t_rows = bench_time([&] {
+        for (size_t i = 0; i < n; ++i)
+            std::partial_sum(a.data() + i * n, a.data() + (i + 1) * n, out.data() + i * n);
+        bench_keep(out.data()[n * n - 1]);
+    });
+    const double t_flat = bench_time([&] {
+        std::partial_sum(a.data(), a.data() + n * n, out.data());
+        bench_keep(out.data()[n * n - 1]);
+    });
+
+    const auto scan = [&](auto fn) {
+        return bench_time([&] { bench_keep(fn().data()[n * n - 1]); });
+    };
+    const double ms = 1e3;
+    std::printf("%6zu %-10s %10.3f %10.3f %10.3f %10.3f\n", n, "level 0", t_at * ms, t_lanes * ms,
+                scan([&] { return cumsum<0>(a); }) * ms, scan([&] { return cumsum<0>(par, a); }) * ms);
+    std::printf("%6zu %-10s %10s %10.3f %10.3f %10.3f\n", n, "level 1", "", t_rows * ms,
+                scan([&] { return cumsum<1>(a); }) * ms, scan([&] { return cumsum<1>(par, a); }) * ms);
+    std::printf("%6zu %-10s %10s %10.3f %10.3f %10.3f\n", n, "all", "", t_flat * ms,
+                scan([&] { return cumsum(a); }) * ms, scan([&] { return cumsum(par, a); }) * ms);
+
+    // an irregular view, which is gathered by runs
+    std::vector<size_t> rows(n / 2);
+    for (size_t i = 0; i < rows.size(); ++i)
+        rows[i] = (i * 7) % n;
+    const auto view = a(span(rows), span());
+    std::printf("%6zu %-10s %10s %10s %10.3f %10.3f\n", n, "irregular", "", "",
+                bench_time([&] { bench_keep(cumsum<0>(view).data()[0]); }) * ms,
+                bench_time([&] { bench_keep(cumsum<0>(par, view).data()[0]); }) * ms);
+}
+
+int main()
+{
+    std::printf("%6s %-10s %10s %10s %10s %10s  (ms)\n", "n", "level", "at()", "by hand", "cumsum", "cumsum(par)");
+    run(500);
+    run(2000);
+}
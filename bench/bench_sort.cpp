@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+template<typename T>
+array<T, 2> random_array(size_t m, size_t n)
+{
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<T> dist(-1, 1);
+    array<T, 2> a(std::array<size_t, 2>{m, n});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = dist(rng);
+    return a;
+}
+
+// sort of every row of an m x n array, against std::sort() of each row of a
+// copy, and stable argsort against std::stable_sort() of indices
+template<typename T>
+void run(const char* name, size_t m, size_t n)
+{
+    const auto a = random_array<T>(m, n);
+
+    const double t_std = bench_time([&] {
+        auto c = a;
+        for (size_t i = 0; i < m; ++i)
+            std::sort(c.data() + i * n, c.data() + (i + 1) * n);
+        bench_keep(c.data()[0]);
+    }, 3);
+    const double t_seq = bench_time([&] { bench_keep(sort(a).data()[0]); }, 3);
+    const double t_par = bench_time([&] { bench_keep(sort(par, a).data()[0]); }, 3);
+
+    const double t_std_arg = bench_time([&] {
+        std::vector<size_t> index(m * n);
+        for (size_t i = 0; i < m; ++i)
+        {
+            const T* row   = a.data() + i * n;
+            size_t*  first = index.data() + i * n;
+            std::iota(first, first + n, size_t(0));
+            std::stable_sort(first, first + n, [row](size_t x, size_t y) { return row[x] < row[y]; });
+        }
+        bench_keep(index[0]);
+    }, 3);
+    const double t_arg     = bench_time([&] { bench_keep(argsort(a).data()[0]); }, 3);
+    const double t_arg_par = bench_time([&] { bench_keep(argsort(par, a).data()[0]); }, 3);
+
+    const double ms = 1e3;
+    std::printf("%-7s %9zu %9zu %10.1f %10.1f %10.1f %12.1f %10.1f %12.1f\n", name, m, n,
+                t_std * ms, t_seq * ms, t_par * ms, t_std_arg * ms, t_arg * ms, t_arg_par * ms);
+}
+
+int main()
+{
+    std::printf("%-7s %9s %9s %10s %10s %10s %12s %10s %12s  (ms)\n", "type", "rows", "length",
+                "std::sort", "sort", "sort(par)", "std::stable", "argsort", "argsort(par)");
+    run<float>("float", 1000000, 32);
+    run<float>("float", 10000, 1000);
+    run<double>("double", 1, 10000000);
+}
@@ -0,0 +1,66 @@
+#include <array>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// elements per nanosecond of table() against nested loops computing the
+// same values, for integer, range, array and strided-view arguments
+template<typename Naive, typename Seq, typename Par>
+void run(const char* name, size_t size, Naive naive, Seq seq, Par par_fn)
+{
+    const double t_naive = bench_time(naive);
+    const double t_seq   = bench_time(seq);
+    const double t_par   = bench_time(par_fn);
+    const double n = 1e-9 * double(size);
+    std::printf("%-28s %10zu %9.3f %9.3f %9.3f\n", name, size, n / t_naive, n / t_seq, n / t_par);
+}
+
+int main()
+{
+    std::printf("%-28s %10s %9s %9s %9s  (elements/ns)\n", "arguments", "size", "naive", "seq", "par");
+
+    const int n = 2048;
+    array<int, 2> out_i(default_init, std::array<size_t, 2>{size_t(n), size_t(n)});
+    auto fn_i = [](int i, int j) { return i * 3 + j; };
+    run("int x int", out_i.size(),
+        [&] { for (int i = 0; i < n; ++i) for (int j = 0; j < n; ++j) out_i.data()[size_t(i) * n + j] = fn_i(i, j);
+              bench_keep(out_i.data()[n]); },
+        [&] { bench_keep(table(fn_i, n, n).data()[n]); },
+        [&] { bench_keep(table(par, fn_i, n, n).data()[n]); });
+
+    array<float, 2> out_f(default_init, std::array<size_t, 2>{size_t(n), size_t(n)});
+    auto fn_f = [](float x, float y) { return x * x + y; };
+    const auto xs = vrange(0.0f, 1.0f, 1.0f / float(n));
+    run("float range x float range", out_f.size(),
+        [&] { for (int i = 0; i < n; ++i) for (int j = 0; j < n; ++j)
+                  out_f.data()[size_t(i) * n + j] = fn_f(xs.at(i), xs.at(j));
+              bench_keep(out_f.data()[n]); },
+        [&] { bench_keep(table(fn_f, xs, xs).data()[n]); },
+        [&] { bench_keep(table(par, fn_f, xs, xs).data()[n]); });
+
+    const array<float, 1> xa = make_array(xs);
+    run("float array x float array", out_f.size(),
+        [&] { for (int i = 0; i < n; ++i) for (int j = 0; j < n; ++j)
+                  out_f.data()[size_t(i) * n + j] = fn_f(xa.data()[i], xa.data()[j]);
+              bench_keep(out_f.data()[n]); },
+        [&] { bench_keep(table(fn_f, xa, xa).data()[n]); },
+        [&] { bench_keep(table(par, fn_f, xa, xa).data()[n]); });
+
+    // 64 x 128 x 256 over strided views, small enough to stay in cache
+    auto fn_3 = [](float x, float y, float z) { return x * y + z; };
+    const auto va = xa(span(0, 0, 32)), vb = xa(span(0, 0, 16)), vc = xa(span(0, 0, 8));
+    array<float, 3> out_3(default_init, std::array<size_t, 3>{va.size(), vb.size(), vc.size()});
+    run("3 strided views (x100)", 100 * out_3.size(),
+        [&] { for (int r = 0; r < 100; ++r)
+              {
+                  float* dst = out_3.data();
+                  for (size_t i = 0; i < va.size(); ++i) for (size_t j = 0; j < vb.size(); ++j)
+                      for (size_t k = 0; k < vc.size(); ++k)
+                          *dst++ = fn_3(va.at(i), vb.at(j), vc.at(k));
+                  bench_keep(out_3.data()[r]);
+              } },
+        [&] { for (int r = 0; r < 100; ++r) bench_keep(table(fn_3, va, vb, vc).data()[r]); },
+        [&] { for (int r = 0; r < 100; ++r) bench_keep(table(par, fn_3, va, vb, vc).data()[r]); });
+}
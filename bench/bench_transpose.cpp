@@ -0,0 +1,44 @@
+#include <array>
+
+#include "ndarray/ndarray.h"
+#include "bench.h"
+
+using namespace ndarray;
+
+// GB/s (read + write) of an n x n transpose by a naive loop, by the tiled
+// copy engine behind vtranspose(), and by transpose(par, ...)
+template<typename T>
+void run(const char* name, size_t n)
+{
+    array<T, 2> a(std::array<size_t, 2>{n, n}), b(std::array<size_t, 2>{n, n});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = T(i);
+    b = vtranspose(a);
+
+    const double t_naive = bench_time([&]
+    {
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                b.data()[j * n + i] = a.data()[i * n + j];
+        bench_keep(b.data()[n]);
+    });
+    const double t_seq = bench_time([&] { b = vtranspose(a); bench_keep(b.data()[n]); });
+    const double t_par = bench_time([&] { bench_keep(transpose(par, a).data()[n]); });
+
+    const double gb = 2e-9 * double(n) * double(n) * double(sizeof(T));
+    std::printf("%-7s %5zu %9.2f %9.2f %9.2f\n", name, n, gb / t_naive, gb / t_seq, gb / t_par);
+}
+
+int main()
+{
+#if defined(NDARRAY_X86_SIMD)
+    const simd_level_type level = simd_level();
+    std::printf("simd level: %s\n", level == simd_level_type::avx512 ? "avx512" :
+                level == simd_level_type::avx2 ? "avx2" : "scalar");
+#endif
+    std::printf("%-7s %5s %9s %9s %9s  (GB/s)\n", "type", "n", "naive", "seq", "par");
+    run<float>("float", 4096);
+    run<double>("double", 4096);
+    run<float>("float", 1000);
+    run<double>("double", 1000);
+}
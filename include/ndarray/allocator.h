@@ -0,0 +1,386 @@
+#pragma once
+
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "decls.h"
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace ndarray
+{
+
+//
+// Allocators that can be passed to array<T, Depth, Alloc> to control how
+// its storage is obtained.
+//
+//  allocator                storage
+//---------------------------------------------------------------------
+//  std::allocator<T>        operator new (default)
+//  aligned_allocator<T, N>  aligned to N bytes, 64 by default
+//  huge_page_allocator<T>   aligned to 2 MiB and backed by transparent
+//                           huge pages when large enough (Linux only)
+//  pool_allocator<T>        blocks recycled through a memory_pool
+//
+// default_init_allocator<T, A> can wrap any of them to skip the
+// initialization of elements that are overwritten right after allocation.
+//
+
+// allocate bytes aligned to alignment, which must be a power of two
+inline void* _aligned_alloc_bytes(size_t bytes, size_t alignment)
+{
+    alignment = std::max(alignment, sizeof(void*));
+    bytes     = std::max(bytes, size_t(1));
+#if defined(_MSC_VER)
+    void* ptr = _aligned_malloc(bytes, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, bytes) != 0)
+        ptr = nullptr;
+#endif
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+// free memory obtained from _aligned_alloc_bytes()
+inline void _aligned_free_bytes(void* ptr) noexcept
+{
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+// number of bytes for n elements of T, throws if it overflows
+template<typename T>
+inline size_t _alloc_bytes_of(size_t n)
+{
+    if (n > size_t(-1) / sizeof(T))
+        throw std::bad_array_new_length();
+    return n * sizeof(T);
+}
+
+
+template<typename T, size_t Alignment = 64>
+class aligned_allocator
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "alignment is smaller than the alignment of T");
+
+public:
+    using value_type = T;
+    template<typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+public:
+    aligned_allocator() noexcept = default;
+    template<typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(_aligned_alloc_bytes(_alloc_bytes_of<T>(n), Alignment));
+    }
+    void deallocate(T* ptr, size_t) noexcept
+    {
+        _aligned_free_bytes(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const aligned_allocator<U, Alignment>&) const noexcept
+    {
+        return true;
+    }
+    template<typename U>
+    bool operator!=(const aligned_allocator<U, Alignment>&) const noexcept
+    {
+        return false;
+    }
+};
+
+
+// size and alignment of a transparent huge page
+constexpr size_t _huge_page_size_v = size_t(1) << 21;
+
+template<typename T>
+class huge_page_allocator
+{
+public:
+    using value_type = T;
+    template<typename U>
+    struct rebind
+    {
+        using other = huge_page_allocator<U>;
+    };
+
+public:
+    huge_page_allocator() noexcept = default;
+    template<typename U>
+    huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        const size_t bytes = _alloc_bytes_of<T>(n);
+        if (bytes < _huge_page_size_v) // too small to benefit from huge pages
+            return static_cast<T*>(_aligned_alloc_bytes(bytes, std::max(size_t(64), alignof(T))));
+
+        // round up to whole huge pages so that the tail is also covered
+        const size_t rounded = (bytes + _huge_page_size_v - 1) / _huge_page_size_v * _huge_page_size_v;
+        void* ptr = _aligned_alloc_bytes(rounded, _huge_page_size_v);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        madvise(ptr, rounded, MADV_HUGEPAGE); // only a hint, failure is harmless
+#endif
+        return static_cast<T*>(ptr);
+    }
+    void deallocate(T* ptr, size_t) noexcept
+    {
+        _aligned_free_bytes(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const huge_page_allocator<U>&) const noexcept
+    {
+        return true;
+    }
+    template<typename U>
+    bool operator!=(const huge_page_allocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+
+// memory_pool keeps freed blocks in free lists of power-of-two size classes
+// and hands them out again, so that arrays which are repeatedly created and
+// destroyed with similar sizes do not go back to the system allocator.
+// Blocks are 64-byte aligned. At most max_cached_bytes are kept in the free
+// lists; blocks beyond that are freed immediately.
+class memory_pool
+{
+public:
+    static constexpr size_t _min_class_v = 6;  // 64 bytes
+    static constexpr size_t _n_classes_v = sizeof(size_t) * 8;
+
+public:
+    explicit memory_pool(size_t max_cached_bytes = size_t(1) << 30) :
+        max_cached_bytes_{max_cached_bytes} {}
+
+    memory_pool(const memory_pool&) = delete;
+    memory_pool& operator=(const memory_pool&) = delete;
+
+    ~memory_pool()
+    {
+        release();
+    }
+
+    void* allocate(size_t bytes)
+    {
+        const size_t cls = _size_class(bytes);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& list = free_lists_[cls];
+            if (!list.empty())
+            {
+                void* ptr = list.back();
+                list.pop_back();
+                cached_bytes_ -= size_t(1) << cls;
+                return ptr;
+            }
+        }
+        return _aligned_alloc_bytes(size_t(1) << cls, size_t(64));
+    }
+
+    void deallocate(void* ptr, size_t bytes) noexcept
+    {
+        const size_t cls   = _size_class(bytes);
+        const size_t block = size_t(1) << cls;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cached_bytes_ + block <= max_cached_bytes_)
+            {
+                try
+                {
+                    free_lists_[cls].push_back(ptr);
+                    cached_bytes_ += block;
+                    return;
+                }
+                catch (...)
+                { // fall through and free the block
+                }
+            }
+        }
+        _aligned_free_bytes(ptr);
+    }
+
+    // free all cached blocks
+    void release() noexcept
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& list : free_lists_)
+        {
+            for (void* ptr : list)
+                _aligned_free_bytes(ptr);
+            list.clear();
+        }
+        cached_bytes_ = 0;
+    }
+
+    // total bytes currently kept in the free lists
+    size_t cached_bytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cached_bytes_;
+    }
+
+private:
+    static size_t _size_class(size_t bytes)
+    {
+        size_t cls = _min_class_v;
+        while (cls + 1 < _n_classes_v && (size_t(1) << cls) < bytes)
+            ++cls;
+        return cls;
+    }
+
+    mutable std::mutex  mutex_;
+    std::vector<void*>  free_lists_[_n_classes_v];
+    size_t              cached_bytes_ = 0;
+    const size_t        max_cached_bytes_;
+};
+
+// the pool used by pool_allocator unless another one is given, which is
+// never destroyed so that arrays with static storage can still free into it
+inline memory_pool& default_memory_pool()
+{
+    static memory_pool* pool = new memory_pool();
+    return *pool;
+}
+
+template<typename T>
+class pool_allocator
+{
+    template<typename U>
+    friend class pool_allocator;
+
+public:
+    using value_type = T;
+    template<typename U>
+    struct rebind
+    {
+        using other = pool_allocator<U>;
+    };
+
+public:
+    pool_allocator() noexcept :
+        pool_{&default_memory_pool()} {}
+    explicit pool_allocator(memory_pool& pool) noexcept :
+        pool_{&pool} {}
+    template<typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept :
+        pool_{other.pool_} {}
+
+    T* allocate(size_t n)
+    {
+        static_assert(alignof(T) <= 64, "pool_allocator only provides 64-byte alignment");
+        return static_cast<T*>(pool_->allocate(_alloc_bytes_of<T>(n)));
+    }
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        pool_->deallocate(ptr, n * sizeof(T));
+    }
+
+    memory_pool& pool() const noexcept
+    {
+        return *pool_;
+    }
+
+    template<typename U>
+    bool operator==(const pool_allocator<U>& other) const noexcept
+    {
+        return pool_ == other.pool_;
+    }
+    template<typename U>
+    bool operator!=(const pool_allocator<U>& other) const noexcept
+    {
+        return pool_ != other.pool_;
+    }
+
+private:
+    memory_pool* pool_;
+};
+
+
+// tag for constructors that allocate storage to be overwritten by the caller
+struct default_init_t
+{
+    explicit default_init_t() = default;
+};
+constexpr default_init_t default_init{};
+
+// default_init_allocator<T, A> behaves as A, except that elements constructed
+// without arguments are default-initialized instead of value-initialized, so
+// that e.g. resizing a std::vector<int> through it leaves new elements
+// uninitialized rather than zeroing them. array(default_init, ...) relies on
+// it: with std::allocator<T>, the default, the elements are value-initialized
+// anyway, since std::vector<T> offers no way around it. The library uses it
+// for its own temporary storage as well.
+template<typename T, typename A = std::allocator<T>>
+class default_init_allocator : public A
+{
+    using _traits_t = std::allocator_traits<A>;
+
+public:
+    using value_type = T;
+    template<typename U>
+    struct rebind
+    {
+        using other = default_init_allocator<U, typename _traits_t::template rebind_alloc<U>>;
+    };
+
+public:
+    default_init_allocator() = default;
+    default_init_allocator(const A& alloc) noexcept :
+        A(alloc) {}
+    template<typename U, typename B>
+    default_init_allocator(const default_init_allocator<U, B>& other) noexcept :
+        A(static_cast<const B&>(other)) {}
+
+    template<typename U>
+    void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new(static_cast<void*>(ptr)) U;
+    }
+    template<typename U, typename... Args>
+    void construct(U* ptr, Args&&... args)
+    {
+        _traits_t::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+    }
+
+    template<typename U, typename B>
+    bool operator==(const default_init_allocator<U, B>& other) const noexcept
+    {
+        return static_cast<const A&>(*this) == static_cast<const B&>(other);
+    }
+    template<typename U, typename B>
+    bool operator!=(const default_init_allocator<U, B>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+}
+
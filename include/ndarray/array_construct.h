@@ -1,117 +1,313 @@
-#pragma once
-
-#include "traits.h"
-#include "array.h"
-#include "array_view.h"
-#include "range_view.h"
-
-namespace ndarray
-{
-
-template<typename TFirst, typename TLast>
-constexpr inline auto vrange(TFirst first, TLast last)
-{
-    return make_range_view(first, last);
-}
-
-template<typename TFirst, typename TLast, typename TStep>
-constexpr inline auto vrange(TFirst first, TLast last, TStep step)
-{
-    return make_range_view(first, last, step);
-}
-
-template<typename TLast>
-constexpr inline auto vrange(TLast last)
-{
-    return make_range_view(int(0), last);
-}
-
-template<typename TFirst, typename TLast>
-inline auto range(TFirst first, TLast last)
-{
-    return make_array(vrange(first, last));
-}
-
-template<typename TFirst, typename TLast, typename TStep>
-inline auto range(TFirst first, TLast last, TStep step)
-{
-    return make_array(vrange(first, last, step));
-}
-
-template<typename TLast>
-inline auto range(TLast last)
-{
-    return make_array(vrange(last));
-}
-
-
-template<size_t I, typename T, typename Function, typename ArrayTuple>
-inline void _table_impl(T*& data_ptr, Function fn, const ArrayTuple& arrays)
-{
-    const auto& arr_i = std::get<I>(arrays);
-    auto begin = element_begin(arr_i);
-    auto end   = element_end(arr_i);
-
-    if constexpr (I + 1 < std::tuple_size_v<ArrayTuple>)
-        for (; begin != end; ++begin)
-            _table_impl<I + 1>(data_ptr, [=](auto&&... args) { return fn(*begin, std::forward<decltype(args)>(args)...); }, arrays);
-    else
-        for (; begin != end; ++begin)
-        {
-            static_assert(std::is_same_v<decltype(fn(*begin)), T>, "there should not be conversion");
-            *data_ptr = fn(*begin);
-            ++data_ptr;
-        }
-}
-
-template<typename Function, typename... Arrays>
-inline array<std::invoke_result_t<Function, array_or_range_elem_of_t<Arrays>...>, sizeof...(Arrays)> 
-    table(Function fn, Arrays&&... arrays)
-{
-    using result_t = std::invoke_result_t<Function, array_or_range_elem_of_t<Arrays>...>;
-    auto array_tuple = std::make_tuple(make_range_if_arithmetic(std::forward<Arrays>(arrays))...);
-    array<result_t, sizeof...(Arrays)> ret(size_of_array_tuple(array_tuple));
-    result_t* data_ptr = ret.data();
-    _table_impl<0, result_t, Function>(data_ptr, fn, array_tuple);
-    return ret;
-}
-
-template<typename Value, typename... Ints>
-inline auto table_const(Value value, Ints... ints)
-{
-    constexpr size_t depth_v = sizeof...(Ints);
-    using elem_t = decltype(value);
-    std::vector<elem_t> data(size_t((ints * ... * size_t(1))), value);
-    return array<elem_t, depth_v>{std::move(data), {size_t(ints)...}};
-}
-
-template<typename Value, typename... Ints>
-inline auto vtable_const(Value value, Ints... ints)
-{
-    constexpr size_t depth_v = sizeof...(Ints);
-    using elem_t = decltype(value);
-    return repeated_view<elem_t, depth_v>{value, {size_t(ints)...}};
-}
-
-template<typename T, size_t ArrayDepth, typename... Ints>
-inline rep_array_view<array<T, ArrayDepth>, sizeof...(Ints)> vrepeat(array<T, ArrayDepth>&& arr, Ints... ints)
-{
-    constexpr size_t view_depth_v = sizeof...(Ints);
-    return rep_array_view<array<T, ArrayDepth>, view_depth_v>{std::move(arr), {size_t(ints)...}};
-}
-
-template<typename T, size_t ArrayDepth, typename... Ints>
-inline rep_array_view<array<T, ArrayDepth>, sizeof...(Ints)> vrepeat(const array<T, ArrayDepth>& arr, Ints... ints)
-{
-    constexpr size_t view_depth_v = sizeof...(Ints);
-    return rep_array_view<array<T, ArrayDepth>, view_depth_v>{arr, {size_t(ints)...}};
-}
-
-template<typename View, typename... Ints>
-inline auto repeat(View&& view, Ints... ints)
-{
-    return make_array(vrepeat(make_array(std::forward<decltype(view)>(view)), ints...));
-}
-
-
-}
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <tuple>
+
+#include "traits.h"
+#include "array.h"
+#include "array_view.h"
+#include "range_view.h"
+#include "repeated_view.h"
+#include "execution.h"
+#include "array_interface.h"
+
+namespace ndarray
+{
+
+template<typename TFirst, typename TLast>
+constexpr inline auto vrange(TFirst first, TLast last)
+{
+    return make_range_view(first, last);
+}
+
+template<typename TFirst, typename TLast, typename TStep>
+constexpr inline auto vrange(TFirst first, TLast last, TStep step)
+{
+    return make_range_view(first, last, step);
+}
+
+template<typename TLast>
+constexpr inline auto vrange(TLast last)
+{
+    return make_range_view(int(0), last);
+}
+
+template<typename TFirst, typename TLast,
+         std::enable_if_t<!is_execution_policy_v<TFirst>, int> = 0>
+inline auto range(TFirst first, TLast last)
+{
+    return make_array(vrange(first, last));
+}
+
+template<typename TFirst, typename TLast, typename TStep,
+         std::enable_if_t<!is_execution_policy_v<TFirst>, int> = 0>
+inline auto range(TFirst first, TLast last, TStep step)
+{
+    return make_array(vrange(first, last, step));
+}
+
+template<typename TLast>
+inline auto range(TLast last)
+{
+    return make_array(vrange(last));
+}
+
+template<typename ExecutionPolicy, typename TFirst, typename TLast, 
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto range(ExecutionPolicy&& policy, TFirst first, TLast last)
+{
+    return make_array(policy, vrange(first, last));
+}
+
+template<typename ExecutionPolicy, typename TFirst, typename TLast, typename TStep,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto range(ExecutionPolicy&& policy, TFirst first, TLast last, TStep step)
+{
+    return make_array(policy, vrange(first, last, step));
+}
+
+template<typename ExecutionPolicy, typename TLast,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto range(ExecutionPolicy&& policy, TLast last)
+{
+    return make_array(policy, vrange(last));
+}
+
+
+// the elements of an argument of table() by position, which are referred to
+// if the argument is an array, a vector or a simple view, and gathered into
+// a buffer if it is another view (e.g. a strided view)
+template<typename T>
+struct _table_operand
+{
+    std::unique_ptr<T[]> buffer;
+    const T*             data;
+    size_t               size;
+
+    const T& operator[](size_t pos) const
+    {
+        return data[pos];
+    }
+};
+
+// the elements of a range argument of table(), or of an integer argument n,
+// which is the range [0, n), generated from the first element and the step
+template<typename T, bool IsUnitStep>
+struct _table_range_operand
+{
+    T      first;
+    T      step;
+    size_t size;
+
+    T operator[](size_t pos) const
+    {
+        if constexpr (IsUnitStep)
+            return T(first + pos);
+        else
+            return T(first + pos * step);
+    }
+};
+
+template<typename T, bool IsUnitStep>
+inline auto _make_table_operand(const range_view<T, IsUnitStep>& range)
+{
+    return _table_range_operand<T, IsUnitStep>{range.first(), range.step(), range.size()};
+}
+
+template<typename Array, std::enable_if_t<!std::is_arithmetic_v<Array>, int> = 0>
+inline auto _make_table_operand(const Array& arr)
+{
+    using elem_t = std::remove_const_t<array_elem_of_t<Array>>;
+    constexpr array_obj_type type_v = array_obj_type_of_v<Array>;
+
+    _table_operand<elem_t> ret{nullptr, nullptr, arr.size()};
+    if constexpr (type_v == array_obj_type::array || type_v == array_obj_type::vector)
+        ret.data = arr.data();
+    else if constexpr (type_v == array_obj_type::simple)
+        ret.data = arr.base_ptr();
+    else
+    {
+        ret.buffer.reset(new elem_t[ret.size]);
+        auto iter = element_begin(arr);
+        for (size_t i = 0; i < ret.size; ++i, ++iter)
+            ret.buffer[i] = *iter;
+        ret.data = ret.buffer.get();
+    }
+    return ret;
+}
+
+template<typename Arithmetic, std::enable_if_t<std::is_arithmetic_v<Arithmetic>, int> = 0>
+inline auto _make_table_operand(Arithmetic arg)
+{
+    return _make_table_operand(make_range_view(int(0), arg));
+}
+
+template<typename... Operands>
+inline std::array<size_t, sizeof...(Operands)> _table_dims(const std::tuple<Operands...>& operands)
+{
+    return std::apply([](const auto&... ops) { return std::array<size_t, sizeof...(Operands)>{ops.size...}; }, operands);
+}
+
+// one row of a table, over the elements [col, col + size) of the last
+// argument with the other arguments fixed, which vectorizes when fn is
+// simple enough
+template<typename T, typename Function, typename Inner, typename... Outers>
+inline void _table_row(T* dst, Function& fn, const Inner& inner, size_t col, size_t size, const Outers&... outers)
+{
+    static_assert(std::is_same_v<decltype(fn(outers..., inner[col])), T>, "there should not be conversion");
+    for (size_t j = 0; j < size; ++j)
+        dst[j] = fn(outers..., inner[col + j]);
+}
+
+// fill the elements [first, last) of a table, whose position is a flat
+// multi-index over the arguments, row by row
+template<typename T, typename Function, typename OperandTuple, size_t... Is>
+inline void _table_fill(T* data, Function& fn, const OperandTuple& operands,
+                        size_t first, size_t last, std::index_sequence<Is...>)
+{
+    constexpr size_t n_outer = sizeof...(Is);
+    const auto&  inner      = std::get<n_outer>(operands);
+    const size_t inner_size = inner.size;
+    if (first >= last)
+        return;
+
+    const std::array<size_t, n_outer + 1> sizes{std::get<Is>(operands).size..., inner_size};
+    std::array<size_t, n_outer + 1>       index{};
+    size_t col = first % inner_size;
+    size_t row = first / inner_size;
+    for (size_t i = n_outer; i-- > 0;)
+    {
+        index[i] = row % sizes[i];
+        row /= sizes[i];
+    }
+
+    while (first < last)
+    {
+        const size_t size = std::min(inner_size - col, last - first);
+        _table_row(data + first, fn, inner, col, size, std::get<Is>(operands)[index[Is]]...);
+        first += size;
+        col = 0;
+        for (size_t i = n_outer; i-- > 0;)
+        {
+            if (++index[i] < sizes[i])
+                break;
+            index[i] = 0;
+        }
+    }
+}
+
+template<typename Function, typename... Arrays>
+inline array<std::invoke_result_t<Function, array_or_range_elem_of_t<Arrays>...>, sizeof...(Arrays)> 
+    table(Function fn, Arrays&&... arrays)
+{
+    using result_t = std::invoke_result_t<Function, array_or_range_elem_of_t<Arrays>...>;
+    auto operands = std::make_tuple(_make_table_operand(arrays)...);
+    array<result_t, sizeof...(Arrays)> ret(default_init, _table_dims(operands));
+    _table_fill(ret.data(), fn, operands, 0, ret.size(), std::make_index_sequence<sizeof...(Arrays) - 1>{});
+    return ret;
+}
+
+// table() under an execution policy, which splits the elements into
+// parallel chunks of whole or partial rows
+template<typename ExecutionPolicy, typename Function, typename... Arrays,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline array<std::invoke_result_t<Function, array_or_range_elem_of_t<Arrays>...>, sizeof...(Arrays)> 
+    table(ExecutionPolicy&& policy, Function fn, Arrays&&... arrays)
+{
+    using result_t = std::invoke_result_t<Function, array_or_range_elem_of_t<Arrays>...>;
+    auto operands = std::make_tuple(_make_table_operand(arrays)...);
+    array<result_t, sizeof...(Arrays)> ret(default_init, _table_dims(operands));
+    result_t* const data = ret.data();
+    parallel_for(policy, ret.size(), _parallel_min_size_v<result_t>, [&](size_t first, size_t last)
+    {
+        _table_fill(data, fn, operands, first, last, std::make_index_sequence<sizeof...(Arrays) - 1>{});
+    });
+    return ret;
+}
+
+template<typename Value, typename... Ints>
+inline auto table_const(Value value, Ints... ints)
+{
+    constexpr size_t depth_v = sizeof...(Ints);
+    using elem_t = decltype(value);
+    std::vector<elem_t> data(size_t((ints * ... * size_t(1))), value);
+    return array<elem_t, depth_v>{std::move(data), {size_t(ints)...}};
+}
+
+template<typename Value, typename... Ints>
+inline auto vtable_const(Value value, Ints... ints)
+{
+    constexpr size_t depth_v = sizeof...(Ints);
+    using elem_t = decltype(value);
+    return repeated_view<elem_t, depth_v>{value, {size_t(ints)...}};
+}
+
+template<typename T, size_t ArrayDepth, typename Alloc, typename... Ints>
+inline rep_array_view<array<T, ArrayDepth, Alloc>, sizeof...(Ints)> vrepeat(array<T, ArrayDepth, Alloc>&& arr, Ints... ints)
+{
+    constexpr size_t view_depth_v = sizeof...(Ints);
+    return rep_array_view<array<T, ArrayDepth, Alloc>, view_depth_v>{std::move(arr), {size_t(ints)...}};
+}
+
+template<typename T, size_t ArrayDepth, typename Alloc, typename... Ints>
+inline rep_array_view<array<T, ArrayDepth, Alloc>, sizeof...(Ints)> vrepeat(const array<T, ArrayDepth, Alloc>& arr, Ints... ints)
+{
+    constexpr size_t view_depth_v = sizeof...(Ints);
+    return rep_array_view<array<T, ArrayDepth, Alloc>, view_depth_v>{arr, {size_t(ints)...}};
+}
+
+// uninitialized result of repeat(), which keeps the allocator of an array
+template<typename View, typename... Ints>
+inline auto _make_repeat_result(const View& view, Ints... ints)
+{
+    using elem_t = std::remove_const_t<array_elem_of_t<View>>;
+    constexpr size_t depth_v = sizeof...(Ints) + array_depth_of_v<View>;
+    const auto dims = std::apply([=](auto... dims) { return std::array<size_t, depth_v>{size_t(ints)..., dims...}; },
+                                 dimensions(view));
+    if constexpr (array_obj_type_of_v<View> == array_obj_type::array)
+        return array<elem_t, depth_v, typename View::_alloc_t>(default_init, dims, view.get_allocator());
+    else
+        return array<elem_t, depth_v>(default_init, dims);
+}
+
+// repeat() copies the view once into the first block of the result, which
+// is then replicated with doubling copies
+template<typename View, typename... Ints,
+         std::enable_if_t<!is_execution_policy_v<View>, int> = 0>
+inline auto repeat(View&& view, Ints... ints)
+{
+    auto ret = _make_repeat_result(view, ints...);
+    const size_t sub_size = view.size();
+    if (ret.size() == 0)
+        return ret;
+    auto first_block = make_array_ref(ret.data(), dimensions(view));
+    data_copy(view, first_block);
+    _replicate_block(ret.data(), ret.data(), sub_size, ret.size() / sub_size);
+    return ret;
+}
+
+// repeat() under an execution policy, which splits the copies of the view
+// into parallel chunks
+template<typename ExecutionPolicy, typename View, typename... Ints,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto repeat(ExecutionPolicy&& policy, View&& view, Ints... ints)
+{
+    auto ret = _make_repeat_result(view, ints...);
+    const size_t sub_size = view.size();
+    if (ret.size() == 0)
+        return ret;
+    auto first_block = make_array_ref(ret.data(), dimensions(view));
+    data_copy(policy, view, first_block);
+    using elem_t = typename decltype(ret)::_elem_t;
+    elem_t* const data = ret.data();
+    parallel_for(policy, ret.size() / sub_size, _parallel_grain<elem_t>(sub_size), [&](size_t first, size_t last)
+    {
+        _replicate_block(data, data + first * sub_size, sub_size, last - first);
+    });
+    return ret;
+}
+
+
+}
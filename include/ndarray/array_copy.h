@@ -0,0 +1,723 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "decls.h"
+
+#if !defined(NDARRAY_DISABLE_SIMD) && \
+    (defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__))
+#define NDARRAY_X86_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// compile a single function for a specific instruction set, so that it can
+// be selected at runtime without enabling the instruction set globally
+#if defined(NDARRAY_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define NDARRAY_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NDARRAY_TARGET(isa)
+#endif
+
+namespace ndarray
+{
+
+//
+// Copy engine used by copy_to() and copy_from() of arrays and array views.
+//
+//  source            destination       kernel
+//---------------------------------------------------------------------
+//  contiguous        contiguous        memcpy
+//  strided           contiguous        gather (AVX-512 / AVX2)
+//  contiguous        strided           scatter (AVX-512)
+//  otherwise                           scalar loop
+//
+// Multi-level copies with a stride per level, e.g. into or out of a
+// strided_view, follow the levels of the destination; when the source is
+// contiguous along a different level than the destination, those two
+// levels are copied in tiles of _copy_tile_v x _copy_tile_v elements, which
+// are transposed in registers in blocks of 8 x 8 or 16 x 16 elements of 4
+// bytes (4 x 4 or 8 x 8 of 8 bytes) with AVX2 or AVX-512.
+//
+// SIMD kernels only apply to trivially copyable elements of 4 or 8 bytes
+// when the source and the destination have the same type, and are chosen
+// at runtime according to simd_level(). Define NDARRAY_DISABLE_SIMD to
+// always use the scalar fallback.
+//
+
+enum class simd_level_type
+{
+    scalar,
+    avx2,
+    avx512
+};
+
+inline simd_level_type _detect_simd_level()
+{
+#if defined(NDARRAY_X86_SIMD)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return simd_level_type::scalar;
+    __cpuid(info, 1);
+    const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    const bool has_avx     = (info[2] & (1 << 28)) != 0;
+    if (!has_osxsave || !has_avx)
+        return simd_level_type::scalar;
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    const bool has_avx2    = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x06) == 0x06;
+    const bool has_avx512f = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+    return has_avx512f ? simd_level_type::avx512 :
+        has_avx2 ? simd_level_type::avx2 : simd_level_type::scalar;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") ? simd_level_type::avx512 :
+        __builtin_cpu_supports("avx2") ? simd_level_type::avx2 : simd_level_type::scalar;
+#endif
+#else
+    return simd_level_type::scalar;
+#endif
+}
+
+// the best instruction set supported by the running processor, detected once
+inline simd_level_type simd_level()
+{
+    static const simd_level_type level = _detect_simd_level();
+    return level;
+}
+
+
+// whether elements can be copied by their bytes from S to D
+template<typename S, typename D>
+constexpr bool _is_bitwise_copyable_v =
+    std::is_same_v<std::remove_const_t<S>, D> && std::is_trivially_copyable_v<D>;
+
+// number of elements below which SIMD kernels are not worth the setup
+constexpr size_t _simd_copy_threshold_v = 16;
+
+// the largest stride that keeps 32-bit gather/scatter indices in range
+constexpr ptrdiff_t _max_simd_stride_v = ptrdiff_t(INT32_MAX / 16);
+
+
+#if defined(NDARRAY_X86_SIMD)
+
+// dst[i] = src[i * stride] for 4-byte elements, returns elements copied
+NDARRAY_TARGET("avx2")
+inline size_t _gather_copy_avx2_32(const void* src, ptrdiff_t stride, void* dst, size_t size)
+{
+    const int32_t* src_ptr = static_cast<const int32_t*>(src);
+    int32_t*       dst_ptr = static_cast<int32_t*>(dst);
+    const int32_t  s       = int32_t(stride);
+    const __m256i  vindex  = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8, src_ptr += 8 * stride)
+    {
+        __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(src_ptr), vindex, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_ptr + i), v);
+    }
+    return i;
+}
+
+// dst[i] = src[i * stride] for 8-byte elements, returns elements copied
+NDARRAY_TARGET("avx2")
+inline size_t _gather_copy_avx2_64(const void* src, ptrdiff_t stride, void* dst, size_t size)
+{
+    const int64_t* src_ptr = static_cast<const int64_t*>(src);
+    int64_t*       dst_ptr = static_cast<int64_t*>(dst);
+    const int64_t  s       = int64_t(stride);
+    const __m256i  vindex  = _mm256_setr_epi64x(0, s, 2 * s, 3 * s);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4, src_ptr += 4 * stride)
+    {
+        __m256i v = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src_ptr), vindex, 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_ptr + i), v);
+    }
+    return i;
+}
+
+// dst[i] = src[i * stride] for 4-byte elements, returns elements copied
+NDARRAY_TARGET("avx512f")
+inline size_t _gather_copy_avx512_32(const void* src, ptrdiff_t stride, void* dst, size_t size)
+{
+    const int32_t* src_ptr = static_cast<const int32_t*>(src);
+    int32_t*       dst_ptr = static_cast<int32_t*>(dst);
+    const __m512i  vindex  = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm512_set1_epi32(int32_t(stride)));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16, src_ptr += 16 * stride)
+    {
+        __m512i v = _mm512_i32gather_epi32(vindex, src_ptr, 4);
+        _mm512_storeu_si512(dst_ptr + i, v);
+    }
+    return i;
+}
+
+// dst[i] = src[i * stride] for 8-byte elements, returns elements copied
+NDARRAY_TARGET("avx512f")
+inline size_t _gather_copy_avx512_64(const void* src, ptrdiff_t stride, void* dst, size_t size)
+{
+    const int64_t* src_ptr = static_cast<const int64_t*>(src);
+    int64_t*       dst_ptr = static_cast<int64_t*>(dst);
+    const int64_t  s       = int64_t(stride);
+    const __m512i  vindex  = _mm512_setr_epi64(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8, src_ptr += 8 * stride)
+    {
+        __m512i v = _mm512_i64gather_epi64(vindex, src_ptr, 8);
+        _mm512_storeu_si512(dst_ptr + i, v);
+    }
+    return i;
+}
+
+// dst[i * stride] = src[i] for 4-byte elements, returns elements copied
+NDARRAY_TARGET("avx512f")
+inline size_t _scatter_copy_avx512_32(const void* src, void* dst, ptrdiff_t stride, size_t size)
+{
+    const int32_t* src_ptr = static_cast<const int32_t*>(src);
+    int32_t*       dst_ptr = static_cast<int32_t*>(dst);
+    const __m512i  vindex  = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm512_set1_epi32(int32_t(stride)));
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16, dst_ptr += 16 * stride)
+    {
+        __m512i v = _mm512_loadu_si512(src_ptr + i);
+        _mm512_i32scatter_epi32(dst_ptr, vindex, v, 4);
+    }
+    return i;
+}
+
+// dst[i * stride] = src[i] for 8-byte elements, returns elements copied
+NDARRAY_TARGET("avx512f")
+inline size_t _scatter_copy_avx512_64(const void* src, void* dst, ptrdiff_t stride, size_t size)
+{
+    const int64_t* src_ptr = static_cast<const int64_t*>(src);
+    int64_t*       dst_ptr = static_cast<int64_t*>(dst);
+    const int64_t  s       = int64_t(stride);
+    const __m512i  vindex  = _mm512_setr_epi64(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8, dst_ptr += 8 * stride)
+    {
+        __m512i v = _mm512_loadu_si512(src_ptr + i);
+        _mm512_i64scatter_epi64(dst_ptr, vindex, v, 8);
+    }
+    return i;
+}
+
+#endif // NDARRAY_X86_SIMD
+
+// copy with gather kernels, returns the number of elements copied
+template<typename T>
+inline size_t _simd_gather_copy(const T* src, ptrdiff_t stride, T* dst, size_t size)
+{
+#if defined(NDARRAY_X86_SIMD)
+    if (size < _simd_copy_threshold_v || stride > _max_simd_stride_v || stride < -_max_simd_stride_v)
+        return 0;
+    const simd_level_type level = simd_level();
+    if constexpr (sizeof(T) == 4)
+    {
+        if (level == simd_level_type::avx512)
+            return _gather_copy_avx512_32(src, stride, dst, size);
+        if (level == simd_level_type::avx2)
+            return _gather_copy_avx2_32(src, stride, dst, size);
+    }
+    if constexpr (sizeof(T) == 8)
+    {
+        if (level == simd_level_type::avx512)
+            return _gather_copy_avx512_64(src, stride, dst, size);
+        if (level == simd_level_type::avx2)
+            return _gather_copy_avx2_64(src, stride, dst, size);
+    }
+#endif
+    return 0;
+}
+
+// copy with scatter kernels, returns the number of elements copied
+template<typename T>
+inline size_t _simd_scatter_copy(const T* src, T* dst, ptrdiff_t stride, size_t size)
+{
+#if defined(NDARRAY_X86_SIMD)
+    if (size < _simd_copy_threshold_v || stride > _max_simd_stride_v || stride < -_max_simd_stride_v)
+        return 0;
+    if (simd_level() != simd_level_type::avx512)
+        return 0;
+    if constexpr (sizeof(T) == 4)
+        return _scatter_copy_avx512_32(src, dst, stride, size);
+    if constexpr (sizeof(T) == 8)
+        return _scatter_copy_avx512_64(src, dst, stride, size);
+#endif
+    return 0;
+}
+
+// copy size elements between two pointers with strides, assuming no aliasing
+template<typename S, typename D>
+inline void _strided_copy(S* src, ptrdiff_t src_stride, D* dst, ptrdiff_t dst_stride, size_t size)
+{
+    static_assert(!std::is_const_v<D>);
+    size_t done = 0;
+    if constexpr (_is_bitwise_copyable_v<S, D>)
+    {
+        if (src_stride == 1 && dst_stride == 1)
+        {
+            if (size > 0)
+                std::memcpy(dst, src, size * sizeof(D));
+            return;
+        }
+        if constexpr (sizeof(D) == 4 || sizeof(D) == 8)
+        {
+            if (dst_stride == 1)
+                done = _simd_gather_copy<D>(src, src_stride, dst, size);
+            else if (src_stride == 1)
+                done = _simd_scatter_copy<D>(src, dst, dst_stride, size);
+        }
+    }
+    src += ptrdiff_t(done) * src_stride;
+    dst += ptrdiff_t(done) * dst_stride;
+    for (size_t i = done; i < size; ++i, src += src_stride, dst += dst_stride)
+        *dst = *src;
+}
+
+
+// copy size elements between two pointers with the same stride, where the
+// destination may overlap with the source; like memmove, the direction is
+// chosen so that no source element is overwritten before it is read
+template<typename S, typename D>
+inline void _overlapped_strided_copy(S* src, D* dst, ptrdiff_t stride, size_t size)
+{
+    static_assert(std::is_same_v<std::remove_const_t<S>, D>);
+    const ptrdiff_t dist = dst - src;
+    if (dist == 0 || size == 0)
+        return;
+    if constexpr (std::is_trivially_copyable_v<D>)
+    {
+        if (stride == 1)
+        {
+            std::memmove(dst, src, size * sizeof(D));
+            return;
+        }
+    }
+    if ((dist > 0) == (stride > 0))
+    { // dst is ahead of src along the stride, copy backward
+        for (ptrdiff_t i = ptrdiff_t(size) - 1; i >= 0; --i)
+            dst[i * stride] = src[i * stride];
+    }
+    else
+    { // dst is behind src along the stride, copy forward
+        for (size_t i = 0; i < size; ++i, src += stride, dst += stride)
+            *dst = *src;
+    }
+}
+
+
+// gives the pointer and the stride of an iterator if it accesses elements
+// with a fixed stride in memory
+template<typename Iter>
+struct _strided_iter_traits
+{
+    static constexpr bool value = std::is_pointer_v<Iter>;
+    static auto* ptr(Iter iter) { return iter; }
+    static ptrdiff_t stride(Iter) { return 1; }
+};
+template<typename T, bool IsExplicitConst>
+struct _strided_iter_traits<simple_elem_iter<T, IsExplicitConst>>
+{
+    using _iter_t = simple_elem_iter<T, IsExplicitConst>;
+    static constexpr bool value = true;
+    static auto* ptr(const _iter_t& iter) { return iter._ptr(); }
+    static ptrdiff_t stride(const _iter_t&) { return 1; }
+};
+template<typename T, bool IsExplicitConst>
+struct _strided_iter_traits<regular_elem_iter<T, IsExplicitConst>>
+{
+    using _iter_t = regular_elem_iter<T, IsExplicitConst>;
+    static constexpr bool value = true;
+    static auto* ptr(const _iter_t& iter) { return iter._ptr(); }
+    static ptrdiff_t stride(const _iter_t& iter) { return iter._stride(); }
+};
+
+// whether an iterator walks contiguous memory, see _strided_iter_traits
+template<typename Iter>
+constexpr bool _is_contiguous_iter_v = std::is_pointer_v<Iter>;
+template<typename T, bool IsExplicitConst>
+constexpr bool _is_contiguous_iter_v<simple_elem_iter<T, IsExplicitConst>> = true;
+
+// copy size elements from a strided pointer to an iterator, assuming no aliasing
+template<typename T, typename Iter>
+inline void _strided_copy_to(T* src, ptrdiff_t src_stride, Iter dst, size_t size)
+{
+    using traits_t = _strided_iter_traits<Iter>;
+    if constexpr (traits_t::value)
+    {
+        _strided_copy(src, src_stride, traits_t::ptr(dst), traits_t::stride(dst), size);
+    }
+    else
+    {
+        for (size_t i = 0; i < size; ++i, ++dst, src += src_stride)
+            *dst = *src;
+    }
+}
+
+// copy size elements from an iterator to a strided pointer, assuming no aliasing
+template<typename Iter, typename T>
+inline void _strided_copy_from(Iter src, T* dst, ptrdiff_t dst_stride, size_t size)
+{
+    using traits_t = _strided_iter_traits<Iter>;
+    if constexpr (traits_t::value)
+    {
+        _strided_copy(traits_t::ptr(src), traits_t::stride(src), dst, dst_stride, size);
+    }
+    else
+    {
+        for (size_t i = 0; i < size; ++i, ++src, dst += dst_stride)
+            *dst = *src;
+    }
+}
+
+
+// elements per side of the tiles copied by _strided_tile_copy(); rows of
+// larger tiles with power-of-two strides collide in the L1 cache
+constexpr size_t _copy_tile_v = 16;
+
+#if defined(NDARRAY_X86_SIMD)
+
+// transposes 8 x 8 floats in registers
+NDARRAY_TARGET("avx2")
+inline void _transpose_8x8_avx2(__m256& r0, __m256& r1, __m256& r2, __m256& r3,
+                                __m256& r4, __m256& r5, __m256& r6, __m256& r7)
+{
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    const __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+    const __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+    const __m256 u0 = _mm256_shuffle_ps(t0, t2, 0x44), u1 = _mm256_shuffle_ps(t0, t2, 0xee);
+    const __m256 u2 = _mm256_shuffle_ps(t1, t3, 0x44), u3 = _mm256_shuffle_ps(t1, t3, 0xee);
+    const __m256 u4 = _mm256_shuffle_ps(t4, t6, 0x44), u5 = _mm256_shuffle_ps(t4, t6, 0xee);
+    const __m256 u6 = _mm256_shuffle_ps(t5, t7, 0x44), u7 = _mm256_shuffle_ps(t5, t7, 0xee);
+    r0 = _mm256_permute2f128_ps(u0, u4, 0x20);
+    r1 = _mm256_permute2f128_ps(u1, u5, 0x20);
+    r2 = _mm256_permute2f128_ps(u2, u6, 0x20);
+    r3 = _mm256_permute2f128_ps(u3, u7, 0x20);
+    r4 = _mm256_permute2f128_ps(u0, u4, 0x31);
+    r5 = _mm256_permute2f128_ps(u1, u5, 0x31);
+    r6 = _mm256_permute2f128_ps(u2, u6, 0x31);
+    r7 = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+// transposes the 4 x 4 blocks of 128-bit lanes of four registers
+NDARRAY_TARGET("avx512f")
+inline void _transpose_lanes_avx512(__m512& a0, __m512& a1, __m512& a2, __m512& a3)
+{
+    const __m512 v0 = _mm512_shuffle_f32x4(a0, a1, 0x44), v1 = _mm512_shuffle_f32x4(a0, a1, 0xee);
+    const __m512 v2 = _mm512_shuffle_f32x4(a2, a3, 0x44), v3 = _mm512_shuffle_f32x4(a2, a3, 0xee);
+    a0 = _mm512_shuffle_f32x4(v0, v2, 0x88);
+    a1 = _mm512_shuffle_f32x4(v0, v2, 0xdd);
+    a2 = _mm512_shuffle_f32x4(v1, v3, 0x88);
+    a3 = _mm512_shuffle_f32x4(v1, v3, 0xdd);
+}
+
+// the transpose kernels below copy dst[i * dst_stride + j] = src[i + j * src_stride]
+// for i < m and j < n, in blocks of the size in their names, where m and n
+// are multiples of the block size; strides are in elements
+
+NDARRAY_TARGET("avx2")
+inline void _transpose_copy_avx2_32(const void* src, ptrdiff_t src_stride,
+                                    void* dst, ptrdiff_t dst_stride, size_t m, size_t n)
+{
+    const float* src_ptr = static_cast<const float*>(src);
+    float*       dst_ptr = static_cast<float*>(dst);
+    for (size_t j = 0; j < n; j += 8)
+    {
+        for (size_t i = 0; i < m; i += 8)
+        {
+            const float* s = src_ptr + ptrdiff_t(i) + ptrdiff_t(j) * src_stride;
+            float*       d = dst_ptr + ptrdiff_t(i) * dst_stride + ptrdiff_t(j);
+            __m256 r0 = _mm256_loadu_ps(s);
+            __m256 r1 = _mm256_loadu_ps(s + src_stride);
+            __m256 r2 = _mm256_loadu_ps(s + 2 * src_stride);
+            __m256 r3 = _mm256_loadu_ps(s + 3 * src_stride);
+            __m256 r4 = _mm256_loadu_ps(s + 4 * src_stride);
+            __m256 r5 = _mm256_loadu_ps(s + 5 * src_stride);
+            __m256 r6 = _mm256_loadu_ps(s + 6 * src_stride);
+            __m256 r7 = _mm256_loadu_ps(s + 7 * src_stride);
+            _transpose_8x8_avx2(r0, r1, r2, r3, r4, r5, r6, r7);
+            _mm256_storeu_ps(d, r0);
+            _mm256_storeu_ps(d + dst_stride, r1);
+            _mm256_storeu_ps(d + 2 * dst_stride, r2);
+            _mm256_storeu_ps(d + 3 * dst_stride, r3);
+            _mm256_storeu_ps(d + 4 * dst_stride, r4);
+            _mm256_storeu_ps(d + 5 * dst_stride, r5);
+            _mm256_storeu_ps(d + 6 * dst_stride, r6);
+            _mm256_storeu_ps(d + 7 * dst_stride, r7);
+        }
+    }
+}
+
+NDARRAY_TARGET("avx2")
+inline void _transpose_copy_avx2_64(const void* src, ptrdiff_t src_stride,
+                                    void* dst, ptrdiff_t dst_stride, size_t m, size_t n)
+{
+    const double* src_ptr = static_cast<const double*>(src);
+    double*       dst_ptr = static_cast<double*>(dst);
+    for (size_t j = 0; j < n; j += 4)
+    {
+        for (size_t i = 0; i < m; i += 4)
+        {
+            const double* s = src_ptr + ptrdiff_t(i) + ptrdiff_t(j) * src_stride;
+            double*       d = dst_ptr + ptrdiff_t(i) * dst_stride + ptrdiff_t(j);
+            const __m256d r0 = _mm256_loadu_pd(s);
+            const __m256d r1 = _mm256_loadu_pd(s + src_stride);
+            const __m256d r2 = _mm256_loadu_pd(s + 2 * src_stride);
+            const __m256d r3 = _mm256_loadu_pd(s + 3 * src_stride);
+            const __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+            const __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+            _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+            _mm256_storeu_pd(d + dst_stride, _mm256_permute2f128_pd(t1, t3, 0x20));
+            _mm256_storeu_pd(d + 2 * dst_stride, _mm256_permute2f128_pd(t0, t2, 0x31));
+            _mm256_storeu_pd(d + 3 * dst_stride, _mm256_permute2f128_pd(t1, t3, 0x31));
+        }
+    }
+}
+
+NDARRAY_TARGET("avx512f")
+inline void _transpose_copy_avx512_32(const void* src, ptrdiff_t src_stride,
+                                      void* dst, ptrdiff_t dst_stride, size_t m, size_t n)
+{
+    const float* src_ptr = static_cast<const float*>(src);
+    float*       dst_ptr = static_cast<float*>(dst);
+    for (size_t j = 0; j < n; j += 16)
+    {
+        for (size_t i = 0; i < m; i += 16)
+        {
+            const float* s = src_ptr + ptrdiff_t(i) + ptrdiff_t(j) * src_stride;
+            float*       d = dst_ptr + ptrdiff_t(i) * dst_stride + ptrdiff_t(j);
+            __m512 r[16], t[16];
+            for (int k = 0; k < 16; ++k)
+                r[k] = _mm512_loadu_ps(s + k * src_stride);
+            // t[4 * g + q] holds element 4 * lane + q of rows 4 * g, ..., 4 * g + 3 in each lane
+            for (int k = 0; k < 16; k += 2)
+            {
+                t[k]     = _mm512_unpacklo_ps(r[k], r[k + 1]);
+                t[k + 1] = _mm512_unpackhi_ps(r[k], r[k + 1]);
+            }
+            for (int g = 0; g < 16; g += 4)
+            {
+                r[g]     = _mm512_shuffle_ps(t[g],     t[g + 2], 0x44);
+                r[g + 1] = _mm512_shuffle_ps(t[g],     t[g + 2], 0xee);
+                r[g + 2] = _mm512_shuffle_ps(t[g + 1], t[g + 3], 0x44);
+                r[g + 3] = _mm512_shuffle_ps(t[g + 1], t[g + 3], 0xee);
+            }
+            for (int q = 0; q < 4; ++q)
+            {
+                _transpose_lanes_avx512(r[q], r[q + 4], r[q + 8], r[q + 12]);
+                for (int lane = 0; lane < 4; ++lane)
+                    _mm512_storeu_ps(d + (4 * lane + q) * dst_stride, r[q + 4 * lane]);
+            }
+        }
+    }
+}
+
+NDARRAY_TARGET("avx512f")
+inline void _transpose_copy_avx512_64(const void* src, ptrdiff_t src_stride,
+                                      void* dst, ptrdiff_t dst_stride, size_t m, size_t n)
+{
+    const double* src_ptr = static_cast<const double*>(src);
+    double*       dst_ptr = static_cast<double*>(dst);
+    for (size_t j = 0; j < n; j += 8)
+    {
+        for (size_t i = 0; i < m; i += 8)
+        {
+            const double* s = src_ptr + ptrdiff_t(i) + ptrdiff_t(j) * src_stride;
+            double*       d = dst_ptr + ptrdiff_t(i) * dst_stride + ptrdiff_t(j);
+            __m512 t[8];
+            // t[2 * g + q] holds element 2 * lane + q of rows 2 * g and 2 * g + 1 in each lane
+            for (int k = 0; k < 8; k += 2)
+            {
+                const __m512d r0 = _mm512_loadu_pd(s + k * src_stride);
+                const __m512d r1 = _mm512_loadu_pd(s + (k + 1) * src_stride);
+                t[k]     = _mm512_castpd_ps(_mm512_unpacklo_pd(r0, r1));
+                t[k + 1] = _mm512_castpd_ps(_mm512_unpackhi_pd(r0, r1));
+            }
+            for (int q = 0; q < 2; ++q)
+            {
+                _transpose_lanes_avx512(t[q], t[q + 2], t[q + 4], t[q + 6]);
+                for (int lane = 0; lane < 4; ++lane)
+                    _mm512_storeu_pd(d + (2 * lane + q) * dst_stride, _mm512_castps_pd(t[q + 2 * lane]));
+            }
+        }
+    }
+}
+
+#endif // NDARRAY_X86_SIMD
+
+// dst[i * dst_stride + j] = src[i + j * src_stride] for i < m and j < n
+// rounded down to a multiple of the block size of a transpose kernel,
+// returns the block size, or 0 if no kernel applies
+template<typename T>
+inline size_t _simd_transpose_copy(const T* src, ptrdiff_t src_stride,
+                                   T* dst, ptrdiff_t dst_stride, size_t m, size_t n)
+{
+#if defined(NDARRAY_X86_SIMD)
+    const simd_level_type level = simd_level();
+    if constexpr (sizeof(T) == 4)
+    {
+        if (level == simd_level_type::avx512)
+        {
+            _transpose_copy_avx512_32(src, src_stride, dst, dst_stride, m / 16 * 16, n / 16 * 16);
+            return 16;
+        }
+        if (level == simd_level_type::avx2)
+        {
+            _transpose_copy_avx2_32(src, src_stride, dst, dst_stride, m / 8 * 8, n / 8 * 8);
+            return 8;
+        }
+    }
+    if constexpr (sizeof(T) == 8)
+    {
+        if (level == simd_level_type::avx512)
+        {
+            _transpose_copy_avx512_64(src, src_stride, dst, dst_stride, m / 8 * 8, n / 8 * 8);
+            return 8;
+        }
+        if (level == simd_level_type::avx2)
+        {
+            _transpose_copy_avx2_64(src, src_stride, dst, dst_stride, m / 4 * 4, n / 4 * 4);
+            return 4;
+        }
+    }
+#endif
+    return 0;
+}
+
+// copy an m x n block, dst[i * dst_si + j * dst_sj] = src[i * src_si + j * src_sj],
+// in square tiles, so that the cache lines touched along the strided side
+// of a tile are all reused before they are evicted; assuming no aliasing.
+// A transpose, where src_si and dst_sj are 1, goes to the SIMD kernels
+template<typename S, typename D>
+inline void _strided_tile_copy(S* src, ptrdiff_t src_si, ptrdiff_t src_sj,
+                               D* dst, ptrdiff_t dst_si, ptrdiff_t dst_sj, size_t m, size_t n)
+{
+    static_assert(!std::is_const_v<D>);
+    auto copy_block = [=](size_t i0, size_t i1, size_t j0, size_t j1)
+    {
+        for (size_t j = j0; j < j1; ++j)
+        {
+            S* s = src + ptrdiff_t(i0) * src_si + ptrdiff_t(j) * src_sj;
+            D* d = dst + ptrdiff_t(i0) * dst_si + ptrdiff_t(j) * dst_sj;
+            for (size_t i = i0; i < i1; ++i, s += src_si, d += dst_si)
+                *d = *s;
+        }
+    };
+    for (size_t i0 = 0; i0 < m; i0 += _copy_tile_v)
+    {
+        const size_t i1 = std::min(i0 + _copy_tile_v, m);
+        for (size_t j0 = 0; j0 < n; j0 += _copy_tile_v)
+        {
+            const size_t j1 = std::min(j0 + _copy_tile_v, n);
+            size_t i_done = i0, j_done = j0;
+            if constexpr (_is_bitwise_copyable_v<S, D> && (sizeof(D) == 4 || sizeof(D) == 8))
+            {
+                if (src_si == 1 && dst_sj == 1)
+                {
+                    const size_t block = _simd_transpose_copy<D>(
+                        src + ptrdiff_t(i0) + ptrdiff_t(j0) * src_sj, src_sj,
+                        dst + ptrdiff_t(i0) * dst_si + ptrdiff_t(j0), dst_si, i1 - i0, j1 - j0);
+                    if (block > 0)
+                    {
+                        i_done = i0 + (i1 - i0) / block * block;
+                        j_done = j0 + (j1 - j0) / block * block;
+                        copy_block(i0, i_done, j_done, j1);
+                    }
+                }
+            }
+            copy_block(i_done, i1, j0, j1);
+        }
+    }
+}
+
+// the level with the smallest absolute stride among levels of more than one
+// element, or the last level if there is none
+template<size_t Depth>
+inline size_t _innermost_level(const std::array<ptrdiff_t, Depth>& strides,
+                               const std::array<size_t, Depth>& dims)
+{
+    size_t inner = Depth - 1;
+    ptrdiff_t inner_stride = -1;
+    for (size_t level = Depth; level-- > 0;)
+    {
+        const ptrdiff_t stride = strides[level] < 0 ? -strides[level] : strides[level];
+        if (dims[level] > 1 && (inner_stride < 0 || stride < inner_stride))
+        {
+            inner        = level;
+            inner_stride = stride;
+        }
+    }
+    return inner;
+}
+
+// copy the elements of dims between two pointers with a stride per level,
+// assuming no aliasing; rows along the innermost level of the destination
+// go to _strided_copy(), unless the source is contiguous along another
+// level, in which case the two levels are copied by _strided_tile_copy()
+template<typename S, typename D, size_t Depth>
+inline void _strided_nd_copy(S* src, const std::array<ptrdiff_t, Depth>& src_strides,
+                             D* dst, const std::array<ptrdiff_t, Depth>& dst_strides,
+                             const std::array<size_t, Depth>& dims)
+{
+    for (size_t level = 0; level < Depth; ++level)
+        if (dims[level] == 0)
+            return;
+
+    const size_t dst_inner = _innermost_level(dst_strides, dims);
+    const size_t src_inner = _innermost_level(src_strides, dims);
+
+    // the remaining levels, visited like an odometer
+    std::array<size_t, Depth>    outer_dims{};
+    std::array<ptrdiff_t, Depth> outer_src{}, outer_dst{};
+    size_t n_outer = 0;
+    for (size_t level = 0; level < Depth; ++level)
+    {
+        if (level == dst_inner || level == src_inner)
+            continue;
+        outer_dims[n_outer] = dims[level];
+        outer_src[n_outer]  = src_strides[level];
+        outer_dst[n_outer]  = dst_strides[level];
+        ++n_outer;
+    }
+
+    std::array<size_t, Depth> index{};
+    for (;;)
+    {
+        if (dst_inner == src_inner)
+            _strided_copy(src, src_strides[dst_inner], dst, dst_strides[dst_inner], dims[dst_inner]);
+        else
+            _strided_tile_copy(src, src_strides[src_inner], src_strides[dst_inner],
+                               dst, dst_strides[src_inner], dst_strides[dst_inner],
+                               dims[src_inner], dims[dst_inner]);
+
+        size_t level = n_outer;
+        for (; level > 0; --level)
+        {
+            const size_t l = level - 1;
+            src += outer_src[l];
+            dst += outer_dst[l];
+            if (++index[l] < outer_dims[l])
+                break;
+            src -= ptrdiff_t(outer_dims[l]) * outer_src[l];
+            dst -= ptrdiff_t(outer_dims[l]) * outer_dst[l];
+            index[l] = 0;
+        }
+        if (level == 0)
+            return;
+    }
+}
+
+}
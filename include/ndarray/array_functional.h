@@ -1,12 +1,907 @@
-#pragma once
-
-#include "array.h"
-#include "array_interface.h"
-
-namespace ndarray
-{
-
-
-
-
-}
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+
+#include "array.h"
+#include "array_interface.h"
+
+namespace ndarray
+{
+
+//
+// array_expr is a lazy elementwise expression over array objects.
+//
+// Arithmetic operators, comparisons and math functions applied to array
+// objects only build an array_expr, which stores the operation and its
+// operands: l-value operands are stored by reference, and r-value operands
+// are moved into the expression. The expression is evaluated when it is
+// assigned to an array or a view, or converted by make_array(), in a single
+// loop without intermediate arrays.
+//
+//  operand                              evaluated with
+//---------------------------------------------------------------------
+//  scalar                               the value itself
+//  array, simple_view                   pointer indexing
+//  regular_view                         strided pointer indexing
+//  strided_view                         strided pointer indexing by rows
+//  range_view                           iterator indexing
+//  irregular_view, repeated_view, ...   element iterators
+//  array_expr                           its operands, recursively
+//
+// If every operand can be indexed, the loop is written as dst[i] = fn(...)
+// over i, which compilers can vectorize; otherwise the element iterators
+// of all operands are advanced together.
+//
+// Operands with fewer levels than the expression are repeated over the
+// leading levels, e.g. a [N] array added to a [M, N] array is added to each
+// of its M rows. Unlike NumPy, levels of size 1 are not stretched: every
+// level of an operand must match the corresponding last level of the
+// expression, so [M, 1] + [M, N] is an error, and is written as
+// vbroadcast(a, M, N) + b instead, which gives a strided_view with a zero
+// stride on the levels of size 1. Operands whose dimensions do not match
+// make the expression throw std::invalid_argument when it is created.
+//
+// Expressions with broadcast operands are evaluated row by row over the
+// last level: each operand is positioned once per row, so the inner loop
+// reads a broadcast operand from the start of its row (or reads a
+// zero-stride level as a single element) instead of computing positions.
+//
+
+enum class _expr_operand_kind
+{
+    scalar,
+    pointer,
+    strided,
+    levels,
+    indexed_iter,
+    iterated,
+    expr
+};
+
+template<typename Operand>
+constexpr _expr_operand_kind _get_expr_operand_kind()
+{
+    using _type = array_obj_type;
+    if constexpr (!is_array_object_v<Operand>)
+    {
+        return _expr_operand_kind::scalar;
+    }
+    else
+    {
+        constexpr _type type_v = array_obj_type_of_v<Operand>;
+        if constexpr (type_v == _type::array || type_v == _type::simple)
+            return _expr_operand_kind::pointer;
+        else if constexpr (type_v == _type::regular)
+            return _expr_operand_kind::strided;
+        else if constexpr (type_v == _type::strided)
+            return _expr_operand_kind::levels;
+        else if constexpr (type_v == _type::range)
+            return _expr_operand_kind::indexed_iter;
+        else if constexpr (type_v == _type::expr)
+            return _expr_operand_kind::expr;
+        else
+            return _expr_operand_kind::iterated;
+    }
+}
+template<typename Operand>
+constexpr _expr_operand_kind _expr_operand_kind_v = _get_expr_operand_kind<remove_cvref_t<Operand>>();
+
+// whether the elements of an operand can be accessed by their position
+template<typename Operand>
+constexpr bool _is_expr_operand_indexed()
+{
+    if constexpr (_expr_operand_kind_v<Operand> == _expr_operand_kind::expr)
+        return remove_cvref_t<Operand>::_is_indexed_v;
+    else
+        return _expr_operand_kind_v<Operand> != _expr_operand_kind::iterated;
+}
+template<typename Operand>
+constexpr bool _is_expr_operand_indexed_v = _is_expr_operand_indexed<Operand>();
+
+// depth of an operand, or 0 if it is a scalar
+template<typename Operand, bool IsArray = is_array_object_v<Operand>>
+struct _expr_operand_depth
+{
+    static constexpr size_t value = 0;
+};
+template<typename Operand>
+struct _expr_operand_depth<Operand, true>
+{
+    static constexpr size_t value = array_depth_of_v<Operand>;
+};
+template<typename Operand>
+constexpr size_t _expr_operand_depth_v = _expr_operand_depth<Operand>::value;
+
+// operands that can appear in an expression
+template<typename Operand>
+constexpr bool _is_expr_operand_v =
+    is_array_object_v<Operand> || std::is_arithmetic_v<remove_cvref_t<Operand>>;
+
+// arguments of an expression: valid operands with at least one array object
+template<typename... Operands>
+constexpr bool _is_expr_args_v =
+    (_is_expr_operand_v<Operands> && ...) && (is_array_object_v<Operands> || ...);
+template<typename... Operands>
+using _enable_if_expr_args_t = std::enable_if_t<_is_expr_args_v<Operands...>, int>;
+
+// whether an operand is broadcast over the leading levels of an expression of Depth
+template<typename Operand, size_t Depth>
+constexpr bool _is_expr_broadcast_v =
+    _expr_operand_depth_v<Operand> > 0 && _expr_operand_depth_v<Operand> < Depth;
+
+// whether an operand is evaluated row by row, see array_expr::_copy_rows()
+template<typename Operand>
+constexpr bool _is_expr_operand_rowwise()
+{
+    if constexpr (_expr_operand_kind_v<Operand> == _expr_operand_kind::expr)
+        return remove_cvref_t<Operand>::_is_rowwise_v;
+    else
+        return _expr_operand_kind_v<Operand> == _expr_operand_kind::levels;
+}
+template<typename Operand>
+constexpr bool _is_expr_operand_rowwise_v = _is_expr_operand_rowwise<Operand>();
+
+// how an operand is stored in an expression
+template<typename Operand>
+using _expr_operand_t = std::conditional_t<
+    std::is_lvalue_reference_v<Operand> && is_array_object_v<Operand>,
+    const remove_cvref_t<Operand>&, remove_cvref_t<Operand>>;
+
+
+// accessors give the i-th element of an operand, and _row(first) gives an
+// accessor of the elements from first on, within a row of the last level
+template<typename T>
+struct _scalar_accessor
+{
+    T value_;
+    T operator()(size_t) const
+    {
+        return value_;
+    }
+    _scalar_accessor _row(size_t) const
+    {
+        return *this;
+    }
+};
+template<typename T>
+struct _pointer_accessor
+{
+    T* ptr_;
+    T& operator()(size_t i) const
+    {
+        return ptr_[i];
+    }
+    _pointer_accessor _row(size_t first) const
+    {
+        return {ptr_ + first};
+    }
+};
+template<typename T>
+struct _strided_accessor
+{
+    T*        ptr_;
+    ptrdiff_t stride_;
+    T& operator()(size_t i) const
+    {
+        return ptr_[ptrdiff_t(i) * stride_];
+    }
+    _strided_accessor _row(size_t first) const
+    {
+        return {ptr_ + ptrdiff_t(first) * stride_, stride_};
+    }
+};
+template<typename Iter>
+struct _iter_accessor
+{
+    Iter iter_;
+    auto operator()(size_t i) const
+    {
+        return iter_[ptrdiff_t(i)];
+    }
+    _iter_accessor _row(size_t first) const
+    {
+        return {iter_ + ptrdiff_t(first)};
+    }
+};
+template<typename Function, typename... Accessors>
+struct _expr_accessor
+{
+    Function                 fn_;
+    std::tuple<Accessors...> accessors_;
+    auto operator()(size_t i) const
+    {
+        return std::apply([this, i](const auto&... acc) { return fn_(acc(i)...); }, accessors_);
+    }
+    auto _row(size_t first) const
+    {
+        return std::apply([this, first](const auto&... acc) {
+            return _expr_accessor<Function, decltype(acc._row(first))...>{
+                fn_, {acc._row(first)...}}; }, accessors_);
+    }
+};
+
+// a strided_view, whose position is found level by level; a row is a
+// pointer with the stride of the last level, which is zero if it is
+// broadcast, and then its element is read once per row
+template<typename T, size_t Depth>
+struct _levels_accessor
+{
+    T*                            ptr_;
+    std::array<size_t, Depth>     dims_;
+    std::array<ptrdiff_t, Depth>  strides_;
+    ptrdiff_t _offset(size_t i) const
+    {
+        ptrdiff_t offset = 0;
+        for (size_t level = Depth; level-- > 0;)
+        {
+            offset += ptrdiff_t(i % dims_[level]) * strides_[level];
+            i /= dims_[level];
+        }
+        return offset;
+    }
+    T& operator()(size_t i) const
+    {
+        return ptr_[_offset(i)];
+    }
+    _strided_accessor<T> _row(size_t first) const
+    {
+        return {ptr_ + _offset(first), strides_[Depth - 1]};
+    }
+};
+
+// an operand broadcast over the leading levels, which repeats every period
+// elements; a row never wraps around, since period is a multiple of the
+// dimension of the last level
+template<typename Accessor>
+struct _broadcast_accessor
+{
+    Accessor acc_;
+    size_t   period_;
+    auto operator()(size_t i) const
+    {
+        return acc_(i % period_);
+    }
+    auto _row(size_t first) const
+    {
+        return acc_._row(first % period_);
+    }
+};
+
+template<typename Operand>
+inline auto _make_expr_accessor(const Operand& operand)
+{
+    constexpr _expr_operand_kind kind_v = _expr_operand_kind_v<Operand>;
+    if constexpr (kind_v == _expr_operand_kind::scalar)
+        return _scalar_accessor<Operand>{operand};
+    else if constexpr (kind_v == _expr_operand_kind::pointer)
+        return _pointer_accessor<std::remove_pointer_t<decltype(_fixed_stride_ptr(operand))>>{
+            _fixed_stride_ptr(operand)};
+    else if constexpr (kind_v == _expr_operand_kind::strided)
+        return _strided_accessor<std::remove_pointer_t<decltype(_fixed_stride_ptr(operand))>>{
+            _fixed_stride_ptr(operand), _fixed_stride(operand)};
+    else if constexpr (kind_v == _expr_operand_kind::levels)
+        return _levels_accessor<typename Operand::_elem_t, Operand::_depth_v>{
+            operand.data(), operand.dimensions(), operand.strides()};
+    else if constexpr (kind_v == _expr_operand_kind::indexed_iter)
+        return _iter_accessor<decltype(operand.element_cbegin())>{operand.element_cbegin()};
+    else if constexpr (kind_v == _expr_operand_kind::expr)
+        return operand._make_accessor();
+    else
+        static_assert(_always_false_v<Operand>, "operand cannot be indexed");
+}
+
+
+// cursors give elements of an operand in order with operator* and operator++
+template<typename T>
+struct _scalar_cursor
+{
+    T value_;
+    T operator*() const
+    {
+        return value_;
+    }
+    _scalar_cursor& operator++()
+    {
+        return *this;
+    }
+};
+template<typename Function, typename... Cursors>
+struct _expr_cursor
+{
+    Function               fn_;
+    std::tuple<Cursors...> cursors_;
+    auto operator*() const
+    {
+        return std::apply([this](const auto&... cur) { return fn_(*cur...); }, cursors_);
+    }
+    _expr_cursor& operator++()
+    {
+        std::apply([](auto&... cur) { (++cur, ...); }, cursors_);
+        return *this;
+    }
+};
+
+// an operand broadcast over the leading levels, which restarts from its
+// first element every period elements; element iterators of views are not
+// assignable, so the current one is re-created from a copy of the first
+template<typename Cursor>
+struct _broadcast_cursor
+{
+    Cursor                begin_;
+    std::optional<Cursor> cur_;
+    size_t                period_;
+    size_t                left_;
+    decltype(auto) operator*() const
+    {
+        return **cur_;
+    }
+    _broadcast_cursor& operator++()
+    {
+        if (--left_ == 0)
+        {
+            cur_.emplace(begin_);
+            left_ = period_;
+        }
+        else
+        {
+            ++*cur_;
+        }
+        return *this;
+    }
+};
+
+template<typename Operand>
+inline auto _make_expr_cursor(const Operand& operand)
+{
+    if constexpr (_expr_operand_kind_v<Operand> == _expr_operand_kind::scalar)
+        return _scalar_cursor<Operand>{operand};
+    else
+        return operand.element_cbegin();
+}
+
+// accessor or cursor of an operand in an expression of Depth
+template<size_t Depth, typename Operand>
+inline auto _make_expr_operand_accessor(const Operand& operand)
+{
+    if constexpr (_is_expr_broadcast_v<Operand, Depth>)
+        return _broadcast_accessor<decltype(_make_expr_accessor(operand))>{
+            _make_expr_accessor(operand), operand.size()};
+    else
+        return _make_expr_accessor(operand);
+}
+template<size_t Depth, typename Operand>
+inline auto _make_expr_operand_cursor(const Operand& operand)
+{
+    if constexpr (_is_expr_broadcast_v<Operand, Depth>)
+        return _broadcast_cursor<decltype(_make_expr_cursor(operand))>{
+            _make_expr_cursor(operand), _make_expr_cursor(operand), operand.size(), operand.size()};
+    else
+        return _make_expr_cursor(operand);
+}
+
+
+template<typename Operand, typename DstArray>
+inline bool _expr_operand_aliased(const Operand& operand, const DstArray& dst);
+template<typename Operand, typename DstArray>
+inline bool _expr_operand_shared(const Operand& operand, const DstArray& dst);
+
+template<typename Function, typename... Operands>
+class array_expr
+{
+public:
+    using _my_type     = array_expr;
+    using _function_t  = Function;
+    using _operands_t  = std::tuple<Operands...>;
+    using _elem_t      = remove_cvref_t<std::invoke_result_t<const Function&, array_elem_of_t<Operands>...>>;
+    static constexpr size_t _depth_v      = std::max({_expr_operand_depth_v<Operands>...});
+    static constexpr bool   _is_const_v   = true;
+    static constexpr bool   _is_indexed_v = (_is_expr_operand_indexed_v<Operands> && ...);
+    static constexpr bool   _is_rowwise_v =
+        ((_is_expr_broadcast_v<Operands, _depth_v> || _is_expr_operand_rowwise_v<Operands>) || ...);
+    using _dims_t      = std::array<size_t, _depth_v>;
+    static_assert(_depth_v > 0);
+
+protected:
+    Function    fn_;
+    _operands_t operands_;
+    _dims_t     dims_{};
+
+public:
+    template<typename... Args>
+    explicit array_expr(Function fn, Args&&... args) :
+        fn_{std::move(fn)}, operands_{std::forward<Args>(args)...}
+    {
+        _init_dims();
+    }
+
+    // dimension of the expression on the i-th level
+    template<size_t I>
+    size_t dimension() const
+    {
+        static_assert(I < _depth_v);
+        return dims_[I];
+    }
+
+    // array of dimensions
+    _dims_t dimensions() const
+    {
+        return dims_;
+    }
+
+    // total size of the expression
+    size_t size() const
+    {
+        return std::accumulate(dims_.begin(), dims_.end(), size_t(1), std::multiplies<>{});
+    }
+
+    // an expression does not own elements, and is never aliased by identity
+    const size_t* _identifier_ptr() const
+    {
+        return nullptr;
+    }
+
+    // whether evaluating the expression into dst may read an element of dst
+    // after it has been overwritten; a broadcast operand is read at other
+    // positions than those being written, so it must not share any element
+    template<typename DstArray>
+    bool _is_aliased_with(const DstArray& dst) const
+    {
+        return std::apply([&dst](const auto&... operands) {
+            return (_is_operand_aliased_with(operands, dst) || ...); }, operands_);
+    }
+
+    // whether any operand reads an element of dst
+    template<typename DstArray>
+    bool _shares_elements_with(const DstArray& dst) const
+    {
+        return std::apply([&dst](const auto&... operands) {
+            return (_expr_operand_shared(operands, dst) || ...); }, operands_);
+    }
+
+    auto _make_accessor() const
+    {
+        return std::apply([this](const auto&... operands) {
+            return _expr_accessor<Function, decltype(_make_expr_operand_accessor<_depth_v>(operands))...>{
+                fn_, {_make_expr_operand_accessor<_depth_v>(operands)...}}; }, operands_);
+    }
+
+    auto element_cbegin() const
+    {
+        return std::apply([this](const auto&... operands) {
+            return _expr_cursor<Function, decltype(_make_expr_operand_cursor<_depth_v>(operands))...>{
+                fn_, {_make_expr_operand_cursor<_depth_v>(operands)...}}; }, operands_);
+    }
+
+    // number of rows of the last level
+    size_t _row_count() const
+    {
+        const size_t row_size = dims_[_depth_v - 1];
+        return row_size == 0 ? 0 : this->size() / row_size;
+    }
+
+    // evaluate rows [first, last) of the last level into ptr[i * stride],
+    // positioning every operand once per row
+    template<typename T>
+    void _copy_rows(T* ptr, ptrdiff_t stride, size_t first, size_t last) const
+    {
+        const size_t row_size = dims_[_depth_v - 1];
+        const auto   acc      = this->_make_accessor();
+        for (size_t row = first; row < last; ++row)
+        {
+            const auto row_acc = acc._row(row * row_size);
+            T* const   row_ptr = ptr + ptrdiff_t(row * row_size) * stride;
+            if (stride == 1)
+            {
+                for (size_t j = 0; j < row_size; ++j)
+                    row_ptr[j] = row_acc(j);
+            }
+            else
+            {
+                for (size_t j = 0; j < row_size; ++j)
+                    row_ptr[ptrdiff_t(j) * stride] = row_acc(j);
+            }
+        }
+    }
+    auto element_begin() const
+    {
+        return this->element_cbegin();
+    }
+
+    // evaluate the expression into destination, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst, size_t size) const
+    {
+        using traits_t = _strided_iter_traits<Iter>;
+        if constexpr (_is_indexed_v && traits_t::value)
+        {
+            auto* const     ptr    = traits_t::ptr(dst);
+            const ptrdiff_t stride = traits_t::stride(dst);
+            NDARRAY_ASSERT(size <= this->size());
+            size_t first = 0;
+            if constexpr (_is_rowwise_v)
+            {
+                // whole rows of the first size elements, then the rest of a
+                // partial row through the accessor
+                const size_t row_size = dims_[_depth_v - 1];
+                const size_t n_rows   = row_size == 0 ? 0 : size / row_size;
+                this->_copy_rows(ptr, stride, 0, n_rows);
+                first = n_rows * row_size;
+            }
+            const auto      acc    = this->_make_accessor();
+            if (stride == 1)
+            {
+                for (size_t i = first; i < size; ++i)
+                    ptr[i] = acc(i);
+            }
+            else
+            {
+                for (size_t i = first; i < size; ++i)
+                    ptr[ptrdiff_t(i) * stride] = acc(i);
+            }
+        }
+        else
+        {
+            auto src = this->element_cbegin();
+            for (size_t i = 0; i < size; ++i, ++src, ++dst)
+                *dst = *src;
+        }
+    }
+
+    // evaluate the expression into destination, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst) const
+    {
+        this->copy_to(dst, this->size());
+    }
+
+private:
+    template<typename Operand, typename DstArray>
+    static bool _is_operand_aliased_with(const Operand& operand, const DstArray& dst)
+    {
+        if constexpr (_is_expr_broadcast_v<Operand, _depth_v>)
+            return _expr_operand_shared(operand, dst);
+        else
+            return _expr_operand_aliased(operand, dst);
+    }
+
+    // dimensions of the operands with all levels, and then the broadcast
+    // operands, which must match the last dimensions; levels of size 1 are
+    // not stretched, see vbroadcast()
+    template<size_t I = 0>
+    void _init_dims(bool found = false)
+    {
+        if constexpr (I < sizeof...(Operands))
+        {
+            using operand_t = std::tuple_element_t<I, _operands_t>;
+            if constexpr (_expr_operand_depth_v<operand_t> == _depth_v)
+            {
+                const auto dims = std::get<I>(operands_).dimensions();
+                if (!found)
+                    std::copy(dims.begin(), dims.end(), dims_.begin());
+                else if (!std::equal(dims.begin(), dims.end(), dims_.begin()))
+                    throw std::invalid_argument("array_expr: operands have different dimensions");
+                _init_dims<I + 1>(true);
+            }
+            else
+            {
+                _init_dims<I + 1>(found);
+            }
+        }
+        else
+        {
+            _check_broadcast_dims();
+        }
+    }
+
+    template<size_t I = 0>
+    void _check_broadcast_dims() const
+    {
+        if constexpr (I < sizeof...(Operands))
+        {
+            if constexpr (_is_expr_broadcast_v<std::tuple_element_t<I, _operands_t>, _depth_v>)
+            {
+                const auto dims = std::get<I>(operands_).dimensions();
+                if (!std::equal(dims.begin(), dims.end(), dims_.end() - dims.size()))
+                    throw std::invalid_argument("array_expr: a broadcast operand must match the last dimensions");
+            }
+            _check_broadcast_dims<I + 1>();
+        }
+    }
+};
+
+// whether an operand may be read at a position of dst other than the one
+// being written, see array_expr::_is_aliased_with()
+template<typename Operand, typename DstArray>
+inline bool _expr_operand_aliased(const Operand& operand, const DstArray& dst)
+{
+    using _type = array_obj_type;
+    if constexpr (!is_array_object_v<Operand>)
+    {
+        return false;
+    }
+    else
+    {
+        constexpr _type src_type_v = array_obj_type_of_v<Operand>;
+        constexpr _type dst_type_v = array_obj_type_of_v<DstArray>;
+        if constexpr (src_type_v == _type::expr)
+        {
+            return operand._is_aliased_with(dst);
+        }
+        else if constexpr (src_type_v == _type::array  ||
+                           src_type_v == _type::simple ||
+                           src_type_v == _type::regular)
+        {
+            if (operand._identifier_ptr() != dst._identifier_ptr() &&
+                !_may_share_elements(operand, dst, dst.size()))
+                return false;
+            if constexpr (dst_type_v == _type::irregular || dst_type_v == _type::strided)
+            { // unable to distinguish
+                return true;
+            }
+            else if constexpr (!std::is_same_v<std::remove_const_t<array_elem_of_t<Operand>>,
+                                             std::remove_const_t<array_elem_of_t<DstArray>>>)
+            { // a shared base array always has one element type
+                return false;
+            }
+            else
+            {
+                const auto      src_ptr    = _fixed_stride_ptr(operand);
+                const auto      dst_ptr    = _fixed_stride_ptr(dst);
+                const ptrdiff_t src_stride = _fixed_stride(operand);
+                const ptrdiff_t dst_stride = _fixed_stride(dst);
+                if (src_ptr == dst_ptr && src_stride == dst_stride)
+                    return false; // every element is read where it is written
+                return _strided_ranges_overlap(src_ptr, src_stride, dst_ptr, dst_stride, dst.size());
+            }
+        }
+        else if constexpr (src_type_v == _type::irregular || src_type_v == _type::strided)
+        {
+            return operand._identifier_ptr() == dst._identifier_ptr() ||
+                _may_share_elements(operand, dst, dst.size());
+        }
+        else // range and repeated views own their elements
+        {
+            return false;
+        }
+    }
+}
+
+// whether any element of operand is an element of dst, for the operands whose
+// positions do not follow those of dst, see array_expr::_is_aliased_with()
+template<typename Operand, typename DstArray>
+inline bool _expr_operand_shared(const Operand& operand, const DstArray& dst)
+{
+    using _type = array_obj_type;
+    if constexpr (!is_array_object_v<Operand>)
+    {
+        return false;
+    }
+    else
+    {
+        constexpr _type src_type_v = array_obj_type_of_v<Operand>;
+        if constexpr (src_type_v == _type::expr)
+        {
+            return operand._shares_elements_with(dst);
+        }
+        else if constexpr (src_type_v == _type::array     ||
+                           src_type_v == _type::simple    ||
+                           src_type_v == _type::regular   ||
+                           src_type_v == _type::irregular ||
+                           src_type_v == _type::strided)
+        {
+            if (operand._identifier_ptr() == dst._identifier_ptr())
+                return true;
+            if constexpr (!std::is_same_v<std::remove_const_t<array_elem_of_t<Operand>>,
+                                          std::remove_const_t<array_elem_of_t<DstArray>>>)
+            { // a shared base array always has one element type
+                return false;
+            }
+            else
+            {
+                const size_t src_size = operand.size();
+                const size_t dst_size = dst.size();
+                if (src_size == 0 || dst_size == 0)
+                    return false;
+                const auto src_bounds = _element_address_bounds(operand, src_size);
+                const auto dst_bounds = _element_address_bounds(dst, dst_size);
+                return !(src_bounds.second < dst_bounds.first || dst_bounds.second < src_bounds.first);
+            }
+        }
+        else // range and repeated views own their elements
+        {
+            return false;
+        }
+    }
+}
+
+template<typename Function, typename... Operands>
+inline auto _make_expr(Function fn, Operands&&... operands)
+{
+    return array_expr<Function, _expr_operand_t<Operands>...>{
+        std::move(fn), std::forward<Operands>(operands)...};
+}
+
+// create array from array_expr
+template<typename Function, typename... Operands>
+inline auto make_array(const array_expr<Function, Operands...>& expr)
+{
+    using expr_t = array_expr<Function, Operands...>;
+    array<typename expr_t::_elem_t, expr_t::_depth_v> ret(default_init, expr.dimensions());
+    expr.copy_to(ret.data(), ret.size());
+    return ret;
+}
+
+// lazily apply fn elementwise to operands
+template<typename Function, typename... Operands, _enable_if_expr_args_t<Operands...> = 0>
+inline auto vmap(Function fn, Operands&&... operands)
+{
+    return _make_expr(std::move(fn), std::forward<Operands>(operands)...);
+}
+
+// apply fn elementwise to operands
+template<typename Function, typename... Operands, _enable_if_expr_args_t<Operands...> = 0>
+inline auto map(Function fn, Operands&&... operands)
+{
+    return make_array(vmap(std::move(fn), std::forward<Operands>(operands)...));
+}
+
+
+#define NDARRAY_DEFINE_UNARY_EXPR_OPERATOR(op, fn_type)                          \
+template<typename Operand, _enable_if_expr_args_t<Operand> = 0>                  \
+inline auto operator op(Operand&& operand)                                       \
+{                                                                                \
+    return _make_expr(fn_type{}, std::forward<Operand>(operand));                \
+}
+
+#define NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(op, fn_type)                         \
+template<typename Left, typename Right, _enable_if_expr_args_t<Left, Right> = 0> \
+inline auto operator op(Left&& left, Right&& right)                              \
+{                                                                                \
+    return _make_expr(fn_type{}, std::forward<Left>(left),                       \
+                      std::forward<Right>(right));                               \
+}
+
+NDARRAY_DEFINE_UNARY_EXPR_OPERATOR(-, std::negate<>)
+NDARRAY_DEFINE_UNARY_EXPR_OPERATOR(!, std::logical_not<>)
+NDARRAY_DEFINE_UNARY_EXPR_OPERATOR(~, std::bit_not<>)
+
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(+,  std::plus<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(-,  std::minus<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(*,  std::multiplies<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(/,  std::divides<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(%,  std::modulus<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(&,  std::bit_and<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(|,  std::bit_or<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(^,  std::bit_xor<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(&&, std::logical_and<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(||, std::logical_or<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(==, std::equal_to<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(!=, std::not_equal_to<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(<,  std::less<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(<=, std::less_equal<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(>,  std::greater<>)
+NDARRAY_DEFINE_BINARY_EXPR_OPERATOR(>=, std::greater_equal<>)
+
+#undef NDARRAY_DEFINE_UNARY_EXPR_OPERATOR
+#undef NDARRAY_DEFINE_BINARY_EXPR_OPERATOR
+
+
+#define NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(name)                                 \
+struct _##name##_fn                                                              \
+{                                                                                \
+    template<typename T>                                                         \
+    auto operator()(const T& x) const                                            \
+    {                                                                            \
+        return std::name(x);                                                     \
+    }                                                                            \
+};                                                                               \
+template<typename Operand, _enable_if_expr_args_t<Operand> = 0>                  \
+inline auto name(Operand&& operand)                                              \
+{                                                                                \
+    return _make_expr(_##name##_fn{}, std::forward<Operand>(operand));           \
+}
+
+#define NDARRAY_DEFINE_BINARY_EXPR_FUNCTION(name)                                \
+struct _##name##_fn                                                              \
+{                                                                                \
+    template<typename T, typename U>                                             \
+    auto operator()(const T& x, const U& y) const                                \
+    {                                                                            \
+        return std::name(x, y);                                                  \
+    }                                                                            \
+};                                                                               \
+template<typename Left, typename Right, _enable_if_expr_args_t<Left, Right> = 0> \
+inline auto name(Left&& left, Right&& right)                                     \
+{                                                                                \
+    return _make_expr(_##name##_fn{}, std::forward<Left>(left),                  \
+                      std::forward<Right>(right));                               \
+}
+
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(abs)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(sqrt)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(cbrt)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(exp)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(exp2)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(expm1)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(log)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(log2)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(log10)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(log1p)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(sin)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(cos)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(tan)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(asin)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(acos)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(atan)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(sinh)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(cosh)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(tanh)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(floor)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(ceil)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(round)
+NDARRAY_DEFINE_UNARY_EXPR_FUNCTION(trunc)
+
+NDARRAY_DEFINE_BINARY_EXPR_FUNCTION(pow)
+NDARRAY_DEFINE_BINARY_EXPR_FUNCTION(atan2)
+NDARRAY_DEFINE_BINARY_EXPR_FUNCTION(hypot)
+NDARRAY_DEFINE_BINARY_EXPR_FUNCTION(fmod)
+
+#undef NDARRAY_DEFINE_UNARY_EXPR_FUNCTION
+#undef NDARRAY_DEFINE_BINARY_EXPR_FUNCTION
+
+
+struct _minimum_fn
+{
+    template<typename T, typename U>
+    auto operator()(const T& x, const U& y) const
+    {
+        return y < x ? y : x;
+    }
+};
+struct _maximum_fn
+{
+    template<typename T, typename U>
+    auto operator()(const T& x, const U& y) const
+    {
+        return x < y ? y : x;
+    }
+};
+struct _where_fn
+{
+    template<typename C, typename T, typename U>
+    auto operator()(const C& cond, const T& x, const U& y) const
+    {
+        return cond ? x : y;
+    }
+};
+
+// elementwise minimum of two operands
+template<typename Left, typename Right, _enable_if_expr_args_t<Left, Right> = 0>
+inline auto minimum(Left&& left, Right&& right)
+{
+    return _make_expr(_minimum_fn{}, std::forward<Left>(left), std::forward<Right>(right));
+}
+
+// elementwise maximum of two operands
+template<typename Left, typename Right, _enable_if_expr_args_t<Left, Right> = 0>
+inline auto maximum(Left&& left, Right&& right)
+{
+    return _make_expr(_maximum_fn{}, std::forward<Left>(left), std::forward<Right>(right));
+}
+
+// elementwise selection of x where cond is true, and y otherwise
+template<typename Cond, typename Left, typename Right, _enable_if_expr_args_t<Cond, Left, Right> = 0>
+inline auto where(Cond&& cond, Left&& x, Right&& y)
+{
+    return _make_expr(_where_fn{}, std::forward<Cond>(cond),
+                      std::forward<Left>(x), std::forward<Right>(y));
+}
+
+}
@@ -1,259 +1,689 @@
-#pragma once
-
-#include "traits.h"
-#include "array.h"
-#include "array_view.h"
-#include "range_view.h"
-
-namespace ndarray
-{
-
-template<typename T, size_t Depth>
-inline auto get_vector(const array<T, Depth>& src)
-{
-    return src._get_vector();
-}
-template<typename T, size_t Depth>
-inline auto get_vector(array<T, Depth>&& src)
-{
-    return std::move(src._get_vector());
-}
-template<typename T>
-inline auto get_vector(const std::vector<T>& vec)
-{
-    return vec;
-}
-template<typename T>
-inline auto get_vector(std::vector<T>&& vec)
-{
-    return std::move(vec);
-}
-
-template<typename View>
-inline auto begin(View& view)
-{
-    return view.begin();
-}
-template<typename View>
-inline auto end(View& view)
-{
-    return view.end();
-}
-template<typename View>
-inline auto cbegin(View& view)
-{
-    return view.cbegin();
-}
-template<typename View>
-inline auto cend(View& view)
-{
-    return view.cend();
-}
-
-template<size_t Level, typename View>
-inline auto begin(View& view)
-{
-    return view.begin<Level>();
-}
-template<size_t Level, typename View>
-inline auto end(View& view)
-{
-    return view.end<Level>();
-}
-template<size_t Level, typename View>
-inline auto cbegin(View& view)
-{
-    return view.cbegin<Level>();
-}
-template<size_t Level, typename View>
-inline auto cend(View& view)
-{
-    return view.cend<Level>();
-}
-
-template<typename View>
-inline auto element_begin(View& view)
-{
-    return view.element_begin();
-}
-template<typename View>
-inline auto element_end(View& view)
-{
-    return view.element_end();
-}
-template<typename View>
-inline auto element_cbegin(View& view)
-{
-    return view.element_cbegin();
-}
-template<typename View>
-inline auto element_cend(View& view)
-{
-    return view.element_cend();
-}
-template<typename T>
-inline auto element_begin(std::vector<int>& vec)
-{
-    return vec.begin();
-}
-template<typename T>
-inline auto element_begin(const std::vector<int>& vec)
-{
-    return vec.begin();
-}
-template<typename T>
-inline auto element_cbegin(std::vector<int>& vec)
-{
-    return vec.cbegin();
-}
-template<typename T>
-inline auto element_cbegin(const std::vector<int>& vec)
-{
-    return vec.begin();
-}
-
-template<typename View>
-inline auto dimensions(const View& view)
-{
-    return view.dimensions();
-}
-template<typename T>
-inline auto dimensions(const std::vector<T>& vec)
-{
-    return std::array<size_t, 1>{vec.size()};
-}
-
-// handles data copy between array and array view
-template<typename SrcArray, typename DstArray>
-inline void data_copy(const SrcArray& src, DstArray& dst)
-{
-    using _type = array_obj_type;
-    using src_t = remove_cvref_t<SrcArray>;
-    using dst_t = remove_cvref_t<DstArray>;
-    constexpr _type src_type_v = array_obj_type_of_v<src_t>;
-    constexpr _type dst_type_v = array_obj_type_of_v<dst_t>;
-
-    static_assert(dst_type_v == _type::array     ||
-                  dst_type_v == _type::simple    ||
-                  dst_type_v == _type::regular   ||
-                  dst_type_v == _type::irregular);
-    static_assert(src_type_v == _type::vector    ||
-                  src_type_v == _type::array     ||
-                  src_type_v == _type::simple    ||
-                  src_type_v == _type::regular   ||
-                  src_type_v == _type::irregular ||
-                  src_type_v == _type::range);
-
-    if constexpr (src_type_v == _type::vector || 
-                  src_type_v == _type::range)
-    {
-        size_t src_size = src.size();
-        assert(dst.size() == src_size);
-        no_alias_data_copy(src, dst, src_size);
-    }
-    else
-    {
-        assert(dst.check_size_with(src));
-        size_t size = src_type_v == _type::array ? src.size() : dst.size();
-
-        if (src._identifier_ptr() != dst._identifier_ptr())
-        {
-            no_alias_data_copy(src, dst, size);
-        }
-        else if constexpr (src_type_v == _type::array &&
-                           dst_type_v == _type::array)
-        { // no copy will happen between two identical arrays
-        }
-        else if constexpr (src_type_v == _type::array     ||
-                           dst_type_v == _type::array     ||
-                           src_type_v == _type::irregular ||
-                           dst_type_v == _type::irregular)
-        { // must be aliased or be unable to distinguish
-            aliased_data_copy(src, dst, size);
-        }
-        else // copy between two simple_view/regular_view
-        {
-            const auto src_ptr = src.base_ptr();
-            const auto dst_ptr = dst.base_ptr();
-            if constexpr (src_type_v == _type::simple &&
-                          dst_type_v == _type::simple)
-            {
-                if (src_ptr + size <= dst_ptr ||
-                    dst_ptr + size <= src_ptr)
-                    no_alias_data_copy(src, dst, size); // not overlaped
-                else
-                    aliased_data_copy(src, dst, size);  // overlaped
-            }
-            else if (src_type_v == _type::regular &&
-                     dst_type_v == _type::regular &&
-                     src.stride() == dst.stride())
-            { // two regular_view with the same stride 
-                const auto stride = src.stride();
-                if ((src_ptr - dst_ptr) % stride != 0  ||
-                    src_ptr + size * stride <= dst_ptr ||
-                    dst_ptr + size * stride <= src_ptr)
-                    no_alias_data_copy(src, dst, size);
-                else
-                    aliased_data_copy(src, dst, size);
-            }
-            else
-            { // two simple_view/regular_view with different stride
-                auto src_stride = src.stride();
-                auto dst_stride = dst.stride();
-                if (src_ptr + size * src_stride <= dst_ptr ||
-                    dst_ptr + size * dst_stride <= src_ptr)
-                    no_alias_data_copy(src, dst, size);
-                else
-                    aliased_data_copy(src, dst, size);
-            }
-        }
-
-    }
-}
-
-template<typename SrcArray, typename DstArray>
-inline void aliased_data_copy(const SrcArray& src, DstArray& dst, size_t size)
-{
-    NDARRAY_DEBUG(puts("aliased_data_copy() called."));
-    using src_t = remove_cvref_t<SrcArray>;
-    using dst_t = remove_cvref_t<DstArray>;
-    constexpr array_obj_type src_type_v = array_obj_type_of_v<src_t>;
-    constexpr array_obj_type dst_type_v = array_obj_type_of_v<dst_t>;
-
-    using temp_type = std::conditional_t<
-        sizeof(typename src_t::_elem_t{}) < sizeof(typename dst_t::_elem_t{}),
-        typename src_t::_elem_t, typename dst_t::_elem_t>;
-    std::vector<temp_type> temp(src.size());
-
-    src.copy_to(temp.begin(), size);    // copy src to temp
-    dst.copy_from(temp.begin(), size);  // then copy temp to dst
-}
-
-template<typename SrcArray, typename DstArray>
-inline void no_alias_data_copy(const SrcArray& src, DstArray& dst, size_t size)
-{
-    NDARRAY_DEBUG(puts("no_alias_data_copy() called."));
-    using _type = array_obj_type;
-    using src_t = remove_cvref_t<SrcArray>;
-    using dst_t = remove_cvref_t<DstArray>;
-    constexpr _type src_type_v = array_obj_type_of_v<src_t>;
-    constexpr _type dst_type_v = array_obj_type_of_v<dst_t>;
-
-    if constexpr (src_type_v == _type::vector ||
-                  src_type_v == _type::array  ||
-                  src_type_v == _type::range)
-        dst.copy_from(element_cbegin(src), size);
-    else if constexpr (dst_type_v == _type::array)
-        src.copy_to(dst.data(), size);
-    else if constexpr (src_type_v != _type::irregular)
-        dst.copy_from(element_cbegin(src), size);
-    else if constexpr (dst_type_v != _type::irregular)
-        dst.copy_from(element_cbegin(src), size);
-    else // both arrays are irregular_array_view
-        aliased_data_copy(src, dst, size);
-}
-
-
-
-}
-
+#pragma once
+
+#include "traits.h"
+#include "array.h"
+#include "array_ref.h"
+#include "array_view.h"
+#include "range_view.h"
+#include "execution.h"
+
+namespace ndarray
+{
+
+template<typename T, size_t Depth, typename Alloc>
+inline auto get_vector(const array<T, Depth, Alloc>& src)
+{
+    return src._get_vector();
+}
+template<typename T, size_t Depth, typename Alloc>
+inline auto get_vector(array<T, Depth, Alloc>&& src)
+{
+    return std::move(src._get_vector());
+}
+template<typename T, typename Alloc>
+inline auto get_vector(const std::vector<T, Alloc>& vec)
+{
+    return vec;
+}
+template<typename T, typename Alloc>
+inline auto get_vector(std::vector<T, Alloc>&& vec)
+{
+    return std::move(vec);
+}
+
+template<typename View>
+inline auto begin(View& view)
+{
+    return view.begin();
+}
+template<typename View>
+inline auto end(View& view)
+{
+    return view.end();
+}
+template<typename View>
+inline auto cbegin(View& view)
+{
+    return view.cbegin();
+}
+template<typename View>
+inline auto cend(View& view)
+{
+    return view.cend();
+}
+
+template<size_t Level, typename View>
+inline auto begin(View& view)
+{
+    return view.template begin<Level>();
+}
+template<size_t Level, typename View>
+inline auto end(View& view)
+{
+    return view.template end<Level>();
+}
+template<size_t Level, typename View>
+inline auto cbegin(View& view)
+{
+    return view.template cbegin<Level>();
+}
+template<size_t Level, typename View>
+inline auto cend(View& view)
+{
+    return view.template cend<Level>();
+}
+
+template<typename View>
+inline auto element_begin(View& view)
+{
+    return view.element_begin();
+}
+template<typename View>
+inline auto element_end(View& view)
+{
+    return view.element_end();
+}
+template<typename View>
+inline auto element_cbegin(View& view)
+{
+    return view.element_cbegin();
+}
+template<typename View>
+inline auto element_cend(View& view)
+{
+    return view.element_cend();
+}
+template<typename T, typename Alloc>
+inline auto element_begin(std::vector<T, Alloc>& vec)
+{
+    return vec.begin();
+}
+template<typename T, typename Alloc>
+inline auto element_begin(const std::vector<T, Alloc>& vec)
+{
+    return vec.begin();
+}
+template<typename T, typename Alloc>
+inline auto element_cbegin(std::vector<T, Alloc>& vec)
+{
+    return vec.cbegin();
+}
+template<typename T, typename Alloc>
+inline auto element_cbegin(const std::vector<T, Alloc>& vec)
+{
+    return vec.begin();
+}
+
+template<typename View>
+inline auto dimensions(const View& view)
+{
+    return view.dimensions();
+}
+template<typename T, typename Alloc>
+inline auto dimensions(const std::vector<T, Alloc>& vec)
+{
+    return std::array<size_t, 1>{vec.size()};
+}
+
+// pointer to the first element of an array/simple_view/regular_view
+template<typename Array>
+inline auto _fixed_stride_ptr(Array& arr)
+{
+    if constexpr (array_obj_type_of_v<remove_cvref_t<Array>> == array_obj_type::array)
+        return arr.data();
+    else
+        return arr.base_ptr();
+}
+
+// stride between elements of an array/simple_view/regular_view
+template<typename Array>
+inline ptrdiff_t _fixed_stride(const Array& arr)
+{
+    if constexpr (array_obj_type_of_v<remove_cvref_t<Array>> == array_obj_type::array)
+        return 1;
+    else
+        return arr.stride();
+}
+
+template<typename View, size_t... Levels>
+constexpr bool _has_no_irregular_level(std::index_sequence<Levels...>)
+{
+    return (!std::is_same_v<remove_cvref_t<decltype(std::declval<const View&>().template _level_indexer<Levels>())>,
+                            irregular_indexer> && ...);
+}
+
+// whether the elements of an array object are at fixed pointer strides on
+// each of its levels, so that they can be accessed in place by _operand_layout()
+template<typename Array>
+constexpr bool _is_strided_operand()
+{
+    using _type = array_obj_type;
+    constexpr _type type_v = array_obj_type_of_v<remove_cvref_t<Array>>;
+    if constexpr (type_v == _type::irregular)
+        return _has_no_irregular_level<remove_cvref_t<Array>>(std::make_index_sequence<array_depth_of_v<Array>>{});
+    else
+        return type_v == _type::vector || type_v == _type::array   ||
+               type_v == _type::simple || type_v == _type::regular ||
+               type_v == _type::strided;
+}
+
+template<typename View, size_t... Levels>
+inline auto _level_ptr_strides_of(const View& view, std::index_sequence<Levels...>)
+{
+    return std::array<ptrdiff_t, sizeof...(Levels)>{view.template _get_level_offset<Levels, false>(1)...};
+}
+
+// pointer to the first element, and pointer strides of the levels of an
+// array object for which _is_strided_operand() holds
+template<typename Array>
+inline auto _operand_layout(Array& src)
+{
+    using _type = array_obj_type;
+    constexpr _type  type_v  = array_obj_type_of_v<remove_cvref_t<Array>>;
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    static_assert(_is_strided_operand<Array>());
+
+    if constexpr (type_v == _type::vector)
+    {
+        return std::make_pair(src.data(), std::array<ptrdiff_t, 1>{1});
+    }
+    else if constexpr (type_v == _type::strided)
+    {
+        return std::make_pair(src.data(), src.strides());
+    }
+    else if constexpr (type_v == _type::irregular)
+    {
+        return std::make_pair(src.base_ptr(), _level_ptr_strides_of(src, std::make_index_sequence<depth_v>{}));
+    }
+    else
+    {
+        const auto dims = src.dimensions();
+        std::array<ptrdiff_t, depth_v> strides{};
+        strides[depth_v - 1] = _fixed_stride(src);
+        for (size_t i = depth_v - 1; i > 0; --i)
+            strides[i - 1] = strides[i] * ptrdiff_t(dims[i]);
+        return std::make_pair(_fixed_stride_ptr(src), strides);
+    }
+}
+
+// whether an array object has fixed pointer strides on its levels that are
+// not necessarily in row-major order, e.g. a transposed strided_view
+template<typename Array>
+constexpr bool _is_reorderable_layout_v =
+    _is_strided_operand<Array>() && array_depth_of_v<Array> > 1 &&
+    (array_obj_type_of_v<remove_cvref_t<Array>> == array_obj_type::strided ||
+     array_obj_type_of_v<remove_cvref_t<Array>> == array_obj_type::irregular);
+
+// pointer strides of elements laid out contiguously in row-major order
+template<size_t Depth>
+inline std::array<ptrdiff_t, Depth> _contiguous_strides(const std::array<size_t, Depth>& dims)
+{
+    std::array<ptrdiff_t, Depth> strides{};
+    ptrdiff_t stride = 1;
+    for (size_t level = Depth; level-- > 0;)
+    {
+        strides[level] = stride;
+        stride *= ptrdiff_t(dims[level]);
+    }
+    return strides;
+}
+
+// whether the memory spanned by two strided sequences of size elements overlaps
+template<typename S, typename D>
+inline bool _strided_ranges_overlap(S* src, ptrdiff_t src_stride,
+                                    D* dst, ptrdiff_t dst_stride, size_t size)
+{
+    if (size == 0)
+        return false;
+    const ptrdiff_t src_last = (ptrdiff_t(size) - 1) * src_stride;
+    const ptrdiff_t dst_last = (ptrdiff_t(size) - 1) * dst_stride;
+    const auto src_lo = src + std::min<ptrdiff_t>(src_last, 0);
+    const auto src_hi = src + std::max<ptrdiff_t>(src_last, 0);
+    const auto dst_lo = dst + std::min<ptrdiff_t>(dst_last, 0);
+    const auto dst_hi = dst + std::max<ptrdiff_t>(dst_last, 0);
+    return !(src_hi < dst_lo || dst_hi < src_lo);
+}
+
+// lowest and highest addresses of size elements of an array/simple_view/
+// regular_view/irregular_view/strided_view, where highest < lowest if there is none
+template<typename Array>
+inline auto _element_address_bounds(const Array& arr, size_t size)
+{
+    constexpr array_obj_type type_v = array_obj_type_of_v<remove_cvref_t<Array>>;
+    if constexpr (type_v == array_obj_type::irregular || type_v == array_obj_type::strided)
+    {
+        const auto bounds = arr._offset_bounds();
+        return std::make_pair(arr.base_ptr() + bounds.first, arr.base_ptr() + bounds.second);
+    }
+    else
+    {
+        const auto      ptr  = _fixed_stride_ptr(arr);
+        const ptrdiff_t last = (ptrdiff_t(size) - 1) * _fixed_stride(arr);
+        return std::make_pair(ptr + std::min<ptrdiff_t>(last, 0), ptr + std::max<ptrdiff_t>(last, 0));
+    }
+}
+
+// whether two array objects with different identifiers still share elements,
+// as an array_ref does with the array or external buffer it refers to; this
+// is detected between array/simple_view/regular_view/irregular_view/array_ref/
+// strided_view of the same element type, with exact strided ranges for the
+// fixed-stride ones and the address bounds for irregular and strided views
+template<typename SrcArray, typename DstArray>
+inline bool _may_share_elements(const SrcArray& src, const DstArray& dst, size_t size)
+{
+    using _type = array_obj_type;
+    constexpr _type src_type_v = array_obj_type_of_v<remove_cvref_t<SrcArray>>;
+    constexpr _type dst_type_v = array_obj_type_of_v<remove_cvref_t<DstArray>>;
+    constexpr bool  is_src_fixed_stride_v =
+        src_type_v == _type::array || src_type_v == _type::simple || src_type_v == _type::regular;
+    constexpr bool  is_dst_fixed_stride_v =
+        dst_type_v == _type::array || dst_type_v == _type::simple || dst_type_v == _type::regular;
+    constexpr bool  is_same_elem_v =
+        std::is_same_v<std::remove_const_t<array_elem_of_t<SrcArray>>,
+                       std::remove_const_t<array_elem_of_t<DstArray>>>;
+    if constexpr (!is_same_elem_v)
+    {
+        return false;
+    }
+    else if constexpr (is_src_fixed_stride_v && is_dst_fixed_stride_v)
+    {
+        return _strided_ranges_overlap(_fixed_stride_ptr(src), _fixed_stride(src),
+                                       _fixed_stride_ptr(dst), _fixed_stride(dst), size);
+    }
+    else if constexpr ((is_src_fixed_stride_v || src_type_v == _type::irregular || src_type_v == _type::strided) &&
+                       (is_dst_fixed_stride_v || dst_type_v == _type::irregular || dst_type_v == _type::strided))
+    {
+        if (size == 0)
+            return false;
+        const auto src_bounds = _element_address_bounds(src, size);
+        const auto dst_bounds = _element_address_bounds(dst, size);
+        return !(src_bounds.second < dst_bounds.first || dst_bounds.second < src_bounds.first);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+// upper limit of the bytes kept by a thread's scratch buffer between copies
+constexpr size_t _scratch_retained_bytes_v = size_t(1) << 24;
+
+// temporary storage for aliased copies, which reuses a thread-local buffer
+// instead of allocating on every aliased assignment; the buffer is released
+// after use if it grows beyond _scratch_retained_bytes_v, and a nested use
+// on the same thread gets its own storage
+template<typename T>
+class _scratch_buffer
+{
+public:
+    explicit _scratch_buffer(size_t size)
+    {
+        auto& pool = _pool();
+        if (pool.in_use)
+        {
+            local_.resize(size);
+            ptr_ = local_.data();
+        }
+        else
+        {
+            // the pool is taken only once the resize has succeeded, since
+            // the destructor does not run if it throws
+            if (pool.data.size() < size)
+                pool.data.resize(size);
+            pool.in_use = true;
+            acquired_   = true;
+            ptr_ = pool.data.data();
+        }
+    }
+    _scratch_buffer(const _scratch_buffer&) = delete;
+    _scratch_buffer& operator=(const _scratch_buffer&) = delete;
+
+    ~_scratch_buffer()
+    {
+        if (!acquired_)
+            return;
+        auto& pool = _pool();
+        pool.in_use = false;
+        if (pool.data.capacity() * sizeof(T) > _scratch_retained_bytes_v)
+            _storage_t().swap(pool.data);
+    }
+
+    T* data() noexcept
+    {
+        return ptr_;
+    }
+
+private:
+    // elements are all written before they are read
+    using _storage_t = std::vector<T, default_init_allocator<T>>;
+
+    struct _pool_t
+    {
+        _storage_t data;
+        bool           in_use = false;
+    };
+    static _pool_t& _pool()
+    {
+        static thread_local _pool_t pool;
+        return pool;
+    }
+
+    _storage_t local_;
+    T*         ptr_      = nullptr;
+    bool       acquired_ = false;
+};
+
+// handles data copy between array and array view
+template<typename SrcArray, typename DstArray>
+inline void data_copy(const SrcArray& src, DstArray& dst)
+{
+    using _type = array_obj_type;
+    using src_t = remove_cvref_t<SrcArray>;
+    using dst_t = remove_cvref_t<DstArray>;
+    constexpr _type src_type_v = array_obj_type_of_v<src_t>;
+    constexpr _type dst_type_v = array_obj_type_of_v<dst_t>;
+
+    static_assert(dst_type_v == _type::array     ||
+                  dst_type_v == _type::simple    ||
+                  dst_type_v == _type::regular   ||
+                  dst_type_v == _type::irregular ||
+                  dst_type_v == _type::strided);
+    static_assert(src_type_v == _type::vector    ||
+                  src_type_v == _type::array     ||
+                  src_type_v == _type::simple    ||
+                  src_type_v == _type::regular   ||
+                  src_type_v == _type::irregular ||
+                  src_type_v == _type::strided   ||
+                  src_type_v == _type::range     ||
+                  src_type_v == _type::expr      ||
+                  src_type_v == _type::chunked);
+
+    if constexpr (src_type_v == _type::vector || 
+                  src_type_v == _type::range  ||
+                  src_type_v == _type::chunked)
+    {
+        size_t src_size = src.size();
+        assert(dst.size() == src_size);
+        no_alias_data_copy(src, dst, src_size);
+    }
+    else if constexpr (src_type_v == _type::expr)
+    {
+        assert(dst.check_size_with(src));
+        size_t size = dst.size();
+        if (src._is_aliased_with(dst))
+            aliased_data_copy(src, dst, size);
+        else
+            no_alias_data_copy(src, dst, size);
+    }
+    else
+    {
+        assert(dst.check_size_with(src));
+        size_t size = src_type_v == _type::array ? src.size() : dst.size();
+
+        if (src._identifier_ptr() != dst._identifier_ptr() && 
+            !_may_share_elements(src, dst, size))
+        {
+            no_alias_data_copy(src, dst, size);
+        }
+        else if constexpr (src_type_v == _type::array &&
+                           dst_type_v == _type::array)
+        { // no copy will happen between two identical arrays
+        }
+        else if constexpr (src_type_v == _type::irregular || src_type_v == _type::strided ||
+                           dst_type_v == _type::irregular || dst_type_v == _type::strided)
+        { // must be aliased or be unable to distinguish
+            aliased_data_copy(src, dst, size);
+        }
+        else // copy between array/simple_view/regular_view
+        {
+            const auto src_ptr = _fixed_stride_ptr(src);
+            const auto dst_ptr = _fixed_stride_ptr(dst);
+            const ptrdiff_t src_stride = _fixed_stride(src);
+            const ptrdiff_t dst_stride = _fixed_stride(dst);
+            if (!_strided_ranges_overlap(src_ptr, src_stride, dst_ptr, dst_stride, size))
+            {
+                no_alias_data_copy(src, dst, size);
+            }
+            else if (src_stride == dst_stride)
+            { // same stride, copy in place in the safe direction
+                if ((dst_ptr - src_ptr) % src_stride != 0)
+                    no_alias_data_copy(src, dst, size);
+                else
+                    _overlapped_strided_copy(src_ptr, dst_ptr, src_stride, size);
+            }
+            else
+            { // different strides, elements may be read after being written
+                aliased_data_copy(src, dst, size);
+            }
+        }
+
+    }
+}
+
+template<typename SrcArray, typename DstArray>
+inline void aliased_data_copy(const SrcArray& src, DstArray& dst, size_t size)
+{
+    NDARRAY_DEBUG(puts("aliased_data_copy() called."));
+    using src_t = remove_cvref_t<SrcArray>;
+    using dst_t = remove_cvref_t<DstArray>;
+    constexpr array_obj_type src_type_v = array_obj_type_of_v<src_t>;
+    constexpr array_obj_type dst_type_v = array_obj_type_of_v<dst_t>;
+
+    using temp_type = std::remove_const_t<std::conditional_t<
+        sizeof(typename src_t::_elem_t{}) < sizeof(typename dst_t::_elem_t{}),
+        typename src_t::_elem_t, typename dst_t::_elem_t>>;
+    _scratch_buffer<temp_type> temp(size);
+
+    // copy src to temp, then copy temp to dst, in tiles if the levels of a
+    // side are reordered
+    if constexpr (_is_reorderable_layout_v<src_t>)
+    {
+        const auto src_layout = _operand_layout(src);
+        _strided_nd_copy(src_layout.first, src_layout.second,
+                         temp.data(), _contiguous_strides(src.dimensions()), src.dimensions());
+    }
+    else
+        src.copy_to(temp.data(), size);
+    if constexpr (_is_reorderable_layout_v<dst_t>)
+    {
+        const auto dst_layout = _operand_layout(dst);
+        _strided_nd_copy(temp.data(), _contiguous_strides(dst.dimensions()),
+                         dst_layout.first, dst_layout.second, dst.dimensions());
+    }
+    else
+        dst.copy_from(temp.data(), size);
+}
+
+// copy between two array objects with fixed pointer strides on their levels
+// through _strided_nd_copy(), if one is a strided_view or their innermost
+// levels differ, e.g. when one is transposed; returns whether it copied
+template<typename SrcArray, typename DstArray>
+inline bool _reordered_data_copy(const SrcArray& src, DstArray& dst)
+{
+    using _type = array_obj_type;
+    const auto src_layout = _operand_layout(src);
+    const auto dst_layout = _operand_layout(dst);
+    const auto dims       = dst.dimensions();
+    if (array_obj_type_of_v<remove_cvref_t<SrcArray>> != _type::strided &&
+        array_obj_type_of_v<remove_cvref_t<DstArray>> != _type::strided &&
+        _innermost_level(src_layout.second, dims) == _innermost_level(dst_layout.second, dims))
+        return false;
+    _strided_nd_copy(src_layout.first, src_layout.second, dst_layout.first, dst_layout.second, dims);
+    return true;
+}
+
+template<typename SrcArray, typename DstArray>
+inline void no_alias_data_copy(const SrcArray& src, DstArray& dst, size_t size)
+{
+    NDARRAY_DEBUG(puts("no_alias_data_copy() called."));
+    using _type = array_obj_type;
+    using src_t = remove_cvref_t<SrcArray>;
+    using dst_t = remove_cvref_t<DstArray>;
+    constexpr _type src_type_v = array_obj_type_of_v<src_t>;
+    constexpr _type dst_type_v = array_obj_type_of_v<dst_t>;
+
+    if constexpr ((_is_reorderable_layout_v<src_t> || _is_reorderable_layout_v<dst_t>) &&
+                  _is_strided_operand<src_t>() && _is_strided_operand<dst_t>() &&
+                  array_depth_of_v<src_t> == array_depth_of_v<dst_t>)
+    {
+        if (_reordered_data_copy(src, dst))
+            return;
+    }
+
+    if constexpr (src_type_v == _type::expr ||
+                  src_type_v == _type::chunked)
+    { // evaluate the expression or decode the tiles in a single loop over dst
+        if constexpr (dst_type_v == _type::array)
+            src.copy_to(dst.data(), size);
+        else if constexpr (dst_type_v != _type::irregular)
+            src.copy_to(dst.element_begin(), size);
+        else
+            dst.copy_from(src.element_cbegin(), size);
+    }
+    else if constexpr (src_type_v == _type::strided || dst_type_v == _type::strided)
+    { // the other side has no pointer strides or a different depth
+        if constexpr (dst_type_v == _type::strided)
+            dst.copy_from(element_cbegin(src), size);
+        else if constexpr (dst_type_v == _type::array)
+            src.copy_to(dst.data(), size);
+        else
+            src.copy_to(dst.element_begin(), size);
+    }
+    else if constexpr (src_type_v == _type::vector ||
+                       src_type_v == _type::array  ||
+                       src_type_v == _type::range)
+        dst.copy_from(element_cbegin(src), size);
+    else if constexpr (dst_type_v == _type::array)
+        src.copy_to(dst.data(), size);
+    else if constexpr (src_type_v != _type::irregular)
+        dst.copy_from(element_cbegin(src), size);
+    else if constexpr (dst_type_v != _type::irregular)
+        dst.copy_from(element_cbegin(src), size);
+    else // both arrays are irregular_array_view
+        aliased_data_copy(src, dst, size);
+}
+
+// copy size elements given by src_at(i) to an array/simple_view/regular_view,
+// splitting the flattened elements into parallel chunks
+template<typename ExecutionPolicy, typename SrcAt, typename DstArray>
+inline void _flat_parallel_copy(ExecutionPolicy&& policy, SrcAt src_at, DstArray& dst, size_t size)
+{
+    const auto      dst_ptr    = _fixed_stride_ptr(dst);
+    const ptrdiff_t dst_stride = _fixed_stride(dst);
+    parallel_for(policy, size, _parallel_min_size_v<typename DstArray::_elem_t>, [&](size_t first, size_t last)
+    {
+        if (dst_stride == 1)
+            for (size_t i = first; i < last; ++i)
+                dst_ptr[i] = src_at(i);
+        else
+            for (size_t i = first; i < last; ++i)
+                dst_ptr[ptrdiff_t(i) * dst_stride] = src_at(i);
+    });
+}
+
+// handles data copy between array and array view under an execution policy
+template<typename ExecutionPolicy, typename SrcArray, typename DstArray,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline void data_copy(ExecutionPolicy&& policy, const SrcArray& src, DstArray& dst)
+{
+    using _type = array_obj_type;
+    using src_t = remove_cvref_t<SrcArray>;
+    using dst_t = remove_cvref_t<DstArray>;
+    constexpr _type src_type_v = array_obj_type_of_v<src_t>;
+    constexpr _type dst_type_v = array_obj_type_of_v<dst_t>;
+    constexpr bool  dst_fixed_stride_v = dst_type_v == _type::array  ||
+                                         dst_type_v == _type::simple ||
+                                         dst_type_v == _type::regular;
+
+    const size_t size = dst.size();
+    if (!_is_parallel_policy_v<ExecutionPolicy> || size < _parallel_min_size_v<typename dst_t::_elem_t>)
+    {
+        data_copy(src, dst);
+    }
+    else if constexpr (src_type_v == _type::vector ||
+                       src_type_v == _type::range)
+    { // no levels to split, split the elements instead
+        assert(src.size() == size);
+        if constexpr (!dst_fixed_stride_v)
+            data_copy(src, dst);
+        else if constexpr (src_type_v == _type::vector)
+            _flat_parallel_copy(policy, [ptr = src.data()](size_t i) { return ptr[i]; }, dst, size);
+        else
+            _flat_parallel_copy(policy, [iter = src.element_cbegin()](size_t i) { return iter[ptrdiff_t(i)]; }, dst, size);
+    }
+    else if constexpr (src_type_v == _type::chunked)
+    { // decode the tiles in parallel
+        assert(src.size() == size);
+        if constexpr (dst_fixed_stride_v)
+            src._copy_to_strided(policy, _fixed_stride_ptr(dst), _fixed_stride(dst));
+        else
+            data_copy(src, dst);
+    }
+    else if constexpr (src_type_v == _type::expr)
+    { // evaluate by index when every operand can be indexed
+        assert(dst.check_size_with(src));
+        if constexpr (dst_fixed_stride_v && src_t::_is_indexed_v)
+        {
+            if (src._is_aliased_with(dst))
+                data_copy(src, dst);
+            else if constexpr (src_t::_is_rowwise_v)
+            { // split the rows of the last level
+                const auto      dst_ptr    = _fixed_stride_ptr(dst);
+                const ptrdiff_t dst_stride = _fixed_stride(dst);
+                const size_t    n_rows     = src._row_count();
+                parallel_for(policy, n_rows, _parallel_grain<typename dst_t::_elem_t>(size / n_rows),
+                             [&](size_t first, size_t last)
+                {
+                    src._copy_rows(dst_ptr, dst_stride, first, last);
+                });
+            }
+            else
+                _flat_parallel_copy(policy, src._make_accessor(), dst, size);
+        }
+        else
+            data_copy(src, dst);
+    }
+    else
+    {
+        assert(dst.check_size_with(src));
+        if (src._identifier_ptr() == dst._identifier_ptr() ||
+            _may_share_elements(src, dst, size))
+        { // possibly aliased, keep the ordered copy of data_copy()
+            data_copy(src, dst);
+            return;
+        }
+        const size_t dim_0 = dst.template dimension<0>();
+        parallel_for(policy, dim_0, _parallel_grain<typename dst_t::_elem_t>(size / dim_0), [&](size_t first, size_t last)
+        {
+            auto src_part = src.vpart(span(first, last));
+            auto dst_part = dst.vpart(span(first, last));
+            data_copy(src_part, dst_part);
+        });
+    }
+}
+
+// create array from an array object under an execution policy
+template<typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto make_array(ExecutionPolicy&& policy, const Array& src)
+{
+    using elem_t = std::remove_const_t<array_elem_of_t<Array>>;
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    if constexpr (array_obj_type_of_v<remove_cvref_t<Array>> == array_obj_type::array)
+    {
+        array<elem_t, depth_v, array_alloc_of_t<Array>> ret(default_init, src.dimensions(), src.get_allocator());
+        data_copy(policy, src, ret);
+        return ret;
+    }
+    else
+    {
+        array<elem_t, depth_v> ret(default_init, dimensions(src));
+        data_copy(policy, src, ret);
+        return ret;
+    }
+}
+
+
+
+}
+
@@ -0,0 +1,527 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "array.h"
+#include "array_interface.h"
+#include "array_reduction.h"
+#include "execution.h"
+
+namespace ndarray
+{
+
+//
+// Products of vectors and matrices, which can be arrays, array_refs,
+// std::vectors or views; other array objects are evaluated first.
+//
+//  function       operands                      result
+//---------------------------------------------------------------------
+//  dot(x, y)      n and n vectors               the inner product
+//  dot(a, x)      m x k matrix, k vector        m vector
+//  dot(x, b)      k vector, k x n matrix        n vector
+//  dot(a, b)      m x k and k x n matrices      m x n array, as matmul()
+//  matmul(a, b)   m x k and k x n matrices      m x n array
+//  matmul(a, b)   s x m x k and s x k x n       s x m x n array, the
+//                                               products of a(i) and b(i)
+//  matmul(a, b)   s x m x k and k x n           s x m x n array, the
+//                                               products of a(i) and b
+//
+// The elements of the result are of the type of a * b. All of them take
+// an execution policy as the optional first argument.
+//
+// Operands are read in place through the pointer strides of their levels,
+// including views with steps; views with a level selected by an irregular
+// span are copied first.
+//
+// Matrix products are blocked for the caches: a block of b of
+// _gemm_kc_v x _gemm_nc_v and a block of a of _gemm_mc_v x _gemm_kc_v are
+// packed into contiguous panels, from which a micro-kernel computes
+// _gemm_mr_v x _gemm_nr_v tiles of the result held in registers, with AVX2
+// and FMA for float and double when simd_level() allows it. Parallel
+// policies compute tiles of _gemm_mc_v rows (split further along the
+// columns when there are few of them) on different threads, and batched
+// products also split level 0. Inner products of long vectors are split
+// into chunks of a fixed length as in sum(), so that their results do not
+// depend on the policy.
+//
+
+// cache blocking of matrix products, in elements
+constexpr size_t _gemm_mc_v = 96;
+constexpr size_t _gemm_kc_v = 256;
+constexpr size_t _gemm_nc_v = 2048;
+
+// register tile of the micro-kernel: 4 rows of 2 AVX vectors for float and
+// double, which have an AVX2 kernel, and 4 rows of 32 bytes otherwise
+template<typename T>
+constexpr size_t _gemm_mr_v = 4;
+template<typename T>
+constexpr size_t _gemm_nr_v = std::max((std::is_floating_point_v<T> ? size_t(64) : size_t(32)) / sizeof(T),
+                                       size_t(4));
+
+// minimum multiply-adds for which a matrix product goes parallel
+constexpr size_t _gemm_parallel_min_v = size_t(1) << 20;
+
+template<typename A, typename B>
+using _product_result_t = decltype(std::declval<A>() * std::declval<B>());
+
+// rows x cols elements at ptr[i * row_stride + j * col_stride]
+template<typename T>
+struct _matrix_ref
+{
+    const T*  ptr;
+    size_t    rows;
+    size_t    cols;
+    ptrdiff_t row_stride;
+    ptrdiff_t col_stride;
+
+    const T& at(size_t i, size_t j) const
+    {
+        return ptr[ptrdiff_t(i) * row_stride + ptrdiff_t(j) * col_stride];
+    }
+
+    _matrix_ref transposed() const
+    {
+        return {ptr, cols, rows, col_stride, row_stride};
+    }
+};
+
+// a one-level operand as a column, or the i-th matrix on the last two levels
+template<typename Array>
+inline auto _make_matrix_ref(const Array& src, size_t i = 0)
+{
+    using elem_t = std::remove_const_t<array_elem_of_t<Array>>;
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    const auto dims   = ndarray::dimensions(src);
+    const auto layout = _operand_layout(src);
+    const auto& s     = layout.second;
+    if constexpr (depth_v == 1)
+        return _matrix_ref<elem_t>{layout.first, dims[0], 1, s[0], 0};
+    else if constexpr (depth_v == 2)
+        return _matrix_ref<elem_t>{layout.first, dims[0], dims[1], s[0], s[1]};
+    else
+        return _matrix_ref<elem_t>{layout.first + ptrdiff_t(i) * s[0], dims[1], dims[2], s[1], s[2]};
+}
+
+// inner product of len elements at a, a + a_stride, ... and b, b + b_stride, ...
+template<typename R, typename A, typename B>
+inline R _dot_run(const A* a, ptrdiff_t a_stride, const B* b, ptrdiff_t b_stride, size_t len)
+{
+    constexpr size_t lanes_v = _reduce_lanes_v;
+    R lanes[lanes_v] = {};
+    size_t i = 0;
+    if (a_stride == 1 && b_stride == 1)
+    {
+        for (; i + lanes_v <= len; i += lanes_v)
+            for (size_t l = 0; l < lanes_v; ++l)
+                lanes[l] += R(a[i + l]) * R(b[i + l]);
+        for (; i < len; ++i)
+            lanes[0] += R(a[i]) * R(b[i]);
+    }
+    else
+    {
+        for (; i + lanes_v <= len; i += lanes_v)
+            for (size_t l = 0; l < lanes_v; ++l)
+                lanes[l] += R(a[ptrdiff_t(i + l) * a_stride]) * R(b[ptrdiff_t(i + l) * b_stride]);
+        for (; i < len; ++i)
+            lanes[0] += R(a[ptrdiff_t(i) * a_stride]) * R(b[ptrdiff_t(i) * b_stride]);
+    }
+    for (size_t l = 1; l < lanes_v; ++l)
+        lanes[0] += lanes[l];
+    return lanes[0];
+}
+
+// pack rows [i0, i0 + mc) and columns [p0, p0 + kc) of a into panels of
+// _gemm_mr_v rows, each stored column by column; rows past mc are zero
+template<typename R, typename A>
+inline void _gemm_pack_a(R* dst, const _matrix_ref<A>& a, size_t i0, size_t mc, size_t p0, size_t kc)
+{
+    constexpr size_t mr_v = _gemm_mr_v<R>;
+    for (size_t ir = 0; ir < mc; ir += mr_v)
+    {
+        const size_t rows = std::min(mr_v, mc - ir);
+        for (size_t i = 0; i < mr_v; ++i)
+        {
+            R* panel = dst + i;
+            if (i < rows)
+            {
+                const A* src = &a.at(i0 + ir + i, p0);
+                for (size_t p = 0; p < kc; ++p)
+                    panel[p * mr_v] = R(src[ptrdiff_t(p) * a.col_stride]);
+            }
+            else
+                for (size_t p = 0; p < kc; ++p)
+                    panel[p * mr_v] = R{};
+        }
+        dst += mr_v * kc;
+    }
+}
+
+// pack rows [p0, p0 + kc) and columns [j0, j0 + nc) of b into panels of
+// _gemm_nr_v columns, each stored row by row; columns past nc are zero
+template<typename R, typename B>
+inline void _gemm_pack_b(R* dst, const _matrix_ref<B>& b, size_t p0, size_t kc, size_t j0, size_t nc)
+{
+    constexpr size_t nr_v = _gemm_nr_v<R>;
+    for (size_t jr = 0; jr < nc; jr += nr_v)
+    {
+        const size_t cols = std::min(nr_v, nc - jr);
+        for (size_t p = 0; p < kc; ++p)
+        {
+            const B* src = &b.at(p0 + p, j0 + jr);
+            size_t j = 0;
+            if (b.col_stride == 1)
+                for (; j < cols; ++j)
+                    dst[j] = R(src[j]);
+            else
+                for (; j < cols; ++j)
+                    dst[j] = R(src[ptrdiff_t(j) * b.col_stride]);
+            for (; j < nr_v; ++j)
+                dst[j] = R{};
+            dst += nr_v;
+        }
+    }
+}
+
+#if defined(NDARRAY_X86_SIMD)
+// acc = a * b for a 4 x 16 tile of float, in 8 AVX registers
+NDARRAY_TARGET("avx2,fma")
+inline void _gemm_tile_avx2(size_t kc, const float* a, const float* b, float* acc)
+{
+    __m256 c00 = _mm256_setzero_ps(), c01 = c00, c10 = c00, c11 = c00;
+    __m256 c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+    for (size_t p = 0; p < kc; ++p, a += 4, b += 16)
+    {
+        const __m256 b0 = _mm256_loadu_ps(b);
+        const __m256 b1 = _mm256_loadu_ps(b + 8);
+        __m256 ai = _mm256_broadcast_ss(a);
+        c00 = _mm256_fmadd_ps(ai, b0, c00);
+        c01 = _mm256_fmadd_ps(ai, b1, c01);
+        ai  = _mm256_broadcast_ss(a + 1);
+        c10 = _mm256_fmadd_ps(ai, b0, c10);
+        c11 = _mm256_fmadd_ps(ai, b1, c11);
+        ai  = _mm256_broadcast_ss(a + 2);
+        c20 = _mm256_fmadd_ps(ai, b0, c20);
+        c21 = _mm256_fmadd_ps(ai, b1, c21);
+        ai  = _mm256_broadcast_ss(a + 3);
+        c30 = _mm256_fmadd_ps(ai, b0, c30);
+        c31 = _mm256_fmadd_ps(ai, b1, c31);
+    }
+    _mm256_storeu_ps(acc,      c00);
+    _mm256_storeu_ps(acc + 8,  c01);
+    _mm256_storeu_ps(acc + 16, c10);
+    _mm256_storeu_ps(acc + 24, c11);
+    _mm256_storeu_ps(acc + 32, c20);
+    _mm256_storeu_ps(acc + 40, c21);
+    _mm256_storeu_ps(acc + 48, c30);
+    _mm256_storeu_ps(acc + 56, c31);
+}
+
+// acc = a * b for a 4 x 8 tile of double, in 8 AVX registers
+NDARRAY_TARGET("avx2,fma")
+inline void _gemm_tile_avx2(size_t kc, const double* a, const double* b, double* acc)
+{
+    __m256d c00 = _mm256_setzero_pd(), c01 = c00, c10 = c00, c11 = c00;
+    __m256d c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+    for (size_t p = 0; p < kc; ++p, a += 4, b += 8)
+    {
+        const __m256d b0 = _mm256_loadu_pd(b);
+        const __m256d b1 = _mm256_loadu_pd(b + 4);
+        __m256d ai = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(ai, b0, c00);
+        c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai  = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10);
+        c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai  = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20);
+        c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai  = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30);
+        c31 = _mm256_fmadd_pd(ai, b1, c31);
+    }
+    _mm256_storeu_pd(acc,      c00);
+    _mm256_storeu_pd(acc + 4,  c01);
+    _mm256_storeu_pd(acc + 8,  c10);
+    _mm256_storeu_pd(acc + 12, c11);
+    _mm256_storeu_pd(acc + 16, c20);
+    _mm256_storeu_pd(acc + 20, c21);
+    _mm256_storeu_pd(acc + 24, c30);
+    _mm256_storeu_pd(acc + 28, c31);
+}
+#endif // NDARRAY_X86_SIMD
+
+// rows x cols elements of c = (overwrite ? 0 : c) + a * b, where a and b are
+// packed panels of kc columns/rows
+template<typename R>
+inline void _gemm_micro_kernel(size_t kc, const R* a, const R* b, R* c, size_t ldc,
+                               size_t rows, size_t cols, bool overwrite)
+{
+    constexpr size_t mr_v = _gemm_mr_v<R>;
+    constexpr size_t nr_v = _gemm_nr_v<R>;
+    R acc[mr_v][nr_v] = {};
+
+    // the loops below are vectorized by the compiler, but not always along
+    // the rows of the tile, so float and double use AVX2 where available
+    bool is_done = false;
+#if defined(NDARRAY_X86_SIMD)
+    if constexpr (std::is_same_v<R, float> || std::is_same_v<R, double>)
+        if (simd_level() != simd_level_type::scalar)
+        {
+            _gemm_tile_avx2(kc, a, b, acc[0]);
+            is_done = true;
+        }
+#endif
+    if (!is_done)
+        for (size_t p = 0; p < kc; ++p, a += mr_v, b += nr_v)
+            for (size_t i = 0; i < mr_v; ++i)
+                for (size_t j = 0; j < nr_v; ++j)
+                    acc[i][j] += a[i] * b[j];
+
+    for (size_t i = 0; i < rows; ++i, c += ldc)
+    {
+        if (overwrite)
+            for (size_t j = 0; j < cols; ++j)
+                c[j] = acc[i][j];
+        else
+            for (size_t j = 0; j < cols; ++j)
+                c[j] += acc[i][j];
+    }
+}
+
+// c = a * b, where c has rows of ldc elements
+template<typename ExecutionPolicy, typename R, typename A, typename B>
+inline void _gemm(ExecutionPolicy&& policy, R* c, size_t ldc, const _matrix_ref<A>& a, const _matrix_ref<B>& b)
+{
+    constexpr size_t nr_v = _gemm_nr_v<R>;
+    const size_t m = a.rows;
+    const size_t n = b.cols;
+    const size_t k = a.cols;
+    NDARRAY_ASSERT(b.rows == k);
+    if (m == 0 || n == 0)
+        return;
+    if (k == 0)
+    {
+        for (size_t i = 0; i < m; ++i)
+            std::fill_n(c + i * ldc, n, R{});
+        return;
+    }
+
+    // tiles of the result, each computed by one thread
+    const size_t n_row_tiles = (m + _gemm_mc_v - 1) / _gemm_mc_v;
+    size_t       tile_n      = std::min(n, _gemm_nc_v);
+    if (_is_parallel_policy_v<ExecutionPolicy> && m * n * k >= _gemm_parallel_min_v)
+    { // split columns too when there are fewer rows of tiles than threads
+        const size_t n_threads = _executor_of(policy).size();
+        if (n_row_tiles < n_threads)
+        {
+            const size_t n_col_tiles = std::min((n + nr_v - 1) / nr_v,
+                                                (n_threads + n_row_tiles - 1) / n_row_tiles);
+            tile_n = std::min(tile_n, (n / n_col_tiles + nr_v - 1) / nr_v * nr_v);
+        }
+    }
+    const size_t n_col_tiles = (n + tile_n - 1) / tile_n;
+    const size_t n_tiles     = n_row_tiles * n_col_tiles;
+    const size_t packed_n    = (tile_n + nr_v - 1) / nr_v * nr_v;
+
+    auto compute_tiles = [&](size_t first, size_t last)
+    {
+        _scratch_buffer<R> buffer(_gemm_mc_v * _gemm_kc_v + _gemm_kc_v * packed_n);
+        R* const a_pack = buffer.data();
+        R* const b_pack = a_pack + _gemm_mc_v * _gemm_kc_v;
+        for (size_t t = first; t < last; ++t)
+        {
+            const size_t i0 = t / n_col_tiles * _gemm_mc_v;
+            const size_t j0 = t % n_col_tiles * tile_n;
+            const size_t mc = std::min(_gemm_mc_v, m - i0);
+            const size_t nc = std::min(tile_n, n - j0);
+            for (size_t p0 = 0; p0 < k; p0 += _gemm_kc_v)
+            {
+                const size_t kc = std::min(_gemm_kc_v, k - p0);
+                _gemm_pack_b(b_pack, b, p0, kc, j0, nc);
+                _gemm_pack_a(a_pack, a, i0, mc, p0, kc);
+                for (size_t jr = 0; jr < nc; jr += nr_v)
+                    for (size_t ir = 0; ir < mc; ir += _gemm_mr_v<R>)
+                        _gemm_micro_kernel(kc, a_pack + ir * kc, b_pack + jr * kc,
+                                           c + (i0 + ir) * ldc + j0 + jr, ldc,
+                                           std::min(_gemm_mr_v<R>, mc - ir), std::min(nr_v, nc - jr),
+                                           p0 == 0);
+            }
+        }
+    };
+    if (m * n * k >= _gemm_parallel_min_v)
+        parallel_for(policy, n_tiles, 1, compute_tiles);
+    else
+        compute_tiles(0, n_tiles);
+}
+
+// y = a * x, where x is a column
+template<typename ExecutionPolicy, typename R, typename A, typename B>
+inline void _gemv(ExecutionPolicy&& policy, R* y, const _matrix_ref<A>& a, const _matrix_ref<B>& x)
+{
+    NDARRAY_ASSERT(x.rows == a.cols);
+    parallel_for(policy, a.rows, _parallel_grain<R>(a.cols), [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            y[i] = _dot_run<R>(&a.at(i, 0), a.col_stride, x.ptr, x.row_stride, a.cols);
+    });
+}
+
+// y = x * b, where x is a column, as a sum of the rows of b
+template<typename ExecutionPolicy, typename R, typename A, typename B>
+inline void _gevm(ExecutionPolicy&& policy, R* y, const _matrix_ref<A>& x, const _matrix_ref<B>& b)
+{
+    NDARRAY_ASSERT(x.rows == b.rows);
+    parallel_for(policy, b.cols, _parallel_grain<R>(b.rows), [&](size_t first, size_t last)
+    {
+        std::fill(y + first, y + last, R{});
+        for (size_t p = 0; p < b.rows; ++p)
+        {
+            const R  xp  = R(x.at(p, 0));
+            const B* row = &b.at(p, 0);
+            if (b.col_stride == 1)
+                for (size_t j = first; j < last; ++j)
+                    y[j] += xp * R(row[j]);
+            else
+                for (size_t j = first; j < last; ++j)
+                    y[j] += xp * R(row[ptrdiff_t(j) * b.col_stride]);
+        }
+    });
+}
+
+// matrix product, or matrix products over level 0 of three-level operands
+template<typename ExecutionPolicy, typename ArrayA, typename ArrayB,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto matmul(ExecutionPolicy&& policy, const ArrayA& a, const ArrayB& b)
+{
+    constexpr size_t depth_a_v = array_depth_of_v<ArrayA>;
+    constexpr size_t depth_b_v = array_depth_of_v<ArrayB>;
+    static_assert((depth_a_v == 2 || depth_a_v == 3) && depth_b_v <= depth_a_v && depth_b_v >= 2,
+                  "matmul() takes matrices, or a stack of them and a matrix or stack of them.");
+    using result_t = _product_result_t<std::remove_const_t<array_elem_of_t<ArrayA>>,
+                                       std::remove_const_t<array_elem_of_t<ArrayB>>>;
+
+    if constexpr (!_is_strided_operand<ArrayA>())
+    {
+        return matmul(policy, make_array(a), b);
+    }
+    else if constexpr (!_is_strided_operand<ArrayB>())
+    {
+        return matmul(policy, a, make_array(b));
+    }
+    else if constexpr (depth_a_v == 2)
+    {
+        const auto a_ref = _make_matrix_ref(a);
+        const auto b_ref = _make_matrix_ref(b);
+        NDARRAY_ASSERT(a_ref.cols == b_ref.rows);
+        array<result_t, 2> ret(default_init, std::array<size_t, 2>{a_ref.rows, b_ref.cols});
+        _gemm(policy, ret.data(), b_ref.cols, a_ref, b_ref);
+        return ret;
+    }
+    else
+    {
+        const size_t n_batch = a.template dimension<0>();
+        const auto   a_ref   = _make_matrix_ref(a);
+        const auto   b_ref   = _make_matrix_ref(b);
+        if constexpr (depth_b_v == 3)
+            NDARRAY_ASSERT(b.template dimension<0>() == n_batch);
+        NDARRAY_ASSERT(a_ref.cols == b_ref.rows);
+        array<result_t, 3> ret(default_init, std::array<size_t, 3>{n_batch, a_ref.rows, b_ref.cols});
+        const size_t step = a_ref.rows * b_ref.cols;
+        parallel_for(policy, n_batch, _parallel_grain<result_t>(step * a_ref.cols), [&](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                if constexpr (depth_b_v == 3)
+                    _gemm(policy, ret.data() + i * step, b_ref.cols, _make_matrix_ref(a, i), _make_matrix_ref(b, i));
+                else
+                    _gemm(policy, ret.data() + i * step, b_ref.cols, _make_matrix_ref(a, i), b_ref);
+            }
+        });
+        return ret;
+    }
+}
+
+template<typename ArrayA, typename ArrayB>
+inline auto matmul(const ArrayA& a, const ArrayB& b)
+{
+    return matmul(seq, a, b);
+}
+
+// inner product of vectors, or products of a matrix and a vector or matrix
+template<typename ExecutionPolicy, typename ArrayA, typename ArrayB,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto dot(ExecutionPolicy&& policy, const ArrayA& a, const ArrayB& b)
+{
+    constexpr size_t depth_a_v = array_depth_of_v<ArrayA>;
+    constexpr size_t depth_b_v = array_depth_of_v<ArrayB>;
+    static_assert(depth_a_v <= 2 && depth_b_v <= 2, "dot() takes vectors and matrices.");
+    using result_t = _product_result_t<std::remove_const_t<array_elem_of_t<ArrayA>>,
+                                       std::remove_const_t<array_elem_of_t<ArrayB>>>;
+
+    if constexpr (depth_a_v == 2 && depth_b_v == 2)
+    {
+        return matmul(policy, a, b);
+    }
+    else if constexpr (!_is_strided_operand<ArrayA>())
+    {
+        return dot(policy, make_array(a), b);
+    }
+    else if constexpr (!_is_strided_operand<ArrayB>())
+    {
+        return dot(policy, a, make_array(b));
+    }
+    else if constexpr (depth_a_v == 1 && depth_b_v == 1)
+    {
+        const auto x = _make_matrix_ref(a);
+        const auto y = _make_matrix_ref(b);
+        NDARRAY_ASSERT(x.rows == y.rows);
+        const size_t n        = x.rows;
+        const size_t chunk    = _parallel_min_size_v<result_t>;
+        const size_t n_chunks = (n + chunk - 1) / chunk;
+        if (n_chunks <= 1)
+            return _dot_run<result_t>(x.ptr, x.row_stride, y.ptr, y.row_stride, n);
+
+        // chunks of a fixed length whatever the policy, whose partial
+        // products are added pairwise in order, as in sum()
+        std::vector<result_t> partials(n_chunks);
+        parallel_for(policy, n_chunks, 1, [&](size_t first, size_t last)
+        {
+            for (size_t c = first; c < last; ++c)
+            {
+                const size_t i0 = c * chunk;
+                partials[c] = _dot_run<result_t>(&x.at(i0, 0), x.row_stride, &y.at(i0, 0), y.row_stride,
+                                                 std::min(chunk, n - i0));
+            }
+        });
+        for (size_t width = 1; width < n_chunks; width *= 2)
+            for (size_t c = 0; c + width < n_chunks; c += 2 * width)
+                partials[c] += partials[c + width];
+        return partials[0];
+    }
+    else if constexpr (depth_a_v == 2)
+    {
+        const auto a_ref = _make_matrix_ref(a);
+        array<result_t, 1> ret(default_init, std::array<size_t, 1>{a_ref.rows});
+        _gemv(policy, ret.data(), a_ref, _make_matrix_ref(b));
+        return ret;
+    }
+    else
+    {
+        const auto b_ref = _make_matrix_ref(b);
+        array<result_t, 1> ret(default_init, std::array<size_t, 1>{b_ref.cols});
+        _gevm(policy, ret.data(), _make_matrix_ref(a), b_ref);
+        return ret;
+    }
+}
+
+template<typename ArrayA, typename ArrayB>
+inline auto dot(const ArrayA& a, const ArrayB& b)
+{
+    return dot(seq, a, b);
+}
+
+}
@@ -0,0 +1,668 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "array.h"
+#include "array_interface.h"
+#include "execution.h"
+
+namespace ndarray
+{
+
+//
+// Reductions combine the elements of an array object into one value, or
+// reduce one level of it into an array with that level removed.
+//
+//  function          result                  empty input
+//---------------------------------------------------------------------
+//  sum(a)            sum of elements         0
+//  prod(a)           product of elements     1
+//  min(a), max(a)    least/greatest element  +infinity/-infinity, or the
+//                                            greatest/least value
+//  mean(a)           sum(a) / size           NaN
+//
+// sum<Level>(a) etc. reduce along one level, e.g. sum<1>(a) of a 3x4x5
+// array gives a 3x5 array. All of them take an execution policy as the
+// optional first argument. sum() and mean() take a summation method of
+// floating-point numbers as the optional last argument:
+//
+//  naive_summation     one pass with independent partial sums
+//  pairwise_summation  pairwise over blocks, error O(log n) (default)
+//  kahan_summation     compensated summation, error O(1)
+//
+// Integers are always summed in the naive way. Sums and products of small
+// integers are promoted as by the + operator, and their means are double.
+//
+// Elements are read as runs of strided pointers where the array object
+// has them (array, array_ref, simple/regular/irregular views), and through
+// a small buffer filled by element iterators otherwise. Reductions over all
+// elements are split along level 0 into chunks of a fixed number of
+// elements, whatever the policy, and the partial results of the chunks are
+// combined pairwise in order; the policy only decides which threads reduce
+// the chunks, so results do not depend on it or on the number of threads.
+// Reductions along a level split the work along level 0 (level 1 when
+// reducing level 0), which leaves the order of each result unchanged.
+//
+
+struct naive_summation_t
+{
+    explicit naive_summation_t() = default;
+};
+struct pairwise_summation_t
+{
+    explicit pairwise_summation_t() = default;
+};
+struct kahan_summation_t
+{
+    explicit kahan_summation_t() = default;
+};
+
+constexpr naive_summation_t    naive_summation{};
+constexpr pairwise_summation_t pairwise_summation{};
+constexpr kahan_summation_t    kahan_summation{};
+
+template<typename T>
+constexpr bool _is_summation_v =
+    std::is_same_v<remove_cvref_t<T>, naive_summation_t> ||
+    std::is_same_v<remove_cvref_t<T>, pairwise_summation_t> ||
+    std::is_same_v<remove_cvref_t<T>, kahan_summation_t>;
+
+template<typename T>
+using _enable_if_summation_t = std::enable_if_t<_is_summation_v<T>, int>;
+
+// Level argument of reductions over all elements
+constexpr size_t _reduce_all_v = size_t(-1);
+
+// number of independent accumulators in the inner loops
+constexpr size_t _reduce_lanes_v = 8;
+
+// number of elements summed directly by pairwise summation
+constexpr size_t _pairwise_block_v = 128;
+
+// number of rows summed directly by pairwise summation along a level
+constexpr size_t _pairwise_rows_block_v = 8;
+
+
+template<typename Array>
+using _reduce_elem_t = std::remove_const_t<array_elem_of_t<Array>>;
+
+template<typename T>
+using _sum_result_t = decltype(std::declval<T>() + std::declval<T>());
+
+template<typename T>
+using _mean_result_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+
+struct _sum_op
+{
+    template<typename R>
+    static constexpr R identity()
+    {
+        return R(0);
+    }
+    template<typename R>
+    R operator()(R a, R b) const
+    {
+        return a + b;
+    }
+};
+
+struct _prod_op
+{
+    template<typename R>
+    static constexpr R identity()
+    {
+        return R(1);
+    }
+    template<typename R>
+    R operator()(R a, R b) const
+    {
+        return a * b;
+    }
+};
+
+struct _min_op
+{
+    template<typename R>
+    static constexpr R identity()
+    {
+        if constexpr (std::numeric_limits<R>::has_infinity)
+            return std::numeric_limits<R>::infinity();
+        else
+            return std::numeric_limits<R>::max();
+    }
+    template<typename R>
+    R operator()(R a, R b) const
+    {
+        return b < a ? b : a;
+    }
+};
+
+struct _max_op
+{
+    template<typename R>
+    static constexpr R identity()
+    {
+        if constexpr (std::numeric_limits<R>::has_infinity)
+            return -std::numeric_limits<R>::infinity();
+        else
+            return std::numeric_limits<R>::lowest();
+    }
+    template<typename R>
+    R operator()(R a, R b) const
+    {
+        return a < b ? b : a;
+    }
+};
+
+struct _assign_op
+{
+    template<typename R>
+    R operator()(R, R b) const
+    {
+        return b;
+    }
+};
+
+
+// reduce len elements at ptr, ptr + stride, ... with _reduce_lanes_v
+// independent accumulators, so that the loop is not bound by the latency
+// of op and can be vectorized without reassociating floating-point math
+template<typename R, typename Op, typename S>
+inline R _reduce_run(Op op, const S* ptr, ptrdiff_t stride, size_t len)
+{
+    constexpr size_t lanes_v = _reduce_lanes_v;
+    R acc[lanes_v];
+    for (size_t j = 0; j < lanes_v; ++j)
+        acc[j] = Op::template identity<R>();
+
+    size_t i = 0;
+    if (stride == 1)
+    {
+        for (; i + lanes_v <= len; i += lanes_v)
+            for (size_t j = 0; j < lanes_v; ++j)
+                acc[j] = op(acc[j], R(ptr[i + j]));
+    }
+    else
+    {
+        for (; i + lanes_v <= len; i += lanes_v)
+            for (size_t j = 0; j < lanes_v; ++j)
+                acc[j] = op(acc[j], R(ptr[ptrdiff_t(i + j) * stride]));
+    }
+    for (size_t j = 0; i < len; ++i, ++j)
+        acc[j] = op(acc[j], R(ptr[ptrdiff_t(i) * stride]));
+
+    for (size_t width = lanes_v / 2; width > 0; width /= 2)
+        for (size_t j = 0; j < width; ++j)
+            acc[j] = op(acc[j], acc[j + width]);
+    return acc[0];
+}
+
+// sum of a run by halving it until blocks of _pairwise_block_v elements
+template<typename R, typename S>
+inline R _pairwise_sum_run(const S* ptr, ptrdiff_t stride, size_t len)
+{
+    if (len <= _pairwise_block_v)
+        return _reduce_run<R>(_sum_op{}, ptr, stride, len);
+    const size_t half = len / 2 / _reduce_lanes_v * _reduce_lanes_v;
+    return _pairwise_sum_run<R>(ptr, stride, half) +
+        _pairwise_sum_run<R>(ptr + ptrdiff_t(half) * stride, stride, len - half);
+}
+
+// add value to a compensated sum
+template<typename R>
+inline void _kahan_add(R& sum, R& comp, R value)
+{
+    const R y = value - comp;
+    const R t = sum + y;
+    comp = (t - sum) - y;
+    sum  = t;
+}
+
+
+// call fn(ptr, stride, len) on consecutive runs covering the elements of
+// an array object in order
+template<typename Array, typename Function>
+inline void _for_each_run(const Array& src, Function&& fn)
+{
+    constexpr array_obj_type type_v = array_obj_type_of_v<Array>;
+    if constexpr (type_v == array_obj_type::vector)
+    {
+        fn(src.data(), ptrdiff_t(1), src.size());
+    }
+    else if constexpr (type_v == array_obj_type::array ||
+                       type_v == array_obj_type::simple ||
+                       type_v == array_obj_type::regular)
+    {
+        fn(_fixed_stride_ptr(src), _fixed_stride(src), src.size());
+    }
+    else if constexpr (type_v == array_obj_type::irregular ||
+                       type_v == array_obj_type::strided)
+    {
+        src.template traverse_runs<decltype((fn))>(fn); // pass by reference type
+    }
+    else // elements without addresses go through a buffer
+    {
+        constexpr size_t buffer_size_v = 256;
+        _reduce_elem_t<Array> buffer[buffer_size_v];
+        const size_t size = src.size();
+        auto iter = src.element_cbegin();
+        for (size_t pos = 0; pos < size; pos += buffer_size_v)
+        {
+            const size_t len = std::min(buffer_size_v, size - pos);
+            for (size_t i = 0; i < len; ++i, ++iter)
+                buffer[i] = *iter;
+            fn(static_cast<const _reduce_elem_t<Array>*>(buffer), ptrdiff_t(1), len);
+        }
+    }
+}
+
+// row[i] = op(row[i], i-th element of src) for all elements of src
+template<typename Op, typename R, typename Array>
+inline void _accumulate_row(Op op, R* row, const Array& src)
+{
+    _for_each_run(src, [op, &row](const auto* ptr, ptrdiff_t stride, size_t len)
+    {
+        if (stride == 1)
+            for (size_t i = 0; i < len; ++i)
+                row[i] = op(row[i], R(ptr[i]));
+        else
+            for (size_t i = 0; i < len; ++i)
+                row[i] = op(row[i], R(ptr[ptrdiff_t(i) * stride]));
+        row += len;
+    });
+}
+
+// number of elements in each sub-view along level 0
+template<typename Array>
+inline size_t _row_size(const Array& src)
+{
+    const auto dims = src.dimensions();
+    size_t size = 1;
+    for (size_t i = 1; i < dims.size(); ++i)
+        size *= dims[i];
+    return size;
+}
+
+
+// Reducers accumulate runs of elements with add_run(), are combined in
+// order with merge(), and reduce the sub-views of a view along level 0
+// into a row with reduce_rows().
+
+template<typename R, typename Op>
+struct _op_reducer
+{
+    using _result_t = R;
+
+    R value_ = Op::template identity<R>();
+
+    template<typename S>
+    void add_run(const S* ptr, ptrdiff_t stride, size_t len)
+    {
+        value_ = Op{}(value_, _reduce_run<R>(Op{}, ptr, stride, len));
+    }
+    void merge(const _op_reducer& other)
+    {
+        value_ = Op{}(value_, other.value_);
+    }
+    R result() const
+    {
+        return value_;
+    }
+
+    template<typename View>
+    static void reduce_rows(R* row, const View& src)
+    {
+        const size_t n = src.template dimension<0>();
+        std::fill_n(row, _row_size(src), Op::template identity<R>());
+        for (size_t k = 0; k < n; ++k)
+            _accumulate_row(Op{}, row, src.vpart(k));
+    }
+};
+
+template<typename R>
+struct _pairwise_sum_reducer
+{
+    using _result_t = R;
+
+    R value_ = R(0);
+
+    template<typename S>
+    void add_run(const S* ptr, ptrdiff_t stride, size_t len)
+    {
+        value_ += _pairwise_sum_run<R>(ptr, stride, len);
+    }
+    void merge(const _pairwise_sum_reducer& other)
+    {
+        value_ += other.value_;
+    }
+    R result() const
+    {
+        return value_;
+    }
+
+    template<typename View>
+    static void reduce_rows(R* row, const View& src)
+    {
+        const size_t n        = src.template dimension<0>();
+        const size_t row_size = _row_size(src);
+        size_t n_levels = 0;
+        for (size_t len = n; len > _pairwise_rows_block_v; len = (len + 1) / 2)
+            ++n_levels;
+        _scratch_buffer<R> scratch(row_size * n_levels);
+        _reduce_rows_impl(row, scratch.data(), row_size, src, 0, n);
+    }
+
+    // the left half is summed into row, and the right half into scratch,
+    // whose following rows are used by the halves of the right half
+    template<typename View>
+    static void _reduce_rows_impl(R* row, R* scratch, size_t row_size,
+                                  const View& src, size_t first, size_t last)
+    {
+        if (last - first <= _pairwise_rows_block_v)
+        {
+            std::fill_n(row, row_size, R(0));
+            for (size_t k = first; k < last; ++k)
+                _accumulate_row(_sum_op{}, row, src.vpart(k));
+        }
+        else
+        {
+            const size_t mid = first + (last - first + 1) / 2;
+            _reduce_rows_impl(row, scratch, row_size, src, first, mid);
+            _reduce_rows_impl(scratch, scratch + row_size, row_size, src, mid, last);
+            for (size_t i = 0; i < row_size; ++i)
+                row[i] += scratch[i];
+        }
+    }
+};
+
+template<typename R>
+struct _kahan_sum_reducer
+{
+    using _result_t = R;
+
+    R sum_  = R(0);
+    R comp_ = R(0);
+
+    // lanes of compensated sums are kept independently as in _reduce_run()
+    template<typename S>
+    void add_run(const S* ptr, ptrdiff_t stride, size_t len)
+    {
+        constexpr size_t lanes_v = _reduce_lanes_v;
+        R sums[lanes_v]  = {};
+        R comps[lanes_v] = {};
+        size_t i = 0;
+        for (; i + lanes_v <= len; i += lanes_v)
+            for (size_t j = 0; j < lanes_v; ++j)
+                _kahan_add(sums[j], comps[j], R(ptr[ptrdiff_t(i + j) * stride]));
+        for (; i < len; ++i)
+            _kahan_add(sum_, comp_, R(ptr[ptrdiff_t(i) * stride]));
+        for (size_t j = 0; j < lanes_v; ++j)
+        {
+            _kahan_add(sum_, comp_, sums[j]);
+            _kahan_add(sum_, comp_, -comps[j]);
+        }
+    }
+    void merge(const _kahan_sum_reducer& other)
+    {
+        _kahan_add(sum_, comp_, other.sum_);
+        _kahan_add(sum_, comp_, -other.comp_);
+    }
+    R result() const
+    {
+        return sum_;
+    }
+
+    template<typename View>
+    static void reduce_rows(R* row, const View& src)
+    {
+        const size_t n        = src.template dimension<0>();
+        const size_t row_size = _row_size(src);
+        _scratch_buffer<R> comp(row_size);
+        std::fill_n(row, row_size, R(0));
+        std::fill_n(comp.data(), row_size, R(0));
+        for (size_t k = 0; k < n; ++k)
+        {
+            R* sum_ptr  = row;
+            R* comp_ptr = comp.data();
+            _for_each_run(src.vpart(k), [&](const auto* ptr, ptrdiff_t stride, size_t len)
+            {
+                for (size_t i = 0; i < len; ++i)
+                    _kahan_add(sum_ptr[i], comp_ptr[i], R(ptr[ptrdiff_t(i) * stride]));
+                sum_ptr  += len;
+                comp_ptr += len;
+            });
+        }
+    }
+};
+
+template<typename R, typename Summation>
+using _sum_reducer_t = std::conditional_t<!std::is_floating_point_v<R> ||
+    std::is_same_v<remove_cvref_t<Summation>, naive_summation_t>, _op_reducer<R, _sum_op>,
+    std::conditional_t<std::is_same_v<remove_cvref_t<Summation>, kahan_summation_t>,
+        _kahan_sum_reducer<R>, _pairwise_sum_reducer<R>>>;
+
+
+// whether the work of a reduction can be split with vpart()
+template<typename Array>
+constexpr bool _is_reduce_splittable_v =
+    array_obj_type_of_v<Array> == array_obj_type::array ||
+    array_obj_type_of_v<Array> == array_obj_type::simple ||
+    array_obj_type_of_v<Array> == array_obj_type::regular ||
+    array_obj_type_of_v<Array> == array_obj_type::irregular ||
+    array_obj_type_of_v<Array> == array_obj_type::strided;
+
+template<typename Reducer, typename Array>
+inline Reducer _reduce_all_seq(const Array& src)
+{
+    Reducer reducer{};
+    _for_each_run(src, [&reducer](const auto* ptr, ptrdiff_t stride, size_t len)
+    {
+        reducer.add_run(ptr, stride, len);
+    });
+    return reducer;
+}
+
+// reduce all elements of an array object; the chunks depend only on the
+// dimensions of src, so that sequential and parallel policies give
+// identical results
+template<typename Reducer, typename ExecutionPolicy, typename Array>
+inline auto _reduce_all(ExecutionPolicy&& policy, const Array& src)
+{
+    if constexpr (_is_reduce_splittable_v<Array>)
+    {
+        const size_t dim_0    = src.template dimension<0>();
+        const size_t rows     = _parallel_grain<_reduce_elem_t<Array>>(_row_size(src));
+        const size_t n_chunks = (dim_0 + rows - 1) / rows;
+        if (n_chunks > 1)
+        {
+            std::vector<Reducer> partials(n_chunks);
+            parallel_for(policy, n_chunks, 1, [&](size_t first, size_t last)
+            {
+                for (size_t c = first; c < last; ++c)
+                    partials[c] = _reduce_all_seq<Reducer>(
+                        src.vpart(span(c * rows, std::min((c + 1) * rows, dim_0))));
+            });
+            for (size_t width = 1; width < n_chunks; width *= 2)
+                for (size_t c = 0; c + width < n_chunks; c += 2 * width)
+                    partials[c].merge(partials[c + width]);
+            return partials[0].result();
+        }
+    }
+    return _reduce_all_seq<Reducer>(src).result();
+}
+
+// reduce Level of src into the contiguous elements at dst
+template<size_t Level, typename Reducer, typename View>
+inline void _reduce_level_into(typename Reducer::_result_t* dst, const View& src)
+{
+    if constexpr (Level > 0)
+    {
+        // each sub-view along level 0 gives the elements of dst in a row
+        const auto dims = src.dimensions();
+        size_t row_size = 1;
+        for (size_t i = 1; i < dims.size(); ++i)
+            if (i != Level)
+                row_size *= dims[i];
+        for (size_t i = 0; i < dims[0]; ++i)
+            _reduce_level_into<Level - 1, Reducer>(dst + i * row_size, src.vpart(i));
+    }
+    else if constexpr (array_depth_of_v<View> == 1)
+    {
+        *dst = _reduce_all_seq<Reducer>(src).result();
+    }
+    else
+    {
+        Reducer::reduce_rows(dst, src);
+    }
+}
+
+// reduce Level of an array object into an array
+template<size_t Level, typename Reducer, typename ExecutionPolicy, typename Array>
+inline auto _reduce_level(ExecutionPolicy&& policy, const Array& src)
+{
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    static_assert(depth_v > 1, "use the reduction over all elements for one-level arrays.");
+    static_assert(Level < depth_v, "the level to reduce is out of range.");
+    using result_t = typename Reducer::_result_t;
+
+    if constexpr (!_is_reduce_splittable_v<Array>)
+    {
+        return _reduce_level<Level, Reducer>(std::forward<ExecutionPolicy>(policy), make_array(src));
+    }
+    else
+    {
+        const auto src_dims = src.dimensions();
+        std::array<size_t, depth_v - 1> dims{};
+        for (size_t i = 0, j = 0; i < depth_v; ++i)
+            if (i != Level)
+                dims[j++] = src_dims[i];
+        array<result_t, depth_v - 1> ret(default_init, dims);
+
+        // split along level 0 of the result, i.e. level 0 of src, or level 1
+        // when reducing level 0
+        constexpr size_t split_level_v = Level == 0 ? 1 : 0;
+        const size_t n_split = src_dims[split_level_v];
+        const size_t step    = n_split == 0 ? 0 : ret.size() / n_split;
+        result_t*    dst     = ret.data();
+        parallel_for(policy, n_split, _parallel_grain<_reduce_elem_t<Array>>(src.size() / std::max(n_split, size_t(1))),
+            [&](size_t first, size_t last)
+        {
+            if constexpr (split_level_v == 0)
+                _reduce_level_into<Level, Reducer>(dst + first * step, src.vpart(span(first, last)));
+            else
+                _reduce_level_into<Level, Reducer>(dst + first * step, src.vpart(span(), span(first, last)));
+        });
+        return ret;
+    }
+}
+
+template<size_t Level, typename Reducer, typename ExecutionPolicy, typename Array>
+inline auto _reduce(ExecutionPolicy&& policy, const Array& src)
+{
+    if constexpr (Level == _reduce_all_v)
+        return _reduce_all<Reducer>(std::forward<ExecutionPolicy>(policy), src);
+    else
+        return _reduce_level<Level, Reducer>(std::forward<ExecutionPolicy>(policy), src);
+}
+
+
+// sum of all elements, or along Level
+template<size_t Level = _reduce_all_v, typename ExecutionPolicy, typename Array,
+         typename Summation = pairwise_summation_t,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0, _enable_if_summation_t<Summation> = 0>
+inline auto sum(ExecutionPolicy&& policy, const Array& src, Summation = Summation{})
+{
+    using result_t = _sum_result_t<_reduce_elem_t<Array>>;
+    return _reduce<Level, _sum_reducer_t<result_t, Summation>>(policy, src);
+}
+
+template<size_t Level = _reduce_all_v, typename Array, typename Summation = pairwise_summation_t,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0, _enable_if_summation_t<Summation> = 0>
+inline auto sum(const Array& src, Summation summation = Summation{})
+{
+    return sum<Level>(seq, src, summation);
+}
+
+// product of all elements, or along Level
+template<size_t Level = _reduce_all_v, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto prod(ExecutionPolicy&& policy, const Array& src)
+{
+    using result_t = _sum_result_t<_reduce_elem_t<Array>>;
+    return _reduce<Level, _op_reducer<result_t, _prod_op>>(policy, src);
+}
+
+template<size_t Level = _reduce_all_v, typename Array,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto prod(const Array& src)
+{
+    return prod<Level>(seq, src);
+}
+
+// least element, or least elements along Level
+template<size_t Level = _reduce_all_v, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto min(ExecutionPolicy&& policy, const Array& src)
+{
+    using result_t = _reduce_elem_t<Array>;
+    return _reduce<Level, _op_reducer<result_t, _min_op>>(policy, src);
+}
+
+template<size_t Level = _reduce_all_v, typename Array,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto min(const Array& src)
+{
+    return min<Level>(seq, src);
+}
+
+// greatest element, or greatest elements along Level
+template<size_t Level = _reduce_all_v, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto max(ExecutionPolicy&& policy, const Array& src)
+{
+    using result_t = _reduce_elem_t<Array>;
+    return _reduce<Level, _op_reducer<result_t, _max_op>>(policy, src);
+}
+
+template<size_t Level = _reduce_all_v, typename Array,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto max(const Array& src)
+{
+    return max<Level>(seq, src);
+}
+
+// mean of all elements, or along Level
+template<size_t Level = _reduce_all_v, typename ExecutionPolicy, typename Array,
+         typename Summation = pairwise_summation_t,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0, _enable_if_summation_t<Summation> = 0>
+inline auto mean(ExecutionPolicy&& policy, const Array& src, Summation = Summation{})
+{
+    using result_t = _mean_result_t<_reduce_elem_t<Array>>;
+    auto ret = _reduce<Level, _sum_reducer_t<result_t, Summation>>(policy, src);
+    if constexpr (Level == _reduce_all_v)
+    {
+        return ret / result_t(src.size());
+    }
+    else
+    {
+        const result_t count = result_t(dimensions(src)[Level]);
+        for (size_t i = 0; i < ret.size(); ++i)
+            ret[i] /= count;
+        return ret;
+    }
+}
+
+template<size_t Level = _reduce_all_v, typename Array, typename Summation = pairwise_summation_t,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0, _enable_if_summation_t<Summation> = 0>
+inline auto mean(const Array& src, Summation summation = Summation{})
+{
+    return mean<Level>(seq, src, summation);
+}
+
+}
+
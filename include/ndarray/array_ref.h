@@ -0,0 +1,406 @@
+#pragma once
+
+#include <array>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "decls.h"
+#include "traits.h"
+#include "array_view.h"
+#include "array_copy.h"
+
+namespace ndarray
+{
+
+//
+// array_ref<T, Depth> refers to Depth-dimensional contiguous elements that
+// it does not own, laid out as in an array. It is a simple view with its
+// own dimensions, so the dimensions need not match those of the storage,
+// e.g. vreshape() returns an array_ref over the elements of an array.
+//
+// make_array_ref() wraps an external buffer (or the elements of a vector
+// or an array) without copying, e.g. make_array_ref(ptr, 3, 4). Copies
+// between array_refs and views that share elements are detected by
+// data_copy() from the addresses of the elements.
+//
+// Like an array, views derived from an array_ref refer to its dimensions,
+// so the array_ref must outlive them. The constness of elements follows T.
+//
+
+template<typename T, size_t Depth>
+class array_ref
+{
+public:
+    using _my_type         = array_ref;
+    using _elem_t          = T;
+    using _no_const_elem_t = std::remove_const_t<_elem_t>;
+    static constexpr size_t _depth_v    = Depth;
+    static constexpr bool   _is_const_v = std::is_const_v<_elem_t>;
+    using _dims_t          = std::array<size_t, _depth_v>;
+    using _indexers_t      = n_all_indexer_tuple_t<_depth_v>;
+    static_assert(_depth_v > 0);
+
+public:
+    _elem_t* data_{};
+    _dims_t  dims_{};
+
+public:
+    array_ref(_elem_t* data, _dims_t dims) :
+        data_{data}, dims_{dims} {}
+
+    array_ref(const array_ref&) = default;
+
+    // array_ref<const T> from array_ref<T>
+    template<typename U, typename = std::enable_if_t<std::is_same_v<const U, _elem_t>>>
+    array_ref(const array_ref<U, Depth>& other) :
+        data_{other.data_}, dims_{other.dims_} {}
+
+    // copy data from another view, assuming identical dimensions
+    template<typename View>
+    _my_type& operator=(const View& other)
+    {
+        data_copy(other, *this);
+        return *this;
+    }
+
+    _my_type& operator=(const array_ref& other)
+    {
+        data_copy(other, *this);
+        return *this;
+    }
+
+    // total size of the array
+    size_t size() const
+    {
+        return _total_size_impl();
+    }
+
+    // dimension of the array on the i-th level
+    template<size_t I>
+    size_t dimension() const
+    {
+        static_assert(I < _depth_v);
+        return dims_[I];
+    }
+
+    // array of dimensions
+    _dims_t dimensions() const
+    {
+        return dims_;
+    }
+
+    const size_t* _dims_data() const
+    {
+        return dims_.data();
+    }
+
+    const size_t* _identifier_ptr() const
+    {
+        return _dims_data();
+    }
+
+    // automatically calls at() or part(), depending on its arguments
+    template<typename... Anys>
+    deduce_part_or_elem_type_t<_elem_t, _elem_t, _depth_v, _indexers_t, std::tuple<Anys...>>
+        operator()(Anys&&... anys) const &&
+    {
+        constexpr bool is_complete_index = sizeof...(Anys) == _depth_v && is_all_ints_v<Anys...>;
+        if constexpr (is_complete_index)
+            return this->at(std::forward<decltype(anys)>(anys)...);
+        else
+            return this->part(std::forward<decltype(anys)>(anys)...);
+    }
+
+    // automatically calls at() or vpart(), depending on its arguments
+    template<typename... Anys>
+    deduce_array_view_or_elem_type_t<_elem_t&, _elem_t, _depth_v, _indexers_t, std::tuple<Anys...>>
+        operator()(Anys&&... anys) const &
+    {
+        constexpr bool is_complete_index = sizeof...(Anys) == _depth_v && is_all_ints_v<Anys...>;
+        if constexpr (is_complete_index)
+            return this->at(std::forward<decltype(anys)>(anys)...);
+        else
+            return this->vpart(std::forward<decltype(anys)>(anys)...);
+    }
+
+    // indexing with a tuple/array of integers
+    template<typename Tuple>
+    _elem_t& tuple_at(const Tuple& indices) const
+    {
+        static_assert(std::tuple_size_v<Tuple> == _depth_v, "incorrect number of indices");
+        return _linear_at(_get_position(indices));
+    }
+
+    // indexing with multiple integers
+    template<typename... Ints>
+    _elem_t& at(Ints... ints) const
+    {
+        return this->tuple_at(std::make_tuple(ints...));
+    }
+
+    // linear accessing
+    _elem_t& operator[](size_t pos) const
+    {
+        return data_[pos];
+    }
+
+    _elem_t* data() const
+    {
+        return data_;
+    }
+
+    // pointer to the first element, as in simple_view
+    _elem_t* base_ptr() const
+    {
+        return data_;
+    }
+
+    ptrdiff_t stride() const noexcept
+    {
+        return 1;
+    }
+
+    simple_elem_iter<_elem_t> element_begin() const
+    {
+        return {data()};
+    }
+    simple_elem_iter<_elem_t> element_end() const
+    {
+        return {data() + size()};
+    }
+    simple_elem_const_iter<_elem_t> element_cbegin() const
+    {
+        return {data()};
+    }
+    simple_elem_const_iter<_elem_t> element_cend() const
+    {
+        return {data() + size()};
+    }
+
+    template<bool IsExplicitConst, size_t Level>
+    auto _begin_impl() const &
+    {
+        static_assert(0 < Level && Level <= _depth_v);
+        if constexpr (Level == _depth_v)
+        {
+            return this->element_begin();
+        }
+        else
+        {
+            size_t ptr_stride = this->template _total_size_impl<_depth_v, Level>();
+            auto   sub_view   = this->tuple_vpart(repeat_tuple_t<Level, size_t>{});
+            return regular_view_iter<decltype(sub_view), IsExplicitConst>{std::move(sub_view), ptr_stride};
+        }
+    }
+    template<bool IsExplicitConst, size_t Level>
+    auto _end_impl() const &
+    {
+        static_assert(0 < Level && Level <= _depth_v);
+        if constexpr (Level == _depth_v)
+        {
+            return this->element_end();
+        }
+        else
+        {
+            auto iter = this->template _begin_impl<IsExplicitConst, Level>();
+            iter.my_base_ptr_ref() += size();
+            return iter;
+        }
+    }
+
+    template<size_t Level = 1>
+    auto begin() const &
+    {
+        return _begin_impl<false, Level>();
+    }
+    template<size_t Level = 1>
+    auto end() const &
+    {
+        return _end_impl<false, Level>();
+    }
+    template<size_t Level = 1>
+    auto cbegin() const &
+    {
+        return _begin_impl<true, Level>();
+    }
+    template<size_t Level = 1>
+    auto cend() const &
+    {
+        return _end_impl<true, Level>();
+    }
+
+    template<typename SpanTuple>
+    deduce_array_view_type_t<_elem_t, _indexers_t, SpanTuple>
+        tuple_vpart(SpanTuple&& spans) const &&
+    {
+        static_assert(_always_false_v<SpanTuple>, "cannot call tuple_vpart() on an r-value array_ref.");
+    }
+
+    template<typename SpanTuple>
+    deduce_array_view_type_t<_elem_t, _indexers_t, SpanTuple>
+        tuple_vpart(SpanTuple&& spans) const &
+    {
+        return get_collapsed_view(
+            data(), dims_.data(), _indexers_t{}, std::forward<decltype(spans)>(spans));
+    }
+
+    template<typename... Spans>
+    deduce_array_view_type_t<_elem_t, _indexers_t, std::tuple<Spans...>>
+        vpart(Spans&&... spans) const &&
+    {
+        static_assert(_always_false_v<Spans...>, "cannot call vpart() on an r-value array_ref.");
+    }
+
+    template<typename... Spans>
+    deduce_array_view_type_t<_elem_t, _indexers_t, std::tuple<Spans...>>
+        vpart(Spans&&... spans) const &
+    {
+        return this->tuple_vpart(std::forward_as_tuple(spans...));
+    }
+
+    template<typename SpanTuple>
+    deduce_part_array_type_t<_elem_t, _indexers_t, SpanTuple>
+        tuple_part(SpanTuple&& spans) const
+    {
+        auto view = get_collapsed_view(
+            data(), dims_.data(), _indexers_t{}, std::forward<decltype(spans)>(spans));
+        return make_array(view);
+    }
+
+    template<typename... Spans>
+    deduce_part_array_type_t<_elem_t, _indexers_t, std::tuple<Spans...>>
+        part(Spans&&... spans) const
+    {
+        return this->tuple_part(std::forward_as_tuple(spans...));
+    }
+
+    // check whether having same dimensions with another array, starting at specific levels
+    template<size_t MyStartLevel = 0, size_t OtherStartLevel = 0, typename OtherArray>
+    bool check_size_with(const OtherArray& other) const
+    {
+        if constexpr (MyStartLevel == _depth_v || OtherStartLevel == OtherArray::_depth_v)
+            return false;
+        else if constexpr (MyStartLevel == _depth_v - 1 && OtherStartLevel == OtherArray::_depth_v - 1)
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>();
+        else
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>() &&
+            check_size_with<MyStartLevel + 1, OtherStartLevel + 1>(other);
+    }
+
+    // copy data to destination given size as hint, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst, size_t size) const
+    {
+        _strided_copy_to(this->data(), 1, dst, size);
+    }
+
+    // copy data to destination, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst) const
+    {
+        this->copy_to(dst, this->size());
+    }
+
+    // copy data from source given size as hint, assuming no aliasing
+    template<typename Iter>
+    void copy_from(Iter src, size_t size) const
+    {
+        static_assert(!_is_const_v);
+        _strided_copy_from(src, this->data(), 1, size);
+    }
+
+    // copy data from source, assuming no aliasing
+    template<typename Iter>
+    void copy_from(Iter src) const
+    {
+        this->copy_from(src, this->size());
+    }
+
+public:
+
+    template<size_t LastLevel = _depth_v, size_t FirstLevel = 0>
+    size_t _total_size_impl() const
+    {
+        static_assert(FirstLevel <= LastLevel && LastLevel <= _depth_v);
+        if constexpr (FirstLevel == LastLevel)
+            return size_t(1);
+        else
+            return dimension<LastLevel - 1>() * _total_size_impl<LastLevel - 1, FirstLevel>();
+    }
+
+    _elem_t& _linear_at(size_t pos) const
+    {
+        NDARRAY_ASSERT(pos < size());
+        return data_[pos];
+    }
+
+    template<size_t I = _depth_v - size_t(1), typename Tuple>
+    size_t _get_position(const Tuple& tuple) const
+    {
+        size_t dim_i = dimension<I>();
+        size_t pos_i = _add_if_negative<size_t>(std::get<I>(tuple), dim_i);
+        NDARRAY_ASSERT(pos_i < dim_i);
+        if constexpr (I == 0)
+            return pos_i;
+        else
+            return pos_i + dim_i * _get_position<I - 1>(tuple);
+    }
+
+};
+
+
+// create array from array_ref
+template<typename T, size_t Depth>
+inline auto make_array(const array_ref<T, Depth>& ref)
+{
+    return array<std::remove_const_t<T>, Depth>(ref);
+}
+
+// refer to the elements of an external buffer with given dimensions
+template<typename T, typename... Ints, typename = std::enable_if_t<is_all_ints_v<Ints...>>>
+inline array_ref<T, sizeof...(Ints)> make_array_ref(T* data, Ints... dims)
+{
+    return {data, {size_t(dims)...}};
+}
+
+template<typename T, size_t Depth>
+inline array_ref<T, Depth> make_array_ref(T* data, const std::array<size_t, Depth>& dims)
+{
+    return {data, dims};
+}
+
+// refer to the elements of a vector, which must not be resized meanwhile
+template<typename T, typename Alloc>
+inline array_ref<T, 1> make_array_ref(std::vector<T, Alloc>& vec)
+{
+    return {vec.data(), {vec.size()}};
+}
+
+template<typename T, typename Alloc>
+inline array_ref<const T, 1> make_array_ref(const std::vector<T, Alloc>& vec)
+{
+    return {vec.data(), {vec.size()}};
+}
+
+template<typename T, typename Alloc>
+void make_array_ref(std::vector<T, Alloc>&&) = delete;
+
+// refer to the elements of an array, with its dimensions copied
+template<typename T, size_t Depth, typename Alloc>
+inline array_ref<T, Depth> make_array_ref(array<T, Depth, Alloc>& arr)
+{
+    return {arr.data(), arr.dimensions()};
+}
+
+template<typename T, size_t Depth, typename Alloc>
+inline array_ref<const T, Depth> make_array_ref(const array<T, Depth, Alloc>& arr)
+{
+    return {arr.data(), arr.dimensions()};
+}
+
+template<typename T, size_t Depth, typename Alloc>
+void make_array_ref(array<T, Depth, Alloc>&&) = delete;
+
+}
+
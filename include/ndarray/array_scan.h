@@ -0,0 +1,391 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include "array.h"
+#include "array_interface.h"
+#include "array_reduction.h"
+#include "execution.h"
+
+namespace ndarray
+{
+
+//
+// Scans give the running combinations of the elements of an array object,
+// either of all elements in order, as a one-level array, or along one
+// level, with the dimensions of the source.
+//
+//  function                     element i of the result
+//---------------------------------------------------------------------
+//  cumsum(a), cumprod(a)        a[0] + ... + a[i], a[0] * ... * a[i]
+//  cummin(a), cummax(a)         least/greatest of a[0], ..., a[i]
+//  inclusive_scan(a, op)        op(...op(op(a[0], a[1]), a[2])..., a[i])
+//  exclusive_scan(a, init, op)  init combined with a[0], ..., a[i - 1],
+//                               so element 0 is init
+//
+// cumsum<Level>(a) etc. scan along one level, e.g. cumsum<1>(a) of a 3x4
+// array gives the running sums of each row. All of them take an execution
+// policy as the optional first argument. op must be associative, and is
+// called with two values of its result type, which is the type of init
+// for exclusive scans. Sums and products of small integers are promoted
+// as by the + operator.
+//
+// Elements are read as runs of strided pointers as in reductions. A
+// parallel scan of all elements first combines chunks along level 0, and
+// then scans each chunk starting from the combination of the chunks before
+// it. The chunks have a fixed number of elements, so the results of
+// parallel scans do not depend on the number of threads. Scans along a level other than the last advance the running values
+// of a whole sub-view at once; they are independent lanes, so the inner
+// loop can be vectorized. Parallel policies split the work along level 0
+// (level 1 when scanning level 0).
+//
+
+// Level argument of scans over all elements
+constexpr size_t _scan_all_v = size_t(-1);
+
+
+// scans runs of elements into consecutive outputs, carrying the running
+// value from one run to the next; an inclusive scan that has not started
+// takes its first element as the running value
+template<typename R, typename Op, bool IsExclusive>
+struct _run_scanner
+{
+    Op   op_;
+    R    carry_;
+    bool started_;
+    R*   out_;
+
+    template<typename S>
+    void operator()(const S* ptr, ptrdiff_t stride, size_t len)
+    {
+        size_t i = 0;
+        if (!IsExclusive && !started_ && len > 0)
+        {
+            carry_   = R(ptr[0]);
+            out_[0]  = carry_;
+            started_ = true;
+            i = 1;
+        }
+        R  carry = carry_;
+        R* out   = out_;
+        for (; i < len; ++i)
+        {
+            if constexpr (IsExclusive)
+            {
+                out[i] = carry;
+                carry  = op_(carry, R(ptr[ptrdiff_t(i) * stride]));
+            }
+            else
+            {
+                carry  = op_(carry, R(ptr[ptrdiff_t(i) * stride]));
+                out[i] = carry;
+            }
+        }
+        carry_ = carry;
+        out_  += len;
+    }
+};
+
+// combines runs of elements in order, starting from the first element
+template<typename R, typename Op>
+struct _run_folder
+{
+    Op   op_;
+    R    value_;
+    bool started_;
+
+    template<typename S>
+    void operator()(const S* ptr, ptrdiff_t stride, size_t len)
+    {
+        size_t i = 0;
+        if (!started_ && len > 0)
+        {
+            value_   = R(ptr[0]);
+            started_ = true;
+            i = 1;
+        }
+        R value = value_;
+        for (; i < len; ++i)
+            value = op_(value, R(ptr[ptrdiff_t(i) * stride]));
+        value_ = value;
+    }
+};
+
+// out_row[i] = op(prev_row[i], i-th element of src) for all elements of
+// src, or the element itself if prev_row is null
+template<typename Op, typename R, typename Array>
+inline void _scan_lanes(Op op, R* out_row, const R* prev_row, const Array& src)
+{
+    _for_each_run(src, [op, &out_row, &prev_row](const auto* ptr, ptrdiff_t stride, size_t len)
+    {
+        R* const       out  = out_row;
+        const R* const prev = prev_row;
+        if (prev == nullptr)
+        {
+            for (size_t i = 0; i < len; ++i)
+                out[i] = R(ptr[ptrdiff_t(i) * stride]);
+        }
+        else
+        {
+            if (stride == 1)
+                for (size_t i = 0; i < len; ++i)
+                    out[i] = op(prev[i], R(ptr[i]));
+            else
+                for (size_t i = 0; i < len; ++i)
+                    out[i] = op(prev[i], R(ptr[ptrdiff_t(i) * stride]));
+            prev_row += len;
+        }
+        out_row += len;
+    });
+}
+
+
+// scan all elements of an array object into a one-level array
+template<bool IsExclusive, typename R, typename ExecutionPolicy, typename Op, typename Array>
+inline auto _scan_all(ExecutionPolicy&& policy, const Array& src, Op op, R init)
+{
+    const size_t size = src.size();
+    array<R, 1>  ret(default_init, {size});
+    R* const     out = ret.data();
+
+    if constexpr (_is_parallel_policy_v<ExecutionPolicy> && _is_reduce_splittable_v<Array>)
+    {
+        const size_t dim_0    = src.template dimension<0>();
+        const size_t row_size = _row_size(src);
+        const size_t rows     = _parallel_grain<_reduce_elem_t<Array>>(row_size);
+        const size_t n_chunks = (dim_0 + rows - 1) / rows;
+        if (n_chunks > 1)
+        {
+            auto chunk_first = [=](size_t c) { return std::min(c * rows, dim_0); };
+            auto chunk_of    = [&](size_t c) { return src.vpart(span(chunk_first(c), chunk_first(c + 1))); };
+
+            // combine each chunk but the last, then the running values
+            // that the chunks start from
+            std::vector<R> carries(n_chunks, init);
+            parallel_for(policy, n_chunks - 1, 1, [&](size_t first, size_t last)
+            {
+                for (size_t c = first; c < last; ++c)
+                {
+                    _run_folder<R, Op> folder{op, R{}, false};
+                    _for_each_run(chunk_of(c), folder);
+                    carries[c + 1] = folder.value_;
+                }
+            });
+            for (size_t c = IsExclusive ? 1 : 2; c < n_chunks; ++c)
+                carries[c] = op(carries[c - 1], carries[c]);
+
+            parallel_for(policy, n_chunks, 1, [&](size_t first, size_t last)
+            {
+                for (size_t c = first; c < last; ++c)
+                {
+                    _run_scanner<R, Op, IsExclusive> scanner{op, carries[c], IsExclusive || c > 0,
+                                                             out + chunk_first(c) * row_size};
+                    _for_each_run(chunk_of(c), scanner);
+                }
+            });
+            return ret;
+        }
+    }
+    _run_scanner<R, Op, IsExclusive> scanner{op, init, IsExclusive, out};
+    _for_each_run(src, scanner);
+    return ret;
+}
+
+// scan level 0 of src into its rows at dst, dst + row_stride, ...
+template<bool IsExclusive, typename R, typename Op, typename View>
+inline void _scan_rows(R* dst, size_t row_stride, const View& src, Op op, R init)
+{
+    if constexpr (array_depth_of_v<View> == 1)
+    {
+        _run_scanner<R, Op, IsExclusive> scanner{op, init, IsExclusive, dst};
+        _for_each_run(src, scanner);
+    }
+    else
+    {
+        const size_t n = src.template dimension<0>();
+        if (n == 0)
+            return;
+        if constexpr (IsExclusive)
+        {
+            std::fill_n(dst, _row_size(src), init);
+            for (size_t k = 1; k < n; ++k)
+                _scan_lanes(op, dst + k * row_stride, dst + (k - 1) * row_stride, src.vpart(k - 1));
+        }
+        else
+        {
+            _scan_lanes(op, dst, static_cast<const R*>(nullptr), src.vpart(0));
+            for (size_t k = 1; k < n; ++k)
+                _scan_lanes(op, dst + k * row_stride, dst + (k - 1) * row_stride, src.vpart(k));
+        }
+    }
+}
+
+// scan Level of src into the contiguous elements at dst
+template<size_t Level, bool IsExclusive, typename R, typename Op, typename View>
+inline void _scan_level_into(R* dst, const View& src, Op op, R init)
+{
+    const size_t row_size = _row_size(src);
+    if constexpr (Level > 0)
+    {
+        const size_t n = src.template dimension<0>();
+        for (size_t i = 0; i < n; ++i)
+            _scan_level_into<Level - 1, IsExclusive>(dst + i * row_size, src.vpart(i), op, init);
+    }
+    else
+    {
+        _scan_rows<IsExclusive>(dst, row_size, src, op, init);
+    }
+}
+
+// scan Level of an array object into an array of the same dimensions
+template<size_t Level, bool IsExclusive, typename R, typename ExecutionPolicy, typename Op, typename Array>
+inline auto _scan_level(ExecutionPolicy&& policy, const Array& src, Op op, R init)
+{
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    static_assert(Level < depth_v, "the level to scan is out of range.");
+
+    if constexpr (depth_v == 1)
+    {
+        return _scan_all<IsExclusive>(std::forward<ExecutionPolicy>(policy), src, op, init);
+    }
+    else if constexpr (!_is_reduce_splittable_v<Array>)
+    {
+        return _scan_level<Level, IsExclusive>(std::forward<ExecutionPolicy>(policy), make_array(src), op, init);
+    }
+    else
+    {
+        const auto dims = src.dimensions();
+        array<R, depth_v> ret(default_init, dims);
+        if (ret.size() == 0)
+            return ret;
+
+        // split along level 0, or level 1 when scanning level 0, where each
+        // part is a range of columns of the rows of the result
+        constexpr size_t split_level_v = Level == 0 ? 1 : 0;
+        const size_t n_split    = dims[split_level_v];
+        const size_t row_stride = ret.size() / dims[0];
+        const size_t step       = Level == 0 ? row_stride / n_split : row_stride;
+        R*           dst        = ret.data();
+        parallel_for(policy, n_split, _parallel_grain<_reduce_elem_t<Array>>(src.size() / n_split),
+            [&](size_t first, size_t last)
+        {
+            if constexpr (split_level_v == 0)
+                _scan_level_into<Level, IsExclusive>(dst + first * step, src.vpart(span(first, last)), op, init);
+            else
+                _scan_rows<IsExclusive>(dst + first * step, row_stride, src.vpart(span(), span(first, last)), op, init);
+        });
+        return ret;
+    }
+}
+
+template<size_t Level, bool IsExclusive, typename R, typename ExecutionPolicy, typename Op, typename Array>
+inline auto _scan(ExecutionPolicy&& policy, const Array& src, Op op, R init)
+{
+    if constexpr (Level == _scan_all_v)
+        return _scan_all<IsExclusive>(std::forward<ExecutionPolicy>(policy), src, op, init);
+    else
+        return _scan_level<Level, IsExclusive>(std::forward<ExecutionPolicy>(policy), src, op, init);
+}
+
+
+// running combinations by op of all elements, or along Level
+template<size_t Level = _scan_all_v, typename ExecutionPolicy, typename Array, typename Op,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto inclusive_scan(ExecutionPolicy&& policy, const Array& src, Op op)
+{
+    using elem_t   = _reduce_elem_t<Array>;
+    using result_t = remove_cvref_t<std::invoke_result_t<Op&, elem_t, elem_t>>;
+    return _scan<Level, false>(policy, src, op, result_t{});
+}
+
+template<size_t Level = _scan_all_v, typename Array, typename Op,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto inclusive_scan(const Array& src, Op op)
+{
+    return inclusive_scan<Level>(seq, src, op);
+}
+
+// running combinations by op of init and the elements before each one, of
+// all elements or along Level
+template<size_t Level = _scan_all_v, typename ExecutionPolicy, typename Array, typename T, typename Op,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto exclusive_scan(ExecutionPolicy&& policy, const Array& src, T init, Op op)
+{
+    return _scan<Level, true>(policy, src, op, init);
+}
+
+template<size_t Level = _scan_all_v, typename Array, typename T, typename Op,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto exclusive_scan(const Array& src, T init, Op op)
+{
+    return exclusive_scan<Level>(seq, src, init, op);
+}
+
+// running sums of all elements, or along Level
+template<size_t Level = _scan_all_v, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto cumsum(ExecutionPolicy&& policy, const Array& src)
+{
+    using result_t = _sum_result_t<_reduce_elem_t<Array>>;
+    return _scan<Level, false>(policy, src, _sum_op{}, result_t{});
+}
+
+template<size_t Level = _scan_all_v, typename Array,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto cumsum(const Array& src)
+{
+    return cumsum<Level>(seq, src);
+}
+
+// running products of all elements, or along Level
+template<size_t Level = _scan_all_v, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto cumprod(ExecutionPolicy&& policy, const Array& src)
+{
+    using result_t = _sum_result_t<_reduce_elem_t<Array>>;
+    return _scan<Level, false>(policy, src, _prod_op{}, result_t{});
+}
+
+template<size_t Level = _scan_all_v, typename Array,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto cumprod(const Array& src)
+{
+    return cumprod<Level>(seq, src);
+}
+
+// running least elements of all elements, or along Level
+template<size_t Level = _scan_all_v, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto cummin(ExecutionPolicy&& policy, const Array& src)
+{
+    using result_t = _reduce_elem_t<Array>;
+    return _scan<Level, false>(policy, src, _min_op{}, result_t{});
+}
+
+template<size_t Level = _scan_all_v, typename Array,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto cummin(const Array& src)
+{
+    return cummin<Level>(seq, src);
+}
+
+// running greatest elements of all elements, or along Level
+template<size_t Level = _scan_all_v, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto cummax(ExecutionPolicy&& policy, const Array& src)
+{
+    using result_t = _reduce_elem_t<Array>;
+    return _scan<Level, false>(policy, src, _max_op{}, result_t{});
+}
+
+template<size_t Level = _scan_all_v, typename Array,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto cummax(const Array& src)
+{
+    return cummax<Level>(seq, src);
+}
+
+}
@@ -0,0 +1,622 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "array.h"
+#include "array_interface.h"
+#include "execution.h"
+
+namespace ndarray
+{
+
+//
+// Sorting functions order the elements of each line of an array object
+// along one level, which is the last level by default, and return a new
+// array:
+//
+//  function                  result
+//---------------------------------------------------------------------
+//  sort(a)                   a with each line sorted
+//  argsort(a)                positions that sort each line, stably, as a
+//                            std::vector<size_t> for one-level objects
+//                            and an array<size_t, Depth> otherwise
+//  nth_element(a, n)         a with element n of each line being the one
+//                            there if sorted, smaller ones before it and
+//                            greater ones after it
+//  topk(a, k)                the k greatest elements of each line, in
+//                            descending order
+//
+// sort<Level>(a) etc. work along another level. All of them take an
+// execution policy as the optional first argument, and a comparison as
+// the optional last argument, which is std::less<>, or std::greater<> for
+// topk(). The result of argsort() of a one-level object is directly usable
+// as an irregular span, e.g. a.vpart(span(argsort(a))) gives a sorted view.
+//
+// Arithmetic elements compared by std::less<> or std::greater<> are sorted
+// by radix in long lines. In lines of up to _small_sort_v elements, e.g.
+// the rows of a [1000000, 32] array, they are sorted by a merge network
+// applied to a batch of lines at once, so that each comparison becomes a
+// vector operation across the lines. Other lines are sorted by insertion
+// if short, and by std::sort() otherwise. Parallel policies sort lines in
+// parallel, or, when there are fewer lines than threads, sort chunks of
+// each line in parallel and merge them pairwise, with each merge split
+// into as many parts as the chunks it covers.
+//
+
+// Level argument of sorting functions along the last level
+constexpr size_t _sort_last_v = size_t(-1);
+
+// number of elements sorted by insertion, or by a merge network in
+// batches of _sort_batch_v lines
+constexpr size_t _small_sort_log2_v = 5;
+constexpr size_t _small_sort_v      = size_t(1) << _small_sort_log2_v;
+constexpr size_t _sort_batch_v      = 16;
+
+// least number of elements sorted by radix
+constexpr size_t _radix_sort_min_v = 1024;
+
+
+template<size_t Level, typename Array>
+constexpr size_t _sort_level_v = Level == _sort_last_v ? array_depth_of_v<Array> - 1 : Level;
+
+// position of the first element of line l of an array, whose lines have
+// len elements that are stride apart
+inline size_t _line_offset(size_t l, size_t len, size_t stride)
+{
+    return l / stride * len * stride + l % stride;
+}
+
+// distance between adjacent elements along Level
+template<size_t Level, size_t Depth>
+inline size_t _line_stride(const std::array<size_t, Depth>& dims)
+{
+    size_t stride = 1;
+    for (size_t i = Level + 1; i < Depth; ++i)
+        stride *= dims[i];
+    return stride;
+}
+
+// orders (key, position) pairs by comp of the keys, and by the positions
+// among equivalent keys, which makes sorting them stable
+template<typename Compare>
+struct _index_compare
+{
+    Compare comp_;
+
+    template<typename K>
+    bool operator()(const std::pair<K, size_t>& a, const std::pair<K, size_t>& b) const
+    {
+        return comp_(a.first, b.first) || (!comp_(b.first, a.first) && a.second < b.second);
+    }
+};
+
+// 1 for comparisons giving ascending order by radix, -1 for descending,
+// and 0 for those that radix sort cannot follow
+template<typename Compare>
+constexpr int _radix_order_v = 0;
+template<typename T>
+constexpr int _radix_order_v<std::less<T>> = 1;
+template<typename T>
+constexpr int _radix_order_v<std::greater<T>> = -1;
+template<typename Compare>
+constexpr int _radix_order_v<_index_compare<Compare>> = _radix_order_v<Compare>;
+
+template<typename T>
+constexpr bool _is_radix_key_v =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+    (std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+// the key of an item to sort
+template<typename T>
+inline const T& _sort_key(const T& item)
+{
+    return item;
+}
+template<typename K>
+inline const K& _sort_key(const std::pair<K, size_t>& item)
+{
+    return item.first;
+}
+
+// unsigned integer in the same order as the key
+template<typename T>
+inline auto _radix_bits(T key)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        using bits_t = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        constexpr bits_t sign_v = bits_t(1) << (sizeof(bits_t) * 8 - 1);
+        if (key == T(0))
+            key = T(0); // -0.0 is equivalent to 0.0
+        bits_t bits;
+        std::memcpy(&bits, &key, sizeof(T));
+        return (bits & sign_v) != 0 ? bits_t(~bits) : bits_t(bits | sign_v);
+    }
+    else
+    {
+        using bits_t = std::make_unsigned_t<T>;
+        if constexpr (std::is_signed_v<T>)
+            return bits_t(bits_t(key) ^ (bits_t(1) << (sizeof(bits_t) * 8 - 1)));
+        else
+            return bits_t(key);
+    }
+}
+
+// stable LSD radix sort by bytes of the keys, skipping the bytes that all
+// keys share; buffer holds len items
+template<int Order, typename T>
+inline void _radix_sort(T* data, T* buffer, size_t len)
+{
+    auto digits = [](const T& item)
+    {
+        const auto bits = _radix_bits(_sort_key(item));
+        return Order > 0 ? bits : decltype(bits)(~bits);
+    };
+    constexpr size_t passes_v = sizeof(decltype(digits(*data)));
+
+    std::array<std::array<size_t, 256>, passes_v> counts{};
+    for (size_t i = 0; i < len; ++i)
+    {
+        const auto bits = digits(data[i]);
+        for (size_t p = 0; p < passes_v; ++p)
+            ++counts[p][(bits >> (p * 8)) & 0xff];
+    }
+
+    T* src = data;
+    T* dst = buffer;
+    for (size_t p = 0; p < passes_v; ++p)
+    {
+        auto& offsets = counts[p];
+        if (offsets[(digits(src[0]) >> (p * 8)) & 0xff] == len)
+            continue;
+        for (size_t d = 0, offset = 0; d < 256; ++d)
+        {
+            const size_t count = offsets[d];
+            offsets[d] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < len; ++i)
+            dst[offsets[(digits(src[i]) >> (p * 8)) & 0xff]++] = src[i];
+        std::swap(src, dst);
+    }
+    if (src != data)
+        std::copy(src, src + len, data);
+}
+
+template<typename T, typename Compare>
+inline void _insertion_sort(T* first, size_t len, Compare comp)
+{
+    for (size_t i = 1; i < len; ++i)
+    {
+        T item = std::move(first[i]);
+        size_t j = i;
+        for (; j > 0 && comp(item, first[j - 1]); --j)
+            first[j] = std::move(first[j - 1]);
+        first[j] = std::move(item);
+    }
+}
+
+// sort a contiguous run of items
+template<typename T, typename Compare>
+inline void _sort_run(T* first, size_t len, Compare comp)
+{
+    using key_t = remove_cvref_t<decltype(_sort_key(*first))>;
+    if (len <= _small_sort_v)
+    {
+        _insertion_sort(first, len, comp);
+    }
+    else if constexpr (_radix_order_v<Compare> != 0 && _is_radix_key_v<key_t>)
+    {
+        if (len >= _radix_sort_min_v)
+        {
+            _scratch_buffer<T> buffer(len);
+            _radix_sort<_radix_order_v<Compare>>(first, buffer.data(), len);
+        }
+        else
+        {
+            std::sort(first, first + len, comp);
+        }
+    }
+    else
+    {
+        std::sort(first, first + len, comp);
+    }
+}
+
+// comparators (i, j) of Batcher's odd-even merge sort of n items, where n
+// is a power of two
+inline std::vector<std::pair<size_t, size_t>> _merge_network(size_t n)
+{
+    std::vector<std::pair<size_t, size_t>> network;
+    for (size_t p = 1; p < n; p *= 2)
+        for (size_t k = p; k >= 1; k /= 2)
+            for (size_t j = k % p; j + k < n; j += 2 * k)
+                for (size_t i = 0; i < std::min(k, n - j - k); ++i)
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                        network.emplace_back(i + j, i + j + k);
+    return network;
+}
+
+template<typename T, typename Compare>
+constexpr bool _is_network_sortable_v = std::is_arithmetic_v<T> && _radix_order_v<Compare> != 0;
+
+// sort lines [first, last) of up to _small_sort_v elements by a merge
+// network, _sort_batch_v lines at a time, where the lines are the lanes of
+// each comparison and are padded to a power of two by the greatest value
+template<int Order, typename T>
+inline void _network_sort_lines(T* data, size_t first, size_t last, size_t len, size_t stride)
+{
+    static const auto networks = []()
+    {
+        std::array<std::vector<std::pair<size_t, size_t>>, _small_sort_log2_v + 1> ret;
+        for (size_t i = 0; i <= _small_sort_log2_v; ++i)
+            ret[i] = _merge_network(size_t(1) << i);
+        return ret;
+    }();
+    size_t log2_n = 0;
+    while ((size_t(1) << log2_n) < len)
+        ++log2_n;
+    const size_t n       = size_t(1) << log2_n;
+    const auto&  network = networks[log2_n];
+
+    using limits_t = std::numeric_limits<T>;
+    constexpr T greatest_v = limits_t::has_infinity ? limits_t::infinity() : limits_t::max();
+    constexpr T least_v    = limits_t::has_infinity ? -limits_t::infinity() : limits_t::lowest();
+    constexpr T pad_v      = Order > 0 ? greatest_v : least_v;
+
+    T lanes[_small_sort_v][_sort_batch_v];
+    for (size_t l0 = first; l0 < last; l0 += _sort_batch_v)
+    {
+        const size_t batch = std::min(_sort_batch_v, last - l0);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t b = 0; b < _sort_batch_v; ++b)
+                lanes[i][b] = pad_v;
+        for (size_t b = 0; b < batch; ++b)
+        {
+            const T* line = data + _line_offset(l0 + b, len, stride);
+            for (size_t i = 0; i < len; ++i)
+                lanes[i][b] = line[i * stride];
+        }
+        for (const auto& comparator : network)
+        {
+            T* const lo = lanes[comparator.first];
+            T* const hi = lanes[comparator.second];
+            T new_lo[_sort_batch_v];
+            T new_hi[_sort_batch_v];
+            for (size_t b = 0; b < _sort_batch_v; ++b)
+            {
+                const bool swap = Order > 0 ? hi[b] < lo[b] : lo[b] < hi[b];
+                new_lo[b] = swap ? hi[b] : lo[b];
+                new_hi[b] = swap ? lo[b] : hi[b];
+            }
+            std::copy(new_lo, new_lo + _sort_batch_v, lo);
+            std::copy(new_hi, new_hi + _sort_batch_v, hi);
+        }
+        for (size_t b = 0; b < batch; ++b)
+        {
+            T* line = data + _line_offset(l0 + b, len, stride);
+            for (size_t i = 0; i < len; ++i)
+                line[i * stride] = lanes[i][b];
+        }
+    }
+}
+
+// number of items taken from a among the first k items of the stable merge
+// of a and b
+template<typename T, typename Compare>
+inline size_t _merge_split(const T* a, size_t a_len, const T* b, size_t b_len, size_t k, Compare comp)
+{
+    size_t lo = k > b_len ? k - b_len : 0;
+    size_t hi = std::min(k, a_len);
+    while (lo < hi)
+    {
+        const size_t i = lo + (hi - lo) / 2;
+        if (!comp(b[k - i - 1], a[i])) // a[i] goes before b[k - i - 1]
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+// sort a contiguous run of items, by chunks sorted in parallel and merged
+// pairwise under a parallel policy
+template<typename ExecutionPolicy, typename T, typename Compare>
+inline void _parallel_sort_run(ExecutionPolicy&& policy, T* first, size_t len, Compare comp)
+{
+    if constexpr (_is_parallel_policy_v<ExecutionPolicy>)
+    {
+        const size_t n_chunks = std::min(_executor_of(policy).size(), len / _parallel_min_size_v<T>);
+        if (n_chunks > 1)
+        {
+            auto bound = [=](size_t c) { return len * c / n_chunks; };
+            parallel_for(policy, n_chunks, 1, [&](size_t c_first, size_t c_last)
+            {
+                for (size_t c = c_first; c < c_last; ++c)
+                    _sort_run(first + bound(c), bound(c + 1) - bound(c), comp);
+            });
+
+            // each round merges groups of 2 * width chunks, where part c of
+            // the output of a group is made by the thread of chunk c
+            std::vector<T, default_init_allocator<T>> buffer(len);
+            T* src = first;
+            T* dst = buffer.data();
+            for (size_t width = 1; width < n_chunks; width *= 2)
+            {
+                parallel_for(policy, n_chunks, 1, [&](size_t c_first, size_t c_last)
+                {
+                    for (size_t c = c_first; c < c_last; ++c)
+                    {
+                        const size_t c0    = c / (2 * width) * (2 * width);
+                        const size_t c1    = std::min(c0 + width, n_chunks);
+                        const size_t c2    = std::min(c0 + 2 * width, n_chunks);
+                        const T*     a     = src + bound(c0);
+                        const T*     b     = src + bound(c1);
+                        const size_t a_len = bound(c1) - bound(c0);
+                        const size_t b_len = bound(c2) - bound(c1);
+                        const size_t k0    = (a_len + b_len) * (c - c0) / (c2 - c0);
+                        const size_t k1    = (a_len + b_len) * (c - c0 + 1) / (c2 - c0);
+                        const size_t i0    = _merge_split(a, a_len, b, b_len, k0, comp);
+                        const size_t i1    = _merge_split(a, a_len, b, b_len, k1, comp);
+                        std::merge(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), dst + bound(c0) + k0, comp);
+                    }
+                });
+                std::swap(src, dst);
+            }
+            if (src != first)
+            {
+                parallel_for(policy, n_chunks, 1, [&](size_t c_first, size_t c_last)
+                {
+                    std::copy(src + bound(c_first), src + bound(c_last), first + bound(c_first));
+                });
+            }
+            return;
+        }
+    }
+    _sort_run(first, len, comp);
+}
+
+
+// call fn(l, line_policy) for each of n_lines lines of line_size items of
+// type T; lines are processed in parallel under a parallel policy with
+// line_policy being seq, unless there are fewer lines than threads, which
+// are then processed one by one with the policy itself
+template<typename T, typename ExecutionPolicy, typename Function>
+inline void _for_each_line(ExecutionPolicy&& policy, size_t n_lines, size_t line_size, Function fn)
+{
+    if constexpr (_is_parallel_policy_v<ExecutionPolicy>)
+    {
+        if (n_lines < _executor_of(policy).size())
+        {
+            for (size_t l = 0; l < n_lines; ++l)
+                fn(l, policy);
+            return;
+        }
+    }
+    parallel_for(policy, n_lines, _parallel_grain<T>(line_size), [&](size_t first, size_t last)
+    {
+        for (size_t l = first; l < last; ++l)
+            fn(l, seq);
+    });
+}
+
+// call fn(ptr) on the line of len elements at line, stride apart, gathered
+// into a buffer unless they are contiguous, and written back afterwards
+template<typename T, typename Function>
+inline void _with_line_buffer(T* line, size_t len, size_t stride, Function fn)
+{
+    if (stride == 1)
+    {
+        fn(line);
+    }
+    else
+    {
+        _scratch_buffer<T> buffer(len);
+        T* items = buffer.data();
+        for (size_t i = 0; i < len; ++i)
+            items[i] = line[i * stride];
+        fn(items);
+        for (size_t i = 0; i < len; ++i)
+            line[i * stride] = items[i];
+    }
+}
+
+// call fn(keys, dims) with the elements of src in a contiguous array,
+// which is src itself if it is one
+template<typename ExecutionPolicy, typename Array, typename Function>
+inline decltype(auto) _with_sort_keys(ExecutionPolicy&& policy, const Array& src, Function fn)
+{
+    if constexpr (array_obj_type_of_v<Array> == array_obj_type::array)
+    {
+        return fn(src.data(), src.dimensions());
+    }
+    else
+    {
+        const auto keys = make_array(policy, src);
+        return fn(keys.data(), keys.dimensions());
+    }
+}
+
+
+// each line along Level sorted by comp
+template<size_t Level = _sort_last_v, typename ExecutionPolicy, typename Array, typename Compare = std::less<>,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto sort(ExecutionPolicy&& policy, const Array& src, Compare comp = Compare{})
+{
+    constexpr size_t level_v = _sort_level_v<Level, Array>;
+    static_assert(level_v < array_depth_of_v<Array>, "the level to sort is out of range.");
+
+    auto ret = make_array(policy, src);
+    using elem_t = typename decltype(ret)::_elem_t;
+    const auto   dims    = ret.dimensions();
+    const size_t len     = dims[level_v];
+    const size_t stride  = _line_stride<level_v>(dims);
+    const size_t n_lines = len == 0 ? 0 : ret.size() / len;
+    elem_t*      data    = ret.data();
+    if constexpr (_is_network_sortable_v<elem_t, Compare>)
+    {
+        if (len <= _small_sort_v)
+        {
+            if (len > 1)
+                parallel_for(policy, n_lines, _parallel_grain<elem_t>(len), [&](size_t first, size_t last)
+                {
+                    _network_sort_lines<_radix_order_v<Compare>>(data, first, last, len, stride);
+                });
+            return ret;
+        }
+    }
+    _for_each_line<elem_t>(policy, n_lines, len, [&](size_t l, auto&& line_policy)
+    {
+        _with_line_buffer(data + _line_offset(l, len, stride), len, stride, [&](elem_t* items)
+        {
+            _parallel_sort_run(line_policy, items, len, comp);
+        });
+    });
+    return ret;
+}
+
+template<size_t Level = _sort_last_v, typename Array, typename Compare = std::less<>,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto sort(const Array& src, Compare comp = Compare{})
+{
+    return sort<Level>(seq, src, comp);
+}
+
+// positions along Level that sort each line by comp, where equivalent
+// elements keep their order
+template<size_t Level = _sort_last_v, typename ExecutionPolicy, typename Array, typename Compare = std::less<>,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto argsort(ExecutionPolicy&& policy, const Array& src, Compare comp = Compare{})
+{
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    constexpr size_t level_v = _sort_level_v<Level, Array>;
+    static_assert(level_v < depth_v, "the level to sort is out of range.");
+    using elem_t = std::remove_const_t<array_elem_of_t<Array>>;
+    using item_t = std::pair<elem_t, size_t>;
+
+    return _with_sort_keys(policy, src, [&](const elem_t* keys, const std::array<size_t, depth_v>& dims)
+    {
+        auto ret = [&]()
+        {
+            if constexpr (depth_v == 1)
+                return std::vector<size_t>(dims[0]);
+            else
+                return array<size_t, depth_v>(default_init, dims);
+        }();
+        const size_t len    = dims[level_v];
+        const size_t stride = _line_stride<level_v>(dims);
+        size_t*      out    = ret.data();
+        _for_each_line<item_t>(policy, len == 0 ? 0 : ret.size() / len, len, [&](size_t l, auto&& line_policy)
+        {
+            const size_t offset = _line_offset(l, len, stride);
+            _scratch_buffer<item_t> buffer(len);
+            item_t* items = buffer.data();
+            for (size_t i = 0; i < len; ++i)
+                items[i] = item_t(keys[offset + i * stride], i);
+            _parallel_sort_run(line_policy, items, len, _index_compare<Compare>{comp});
+            for (size_t i = 0; i < len; ++i)
+                out[offset + i * stride] = items[i].second;
+        });
+        return ret;
+    });
+}
+
+template<size_t Level = _sort_last_v, typename Array, typename Compare = std::less<>,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto argsort(const Array& src, Compare comp = Compare{})
+{
+    return argsort<Level>(seq, src, comp);
+}
+
+// each line along Level partitioned by its element at position nth if
+// sorted by comp
+template<size_t Level = _sort_last_v, typename ExecutionPolicy, typename Array, typename Compare = std::less<>,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto nth_element(ExecutionPolicy&& policy, const Array& src, size_t nth, Compare comp = Compare{})
+{
+    constexpr size_t level_v = _sort_level_v<Level, Array>;
+    static_assert(level_v < array_depth_of_v<Array>, "the level to sort is out of range.");
+
+    auto ret = make_array(policy, src);
+    using elem_t = typename decltype(ret)::_elem_t;
+    const auto   dims   = ret.dimensions();
+    const size_t len    = dims[level_v];
+    const size_t stride = _line_stride<level_v>(dims);
+    elem_t*      data   = ret.data();
+    NDARRAY_ASSERT(nth < len || ret.size() == 0);
+    _for_each_line<elem_t>(policy, len == 0 ? 0 : ret.size() / len, len, [&](size_t l, auto&&)
+    {
+        _with_line_buffer(data + _line_offset(l, len, stride), len, stride, [&](elem_t* items)
+        {
+            std::nth_element(items, items + nth, items + len, comp);
+        });
+    });
+    return ret;
+}
+
+template<size_t Level = _sort_last_v, typename Array, typename Compare = std::less<>,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto nth_element(const Array& src, size_t nth, Compare comp = Compare{})
+{
+    return nth_element<Level>(seq, src, nth, comp);
+}
+
+// the first k elements of each line along Level if sorted by comp, i.e.
+// the k greatest ones by default, in that order
+template<size_t Level = _sort_last_v, typename ExecutionPolicy, typename Array, typename Compare = std::greater<>,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto topk(ExecutionPolicy&& policy, const Array& src, size_t k, Compare comp = Compare{})
+{
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    constexpr size_t level_v = _sort_level_v<Level, Array>;
+    static_assert(level_v < depth_v, "the level to sort is out of range.");
+    using elem_t = std::remove_const_t<array_elem_of_t<Array>>;
+
+    return _with_sort_keys(policy, src, [&](const elem_t* keys, const std::array<size_t, depth_v>& dims)
+    {
+        const size_t len = dims[level_v];
+        NDARRAY_ASSERT(k <= len);
+        auto ret_dims = dims;
+        ret_dims[level_v] = k;
+        array<elem_t, depth_v> ret(default_init, ret_dims);
+
+        const size_t stride  = _line_stride<level_v>(dims);
+        size_t       n_lines = len == 0 ? 0 : 1;
+        for (size_t i = 0; i < depth_v; ++i)
+            if (i != level_v)
+                n_lines *= dims[i];
+        elem_t*      out     = ret.data();
+        _for_each_line<elem_t>(policy, n_lines, len, [&](size_t l, auto&&)
+        {
+            const size_t offset = _line_offset(l, len, stride);
+            _scratch_buffer<elem_t> buffer(len);
+            elem_t* items = buffer.data();
+            for (size_t i = 0; i < len; ++i)
+                items[i] = keys[offset + i * stride];
+            if (k < len)
+                std::nth_element(items, items + k, items + len, comp);
+            _sort_run(items, k, comp);
+            const size_t out_offset = _line_offset(l, k, stride);
+            for (size_t i = 0; i < k; ++i)
+                out[out_offset + i * stride] = items[i];
+        });
+        return ret;
+    });
+}
+
+template<size_t Level = _sort_last_v, typename Array, typename Compare = std::greater<>,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto topk(const Array& src, size_t k, Compare comp = Compare{})
+{
+    return topk<Level>(seq, src, k, comp);
+}
+
+}
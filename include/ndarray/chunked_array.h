@@ -0,0 +1,824 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "decls.h"
+#include "traits.h"
+#include "indexer.h"
+#include "allocator.h"
+#include "array.h"
+#include "array_interface.h"
+#include "execution.h"
+
+namespace ndarray
+{
+
+//
+// chunked_array<T, Depth> stores an array as compressed tiles of fixed
+// dimensions, e.g. chunked_array<float, 2> c(a, {256, 256}). Tiles at the
+// upper edges are smaller when the dimensions are not multiples of them.
+//
+// Each tile is compressed with a built-in codec: the bytes of the elements
+// are shuffled so that the i-th bytes of all elements are adjacent, which
+// turns runs of small or equal values into runs of equal bytes, and then
+// compressed with an LZ77 byte codec. Tiles that do not shrink are kept
+// raw.
+//
+// The elements are read-only, and tiles are decompressed on demand:
+//
+//  access                   decompressed tiles
+//---------------------------------------------------------------------
+//  at(), operator()         the tile of the element, through the cache
+//  part(spans...)           the tiles touched by the spans, through the
+//                           cache; the result is an array
+//  element iterators        one tile at a time as they advance, through
+//                           the cache
+//  copy_to(), make_array()  every tile once, bypassing the cache
+//
+// Decoded tiles are kept in an LRU cache of at most cache_budget() bytes,
+// which always has room for the last tile used. The cache is guarded by a
+// mutex, so a chunked_array can be read from several threads.
+//
+// It is an array object in expressions, reductions, data_copy() and
+// save_npy(), where its elements are read through its element iterators
+// or copy_to().
+//
+
+// default byte budget of the cache of decoded tiles
+constexpr size_t _chunk_cache_default_bytes_v = size_t(1) << 26;
+
+// codec of a stored tile
+enum class _chunk_codec : unsigned char
+{
+    raw,         // the elements as they are
+    shuffle_lz   // shuffled bytes compressed by _lz_compress()
+};
+
+// dst[b * n + i] = src[i * elem_size + b]
+inline void _shuffle_bytes(const unsigned char* src, unsigned char* dst, size_t n, size_t elem_size)
+{
+    for (size_t b = 0; b < elem_size; ++b)
+        for (size_t i = 0; i < n; ++i)
+            dst[b * n + i] = src[i * elem_size + b];
+}
+
+// inverse of _shuffle_bytes()
+inline void _unshuffle_bytes(const unsigned char* src, unsigned char* dst, size_t n, size_t elem_size)
+{
+    for (size_t b = 0; b < elem_size; ++b)
+        for (size_t i = 0; i < n; ++i)
+            dst[i * elem_size + b] = src[b * n + i];
+}
+
+// The LZ codec writes sequences of
+//   token: (number of literals, capped at 15) << 4 | (match length - 4, capped at 15)
+//   [extra literal count as bytes of 255 ended by a smaller byte]
+//   literals
+//   match offset in 2 bytes, little endian        (absent in the last sequence)
+//   [extra match length as bytes of 255 ended by a smaller byte]
+// where a match copies length bytes starting offset bytes back.
+
+constexpr size_t _lz_min_match_v  = 4;
+constexpr size_t _lz_max_offset_v = 65535;
+constexpr size_t _lz_hash_bits_v  = 12;
+
+inline void _lz_put_length(std::vector<unsigned char>& out, size_t len)
+{
+    for (; len >= 255; len -= 255)
+        out.push_back(255);
+    out.push_back(static_cast<unsigned char>(len));
+}
+
+inline void _lz_put_sequence(std::vector<unsigned char>& out, const unsigned char* literals,
+                             size_t n_literals, size_t offset, size_t match_len)
+{
+    const size_t match_code = match_len == 0 ? 0 : match_len - _lz_min_match_v;
+    out.push_back(static_cast<unsigned char>(
+        std::min(n_literals, size_t(15)) << 4 | std::min(match_code, size_t(15))));
+    if (n_literals >= 15)
+        _lz_put_length(out, n_literals - 15);
+    out.insert(out.end(), literals, literals + n_literals);
+    if (match_len == 0)
+        return;
+    out.push_back(static_cast<unsigned char>(offset & 0xff));
+    out.push_back(static_cast<unsigned char>(offset >> 8));
+    if (match_code >= 15)
+        _lz_put_length(out, match_code - 15);
+}
+
+inline uint32_t _lz_read32(const unsigned char* ptr)
+{
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+// compress n bytes with greedy matching over a hash table of 4-byte prefixes
+inline std::vector<unsigned char> _lz_compress(const unsigned char* src, size_t n)
+{
+    constexpr uint32_t no_pos_v = uint32_t(-1);
+    std::vector<uint32_t>      table(size_t(1) << _lz_hash_bits_v, no_pos_v);
+    std::vector<unsigned char> out;
+    out.reserve(n / 2 + 16);
+
+    size_t pos = 0, anchor = 0;
+    while (pos + _lz_min_match_v <= n)
+    {
+        const uint32_t prefix = _lz_read32(src + pos);
+        const uint32_t hash   = (prefix * 2654435761u) >> (32 - _lz_hash_bits_v);
+        const uint32_t ref    = table[hash];
+        table[hash] = uint32_t(pos);
+        if (ref == no_pos_v || pos - ref > _lz_max_offset_v || _lz_read32(src + ref) != prefix)
+        {
+            ++pos;
+            continue;
+        }
+        size_t len = _lz_min_match_v;
+        while (pos + len < n && src[ref + len] == src[pos + len])
+            ++len;
+        _lz_put_sequence(out, src + anchor, pos - anchor, pos - ref, len);
+        pos   += len;
+        anchor = pos;
+    }
+    _lz_put_sequence(out, src + anchor, n - anchor, 0, 0);
+    return out;
+}
+
+inline size_t _lz_get_length(const unsigned char*& ptr)
+{
+    size_t len = 0;
+    unsigned char byte;
+    do
+    {
+        byte = *ptr++;
+        len += byte;
+    } while (byte == 255);
+    return len;
+}
+
+// decompress the output of _lz_compress() into dst_size bytes
+inline void _lz_decompress(const unsigned char* src, size_t n, unsigned char* dst, size_t dst_size)
+{
+    const unsigned char* const src_end = src + n;
+    [[maybe_unused]] unsigned char* const dst_end = dst + dst_size;
+    for (;;)
+    {
+        const unsigned char token = *src++;
+        size_t n_literals = token >> 4;
+        if (n_literals == 15)
+            n_literals += _lz_get_length(src);
+        assert(n_literals <= size_t(dst_end - dst) && n_literals <= size_t(src_end - src));
+        if (n_literals > 0)
+            std::memcpy(dst, src, n_literals);
+        dst += n_literals;
+        src += n_literals;
+        if (src == src_end)
+            break;
+
+        const size_t offset = size_t(src[0]) | size_t(src[1]) << 8;
+        src += 2;
+        size_t len = token & 15;
+        if (len == 15)
+            len += _lz_get_length(src);
+        len += _lz_min_match_v;
+        assert(len <= size_t(dst_end - dst));
+        const unsigned char* ref = dst - offset;
+        for (size_t i = 0; i < len; ++i) // the match may overlap its output
+            dst[i] = ref[i];
+        dst += len;
+    }
+    assert(dst == dst_end);
+}
+
+
+template<typename T, size_t Depth>
+class chunked_elem_iter;
+
+template<typename T, size_t Depth>
+class chunked_array
+{
+public:
+    using _my_type    = chunked_array;
+    using _elem_t     = T;
+    using _tile_t     = std::vector<T, default_init_allocator<T>>;
+    using _tile_ptr_t = std::shared_ptr<const _tile_t>;
+    static constexpr size_t _depth_v    = Depth;
+    static constexpr bool   _is_const_v = true;
+    using _dims_t     = std::array<size_t, _depth_v>;
+    using _indexers_t = n_all_indexer_tuple_t<_depth_v>;
+    static_assert(_depth_v > 0);
+    static_assert(std::is_trivially_copyable_v<T>, "chunked_array requires trivially copyable elements.");
+
+private:
+    _dims_t dims_{};
+    _dims_t chunk_dims_{};
+    _dims_t grid_dims_{};    // number of tiles on each level
+    std::vector<std::vector<unsigned char>> tiles_;
+
+    struct _cache_t
+    {
+        using _order_t = std::list<size_t>;  // tile ids, most recently used first
+        struct _entry_t
+        {
+            _tile_ptr_t                 tile;
+            typename _order_t::iterator order_pos;
+        };
+
+        std::mutex                            mutex;
+        size_t                                budget = _chunk_cache_default_bytes_v;
+        size_t                                bytes  = 0;
+        _order_t                              order;
+        std::unordered_map<size_t, _entry_t>  entries;
+    };
+    std::unique_ptr<_cache_t> cache_ = std::make_unique<_cache_t>();
+
+public:
+    // compress the elements of an array object into tiles of chunk_dims
+    template<typename Array>
+    chunked_array(const Array& src, _dims_t chunk_dims,
+                  size_t cache_budget = _chunk_cache_default_bytes_v) :
+        chunked_array(seq, src, chunk_dims, cache_budget) {}
+
+    // compress tiles in parallel under an execution policy
+    template<typename ExecutionPolicy, typename Array,
+             _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+    chunked_array(ExecutionPolicy&& policy, const Array& src, _dims_t chunk_dims,
+                  size_t cache_budget = _chunk_cache_default_bytes_v) :
+        dims_{ndarray::dimensions(src)}, chunk_dims_{chunk_dims}
+    {
+        static_assert(array_depth_of_v<Array> == _depth_v, "the depth of the source does not match.");
+        cache_->budget = cache_budget;
+        size_t n_tiles = 1;
+        for (size_t i = 0; i < _depth_v; ++i)
+        {
+            NDARRAY_ASSERT(chunk_dims_[i] > 0);
+            grid_dims_[i] = (dims_[i] + chunk_dims_[i] - 1) / chunk_dims_[i];
+            n_tiles *= grid_dims_[i];
+        }
+        tiles_.resize(n_tiles);
+
+        if constexpr (array_obj_type_of_v<Array> == array_obj_type::array  ||
+                      array_obj_type_of_v<Array> == array_obj_type::simple ||
+                      array_obj_type_of_v<Array> == array_obj_type::regular ||
+                      array_obj_type_of_v<Array> == array_obj_type::irregular ||
+                      array_obj_type_of_v<Array> == array_obj_type::strided)
+        {
+            parallel_for(policy, n_tiles, 1, [&](size_t first, size_t last)
+            {
+                _tile_t buffer;
+                for (size_t id = first; id < last; ++id)
+                {
+                    const auto origin = this->_tile_origin(id);
+                    auto       tile   = src.tuple_vpart(
+                        this->_tile_spans(origin, std::make_index_sequence<_depth_v>{}));
+                    buffer.resize(tile.size());
+                    tile.copy_to(buffer.data());
+                    tiles_[id] = _encode_tile(buffer);
+                }
+            });
+        }
+        else // elements without addresses are evaluated first
+        {
+            const auto tmp = make_array(policy, src);
+            *this = chunked_array(policy, tmp, chunk_dims, cache_budget);
+        }
+    }
+
+    chunked_array(chunked_array&&) = default;
+    chunked_array& operator=(chunked_array&&) = default;
+
+    // total size of the array
+    size_t size() const
+    {
+        size_t size = 1;
+        for (size_t i = 0; i < _depth_v; ++i)
+            size *= dims_[i];
+        return size;
+    }
+
+    // dimension of the array on the i-th level
+    template<size_t I>
+    size_t dimension() const
+    {
+        static_assert(I < _depth_v);
+        return dims_[I];
+    }
+
+    // array of dimensions
+    _dims_t dimensions() const
+    {
+        return dims_;
+    }
+
+    // dimensions of the tiles, except at the upper edges
+    _dims_t chunk_dimensions() const
+    {
+        return chunk_dims_;
+    }
+
+    const size_t* _identifier_ptr() const
+    {
+        return dims_.data();
+    }
+
+    // bytes of the compressed tiles
+    size_t compressed_bytes() const
+    {
+        size_t bytes = 0;
+        for (const auto& tile : tiles_)
+            bytes += tile.size();
+        return bytes;
+    }
+
+    // maximum bytes of decoded tiles kept in the cache
+    size_t cache_budget() const
+    {
+        std::lock_guard<std::mutex> lock(cache_->mutex);
+        return cache_->budget;
+    }
+
+    // bytes of decoded tiles in the cache
+    size_t cache_bytes() const
+    {
+        std::lock_guard<std::mutex> lock(cache_->mutex);
+        return cache_->bytes;
+    }
+
+    void set_cache_budget(size_t budget)
+    {
+        std::lock_guard<std::mutex> lock(cache_->mutex);
+        cache_->budget = budget;
+        this->_evict(*cache_);
+    }
+
+    // drop all decoded tiles
+    void clear_cache()
+    {
+        std::lock_guard<std::mutex> lock(cache_->mutex);
+        cache_->entries.clear();
+        cache_->order.clear();
+        cache_->bytes = 0;
+    }
+
+    // indexing with a tuple/array of integers
+    template<typename Tuple>
+    _elem_t tuple_at(const Tuple& indices) const
+    {
+        static_assert(std::tuple_size_v<Tuple> == _depth_v, "incorrect number of indices");
+        _dims_t index;
+        this->_normalize_indices(indices, index, std::make_index_sequence<_depth_v>{});
+        const auto location = this->_locate(index);
+        return (*this->_get_tile(location.first))[location.second];
+    }
+
+    // indexing with multiple integers
+    template<typename... Ints>
+    _elem_t at(Ints... ints) const
+    {
+        return this->tuple_at(std::make_tuple(ints...));
+    }
+
+    // automatically calls at() or part(), depending on its arguments
+    template<typename... Anys>
+    auto operator()(Anys&&... anys) const
+    {
+        constexpr bool is_complete_index = sizeof...(Anys) == _depth_v && is_all_ints_v<Anys...>;
+        if constexpr (is_complete_index)
+            return this->at(std::forward<decltype(anys)>(anys)...);
+        else
+            return this->part(std::forward<decltype(anys)>(anys)...);
+    }
+
+    // copy of the elements selected by spans, as in array::part()
+    template<typename SpanTuple>
+    deduce_part_array_type_t<_elem_t, _indexers_t, SpanTuple>
+        tuple_part(SpanTuple&& spans) const
+    {
+        using ret_t = deduce_part_array_type_t<_elem_t, _indexers_t, SpanTuple>;
+        std::array<std::vector<size_t>, _depth_v> positions;
+        this->template _span_positions<0>(positions, spans);
+
+        typename ret_t::_dims_t ret_dims{};
+        for (size_t i = 0, j = 0; i < _depth_v; ++i)
+            if (!this->template _is_scalar_span<SpanTuple>(i))
+                ret_dims[j++] = positions[i].size();
+        ret_t ret(default_init, ret_dims);
+        if (ret.size() == 0)
+            return ret;
+
+        // visit the selected elements in order, looking up a tile only
+        // when the previous element was in another one
+        _dims_t     counters{};
+        _dims_t     index;
+        size_t      tile_id = size_t(-1);
+        _tile_ptr_t tile;
+        _elem_t*    dst = ret.data();
+        for (size_t pos = 0, size = ret.size(); pos < size; ++pos)
+        {
+            for (size_t i = 0; i < _depth_v; ++i)
+                index[i] = positions[i][counters[i]];
+            const auto location = this->_locate(index);
+            if (location.first != tile_id)
+            {
+                tile_id = location.first;
+                tile    = this->_get_tile(tile_id);
+            }
+            dst[pos] = (*tile)[location.second];
+            for (size_t i = _depth_v; i-- > 0;)
+            {
+                if (++counters[i] < positions[i].size())
+                    break;
+                counters[i] = 0;
+            }
+        }
+        return ret;
+    }
+
+    template<typename... Spans>
+    deduce_part_array_type_t<_elem_t, _indexers_t, std::tuple<Spans...>>
+        part(Spans&&... spans) const
+    {
+        return this->tuple_part(std::forward_as_tuple(spans...));
+    }
+
+    chunked_elem_iter<T, Depth> element_cbegin() const
+    {
+        return {*this, 0};
+    }
+    chunked_elem_iter<T, Depth> element_cend() const
+    {
+        return {*this, this->size()};
+    }
+    chunked_elem_iter<T, Depth> element_begin() const
+    {
+        return this->element_cbegin();
+    }
+    chunked_elem_iter<T, Depth> element_end() const
+    {
+        return this->element_cend();
+    }
+
+    // check whether having same dimensions with another array, starting at specific levels
+    template<size_t MyStartLevel = 0, size_t OtherStartLevel = 0, typename OtherArray>
+    bool check_size_with(const OtherArray& other) const
+    {
+        if constexpr (MyStartLevel == _depth_v || OtherStartLevel == OtherArray::_depth_v)
+            return false;
+        else if constexpr (MyStartLevel == _depth_v - 1 && OtherStartLevel == OtherArray::_depth_v - 1)
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>();
+        else
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>() &&
+            check_size_with<MyStartLevel + 1, OtherStartLevel + 1>(other);
+    }
+
+    // decode every tile once into dst, bypassing the cache; a prefix of
+    // fewer elements than size() is read through the element iterators
+    template<typename Iter>
+    void copy_to(Iter dst, size_t size) const
+    {
+        NDARRAY_ASSERT(size <= this->size());
+        if constexpr (_strided_iter_traits<Iter>::value)
+        {
+            if (size == this->size())
+            {
+                this->_copy_to_strided(seq, _strided_iter_traits<Iter>::ptr(dst),
+                                       _strided_iter_traits<Iter>::stride(dst));
+                return;
+            }
+        }
+        for (auto src = this->element_cbegin(); size > 0; --size, ++src, ++dst)
+            *dst = *src;
+    }
+
+    template<typename Iter>
+    void copy_to(Iter dst) const
+    {
+        this->copy_to(dst, this->size());
+    }
+
+    // decode tiles into elements at ptr, ptr + stride, ... in the order of
+    // the array, splitting the tiles into chunks under parallel policies
+    template<typename ExecutionPolicy, typename U>
+    void _copy_to_strided(ExecutionPolicy&& policy, U* ptr, ptrdiff_t stride) const
+    {
+        parallel_for(policy, tiles_.size(), 1, [&](size_t first, size_t last)
+        {
+            _tile_t tile;
+            for (size_t id = first; id < last; ++id)
+            {
+                this->_decode_tile(id, tile);
+                const auto origin     = this->_tile_origin(id);
+                const auto tile_dims  = this->_tile_dims(origin);
+                const size_t row_size = tile_dims[_depth_v - 1];
+                if (row_size == 0)
+                    continue;
+
+                // copy the tile row by row
+                _dims_t counters{};
+                for (size_t src_pos = 0; src_pos < tile.size(); src_pos += row_size)
+                {
+                    size_t dst_pos = 0;
+                    for (size_t i = 0; i < _depth_v; ++i)
+                        dst_pos = dst_pos * dims_[i] + origin[i] + counters[i];
+                    _strided_copy(tile.data() + src_pos, 1,
+                                  ptr + ptrdiff_t(dst_pos) * stride, stride, row_size);
+                    for (size_t i = _depth_v - 1; i-- > 0;)
+                    {
+                        if (++counters[i] < tile_dims[i])
+                            break;
+                        counters[i] = 0;
+                    }
+                }
+            }
+        });
+    }
+
+    // the tile with an id, and the position of an element in it
+    std::pair<size_t, size_t> _locate(const _dims_t& index) const
+    {
+        size_t tile_id = 0, offset = 0;
+        for (size_t i = 0; i < _depth_v; ++i)
+        {
+            NDARRAY_ASSERT(index[i] < dims_[i]);
+            const size_t coord     = index[i] / chunk_dims_[i];
+            const size_t tile_dim  = std::min(chunk_dims_[i], dims_[i] - coord * chunk_dims_[i]);
+            tile_id = tile_id * grid_dims_[i] + coord;
+            offset  = offset * tile_dim + index[i] % chunk_dims_[i];
+        }
+        return {tile_id, offset};
+    }
+
+    // decoded tile with an id, from the cache or decoded into it
+    _tile_ptr_t _get_tile(size_t id) const
+    {
+        auto& cache = *cache_;
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            auto iter = cache.entries.find(id);
+            if (iter != cache.entries.end())
+            {
+                cache.order.splice(cache.order.begin(), cache.order, iter->second.order_pos);
+                return iter->second.tile;
+            }
+        }
+
+        // decode outside the lock; a concurrent reader may decode it too
+        auto tile = std::make_shared<_tile_t>();
+        this->_decode_tile(id, *tile);
+
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto iter = cache.entries.find(id);
+        if (iter != cache.entries.end())
+            return iter->second.tile;
+        cache.order.push_front(id);
+        cache.entries.emplace(id, typename _cache_t::_entry_t{tile, cache.order.begin()});
+        cache.bytes += tile->size() * sizeof(T);
+        this->_evict(cache);
+        return tile;
+    }
+
+private:
+    // drop the least recently used tiles over the budget, but the last one
+    static void _evict(_cache_t& cache)
+    {
+        while (cache.bytes > cache.budget && cache.order.size() > 1)
+        {
+            auto iter = cache.entries.find(cache.order.back());
+            cache.bytes -= iter->second.tile->size() * sizeof(T);
+            cache.entries.erase(iter);
+            cache.order.pop_back();
+        }
+    }
+
+    static std::vector<unsigned char> _encode_tile(const _tile_t& tile)
+    {
+        const size_t n_bytes = tile.size() * sizeof(T);
+        const auto*  bytes   = reinterpret_cast<const unsigned char*>(tile.data());
+        std::vector<unsigned char> shuffled(n_bytes);
+        _shuffle_bytes(bytes, shuffled.data(), tile.size(), sizeof(T));
+        std::vector<unsigned char> encoded = _lz_compress(shuffled.data(), n_bytes);
+
+        std::vector<unsigned char> ret;
+        if (encoded.size() < n_bytes)
+        {
+            ret.reserve(encoded.size() + 1);
+            ret.push_back(static_cast<unsigned char>(_chunk_codec::shuffle_lz));
+            ret.insert(ret.end(), encoded.begin(), encoded.end());
+        }
+        else
+        {
+            ret.reserve(n_bytes + 1);
+            ret.push_back(static_cast<unsigned char>(_chunk_codec::raw));
+            ret.insert(ret.end(), bytes, bytes + n_bytes);
+        }
+        return ret;
+    }
+
+    void _decode_tile(size_t id, _tile_t& tile) const
+    {
+        const auto& stored    = tiles_[id];
+        const auto  tile_dims = this->_tile_dims(this->_tile_origin(id));
+        size_t size = 1;
+        for (size_t i = 0; i < _depth_v; ++i)
+            size *= tile_dims[i];
+        tile.resize(size);
+        auto* dst = reinterpret_cast<unsigned char*>(tile.data());
+        const size_t n_bytes = size * sizeof(T);
+        if (static_cast<_chunk_codec>(stored[0]) == _chunk_codec::raw)
+        {
+            std::memcpy(dst, stored.data() + 1, n_bytes);
+        }
+        else
+        {
+            std::vector<unsigned char> shuffled(n_bytes);
+            _lz_decompress(stored.data() + 1, stored.size() - 1, shuffled.data(), n_bytes);
+            _unshuffle_bytes(shuffled.data(), dst, size, sizeof(T));
+        }
+    }
+
+    // index of the first element of a tile
+    _dims_t _tile_origin(size_t id) const
+    {
+        _dims_t origin;
+        for (size_t i = _depth_v; i-- > 0;)
+        {
+            origin[i] = id % grid_dims_[i] * chunk_dims_[i];
+            id /= grid_dims_[i];
+        }
+        return origin;
+    }
+
+    _dims_t _tile_dims(const _dims_t& origin) const
+    {
+        _dims_t tile_dims;
+        for (size_t i = 0; i < _depth_v; ++i)
+            tile_dims[i] = std::min(chunk_dims_[i], dims_[i] - origin[i]);
+        return tile_dims;
+    }
+
+    template<size_t... I>
+    auto _tile_spans(const _dims_t& origin, std::index_sequence<I...>) const
+    {
+        return std::make_tuple(span(origin[I], origin[I] + std::min(chunk_dims_[I], dims_[I] - origin[I]))...);
+    }
+
+    template<typename Tuple, size_t... I>
+    void _normalize_indices(const Tuple& indices, _dims_t& index, std::index_sequence<I...>) const
+    {
+        ((index[I] = _add_if_negative<size_t>(std::get<I>(indices), dims_[I])), ...);
+    }
+
+    template<typename SpanTuple>
+    static constexpr bool _is_scalar_span(size_t level)
+    {
+        return _is_scalar_span_impl<SpanTuple>(level, std::make_index_sequence<_depth_v>{});
+    }
+    template<typename SpanTuple, size_t... I>
+    static constexpr bool _is_scalar_span_impl(size_t level, std::index_sequence<I...>)
+    {
+        constexpr bool is_scalar[] = {std::is_same_v<scalar_indexer, indexer_collapsing_t<all_indexer,
+            decltype(_take_ith_span<I>(std::declval<SpanTuple>()))>>...};
+        return is_scalar[level];
+    }
+
+    // positions on each level selected by spans
+    template<size_t Level, typename SpanTuple>
+    void _span_positions(std::array<std::vector<size_t>, _depth_v>& positions, SpanTuple&& spans) const
+    {
+        auto collapsed = collapse_indexer(dims_[Level], all_indexer{}, _take_ith_span<Level>(spans));
+        const size_t offset  = collapsed.first;
+        const auto&  indexer = collapsed.second;
+        if constexpr (std::is_same_v<remove_cvref_t<decltype(indexer)>, scalar_indexer>)
+        {
+            positions[Level].assign(1, offset);
+        }
+        else
+        {
+            const size_t n = indexer.size(dims_[Level]);
+            positions[Level].resize(n);
+            for (size_t i = 0; i < n; ++i)
+                positions[Level][i] = offset + size_t(indexer[i]);
+        }
+        if constexpr (Level + 1 < _depth_v)
+            this->template _span_positions<Level + 1>(positions, spans);
+    }
+};
+
+
+// element iterator of a chunked_array, which holds the tile of its element
+template<typename T, size_t Depth>
+class chunked_elem_iter
+{
+public:
+    using _my_type    = chunked_elem_iter;
+    using _array_t    = chunked_array<T, Depth>;
+    using _elem_t     = T;
+    using _dims_t     = typename _array_t::_dims_t;
+    static constexpr bool _is_const_v = true;
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = T;
+    using difference_type   = ptrdiff_t;
+    using pointer           = const T*;
+    using reference         = T;
+
+protected:
+    const _array_t*                  array_;
+    size_t                           pos_;
+    _dims_t                          index_{};
+    typename _array_t::_tile_ptr_t   tile_;
+    size_t                           offset_ = 0;  // position in tile_
+    size_t                           run_    = 0;  // elements left in the row of tile_
+
+public:
+    chunked_elem_iter(const _array_t& array, size_t pos) :
+        array_{&array}, pos_{pos}
+    {
+        if (pos_ < array_->size())
+        {
+            size_t rest = pos_;
+            const auto dims = array_->dimensions();
+            for (size_t i = Depth; i-- > 0;)
+            {
+                index_[i] = rest % dims[i];
+                rest /= dims[i];
+            }
+            this->_load();
+        }
+    }
+
+    _my_type& operator++()
+    {
+        ++pos_;
+        if (--run_ > 0)
+        {
+            ++offset_;
+            ++index_[Depth - 1];
+        }
+        else if (pos_ < array_->size())
+        {
+            const auto dims = array_->dimensions();
+            ++index_[Depth - 1];
+            for (size_t i = Depth; i-- > 1 && index_[i] == dims[i];)
+            {
+                index_[i] = 0;
+                ++index_[i - 1];
+            }
+            this->_load();
+        }
+        return *this;
+    }
+    _my_type operator++(int)
+    {
+        _my_type ret = *this;
+        ++(*this);
+        return ret;
+    }
+
+    _elem_t operator*() const
+    {
+        return (*tile_)[offset_];
+    }
+
+    bool operator==(const _my_type& other) const
+    {
+        return pos_ == other.pos_;
+    }
+    bool operator!=(const _my_type& other) const
+    {
+        return pos_ != other.pos_;
+    }
+
+private:
+    void _load()
+    {
+        const auto location = array_->_locate(index_);
+        tile_   = array_->_get_tile(location.first);
+        offset_ = location.second;
+        const size_t chunk = array_->chunk_dimensions()[Depth - 1];
+        const size_t dim   = array_->dimensions()[Depth - 1];
+        run_ = std::min(chunk - index_[Depth - 1] % chunk, dim - index_[Depth - 1]);
+    }
+};
+
+
+// decode a chunked_array into an array
+template<typename T, size_t Depth>
+inline array<T, Depth> make_array(const chunked_array<T, Depth>& src)
+{
+    array<T, Depth> ret(default_init, src.dimensions());
+    src.copy_to(ret.data());
+    return ret;
+}
+
+}
+
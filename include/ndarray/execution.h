@@ -0,0 +1,470 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "decls.h"
+#include "utils.h"
+
+namespace ndarray
+{
+
+//
+// Execution policies select how bulk operations (data_copy, make_array,
+// table, range, repeat) do their work. They are passed as the first
+// argument, e.g. make_array(par, view).
+//
+//  policy      work
+//---------------------------------------------------------------------
+//  seq         on the calling thread, same as omitting the policy
+//  par         split into chunks run by the default_thread_pool()
+//  par_unseq   same as par; the loop inside each chunk is free to be
+//              vectorized, which the sequential loops already allow
+//  an executor split into chunks run by the threads of that executor
+//
+// Work is split along level 0 of the destination (or the flattened
+// elements when the source has no levels to split), and only goes
+// parallel when the elements take at least _parallel_min_bytes_v bytes.
+// Parallel operations can be nested, e.g. a function passed to a parallel
+// table() can itself call make_array(par, ...).
+//
+
+struct sequenced_policy
+{
+    explicit sequenced_policy() = default;
+};
+struct parallel_policy
+{
+    explicit parallel_policy() = default;
+};
+struct parallel_unsequenced_policy
+{
+    explicit parallel_unsequenced_policy() = default;
+};
+
+constexpr sequenced_policy            seq{};
+constexpr parallel_policy             par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+
+class executor;
+
+template<typename T>
+struct _is_execution_policy : std::false_type {};
+template<>
+struct _is_execution_policy<sequenced_policy> : std::true_type {};
+template<>
+struct _is_execution_policy<parallel_policy> : std::true_type {};
+template<>
+struct _is_execution_policy<parallel_unsequenced_policy> : std::true_type {};
+template<>
+struct _is_execution_policy<executor> : std::true_type {};
+
+template<typename T>
+constexpr bool is_execution_policy_v = _is_execution_policy<remove_cvref_t<T>>::value;
+
+template<typename T>
+constexpr bool _is_parallel_policy_v =
+    std::is_same_v<remove_cvref_t<T>, parallel_policy> ||
+    std::is_same_v<remove_cvref_t<T>, parallel_unsequenced_policy> ||
+    std::is_same_v<remove_cvref_t<T>, executor>;
+
+template<typename T>
+using _enable_if_execution_policy_t = std::enable_if_t<is_execution_policy_v<T>, int>;
+
+// minimum bytes of elements for which a bulk operation goes parallel
+constexpr size_t _parallel_min_bytes_v = size_t(1) << 18;
+
+// minimum number of elements of type T for which a bulk operation goes
+// parallel; small elements still cost some work each, so at least 4096
+template<typename T>
+constexpr size_t _parallel_min_size_v = std::max(_parallel_min_bytes_v / sizeof(T), size_t(1) << 12);
+
+// minimum number of items per chunk when each item covers elem_size elements of type T
+template<typename T>
+inline size_t _parallel_grain(size_t elem_size)
+{
+    return std::max(_parallel_min_size_v<T> / std::max(elem_size, size_t(1)), size_t(1));
+}
+
+
+
+// _work_deque is a fixed-capacity Chase-Lev deque of tasks: its owner pushes
+// and pops at the bottom, while other threads steal from the top without
+// locks. push() fails when the deque is full.
+template<typename Task>
+class _work_deque
+{
+public:
+    static constexpr size_t _capacity_v = 1024;
+    static_assert((_capacity_v & (_capacity_v - 1)) == 0);
+
+    _work_deque()
+    {
+        for (auto& slot : buffer_)
+            slot.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // called by the owner only
+    bool push(Task* task)
+    {
+        const ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed);
+        const ptrdiff_t top    = top_.load(std::memory_order_acquire);
+        if (bottom - top >= ptrdiff_t(_capacity_v))
+            return false;
+        buffer_[size_t(bottom) & (_capacity_v - 1)].store(task, std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // called by the owner only; takes the most recently pushed task
+    Task* pop()
+    {
+        const ptrdiff_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        ptrdiff_t top = top_.load(std::memory_order_relaxed);
+        if (top > bottom)
+        { // empty
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Task* task = buffer_[size_t(bottom) & (_capacity_v - 1)].load(std::memory_order_relaxed);
+        if (top == bottom)
+        { // the last task, which a thief may be taking at the same time
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+                task = nullptr;
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // called by any thread; takes the least recently pushed task
+    Task* steal()
+    {
+        ptrdiff_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const ptrdiff_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+        Task* task = buffer_[size_t(top) & (_capacity_v - 1)].load(std::memory_order_acquire);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+            return nullptr; // lost the race to another thread
+        return task;
+    }
+
+private:
+    std::atomic<ptrdiff_t>                     top_{0};
+    std::atomic<ptrdiff_t>                     bottom_{0};
+    std::array<std::atomic<Task*>, _capacity_v> buffer_;
+};
+
+
+// executor runs parallel_for() on a fixed set of worker threads together
+// with the calling thread, and can be passed to bulk operations in place
+// of an execution policy, e.g. make_array(exec, view), to share one set of
+// threads with the rest of a program.
+//
+// A parallel_for() is a task covering [0, n), which is split in halves
+// while both halves are at least a leaf long, and a leaf is never shorter
+// than the grain. Halves are pushed to the deque of the splitting worker,
+// and idle workers steal them from each other. Threads that are not
+// workers, e.g. the thread calling parallel_for() first, push to a shared
+// queue instead. While waiting for its pieces to finish, the thread of a
+// parallel_for() runs other tasks, so parallel_for() can be nested: a
+// parallel outer loop can run parallel inner loops. When there is nothing
+// to run, it sleeps like an idle worker until a task is pushed or its last
+// piece finishes.
+class executor
+{
+    // one call of parallel_for()
+    struct _job
+    {
+        const void*         fn;
+        void              (*call)(const void*, size_t, size_t);
+        size_t              leaf;            // minimum length of a piece
+        std::atomic<size_t> remaining;       // length of the pieces not finished
+        std::exception_ptr  error;
+        std::mutex          error_mutex;
+    };
+    struct _task
+    {
+        _job*  job;
+        size_t first;
+        size_t last;
+    };
+
+    // the executor and deque index of the calling thread, if it is a worker
+    struct _worker_id
+    {
+        const executor* owner = nullptr;
+        size_t          index = 0;
+    };
+    static _worker_id& _this_worker()
+    {
+        static thread_local _worker_id id;
+        return id;
+    }
+
+    // pieces per thread, so that threads finishing early can steal more
+    static constexpr size_t _pieces_per_thread_v = 4;
+
+public:
+    // n_threads counts the calling thread, so n_threads - 1 workers are started
+    explicit executor(size_t n_threads) :
+        deques_(std::max(n_threads, size_t(1)) - 1)
+    {
+        for (size_t i = 0; i < deques_.size(); ++i)
+            workers_.emplace_back([this, i] { this->_worker_loop(i); });
+    }
+
+    executor(const executor&) = delete;
+    executor& operator=(const executor&) = delete;
+
+    ~executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    // number of threads that run a parallel_for(), including the caller
+    size_t size() const noexcept
+    {
+        return workers_.size() + 1;
+    }
+
+    // call fn(first, last) on disjoint ranges covering [0, n), each of them
+    // at least grain long unless n itself is shorter
+    template<typename Function>
+    void parallel_for(size_t n, size_t grain, Function&& fn)
+    {
+        grain = std::max(grain, size_t(1));
+        const size_t n_pieces = std::min(this->size() * _pieces_per_thread_v, n / grain);
+        if (n_pieces <= 1 || workers_.empty())
+        {
+            if (n > 0)
+                fn(size_t(0), n);
+            return;
+        }
+
+        using fn_t = std::remove_reference_t<Function>;
+        _job job;
+        job.fn   = std::addressof(fn);
+        job.call = [](const void* f, size_t first, size_t last)
+        {
+            (*static_cast<fn_t*>(const_cast<void*>(f)))(first, last);
+        };
+        job.leaf = n / n_pieces; // at least grain
+        job.remaining.store(n, std::memory_order_relaxed);
+
+        this->_run(job, 0, n);
+        while (job.remaining.load(std::memory_order_seq_cst) > 0)
+        { // help with any task until the pieces of this job are finished
+            if (_task* task = this->_take())
+            {
+                this->_run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            n_sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            cv_.wait(lock, [this, &job]
+            {
+                return job.remaining.load(std::memory_order_seq_cst) == 0 ||
+                    n_queued_.load(std::memory_order_seq_cst) > 0;
+            });
+            n_sleeping_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (job.error)
+            std::rethrow_exception(job.error);
+    }
+
+private:
+    // split [first, last) of a job while both halves are at least a leaf
+    // long, then run what is left
+    void _run(_job& job, size_t first, size_t last)
+    {
+        while (last - first >= 2 * job.leaf)
+        {
+            const size_t mid   = first + (last - first) / 2;
+            auto*        right = new _task{&job, mid, last};
+            if (!this->_push(right))
+            {
+                delete right;
+                break;
+            }
+            last = mid;
+        }
+        try
+        {
+            job.call(job.fn, first, last);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(job.error_mutex);
+            if (!job.error)
+                job.error = std::current_exception();
+        }
+        // the thread of parallel_for() may return as soon as this is zero,
+        // so job is not used afterwards; wake it if it sleeps
+        const size_t length = last - first;
+        if (job.remaining.fetch_sub(length, std::memory_order_seq_cst) == length &&
+            n_sleeping_.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+    void _run(_task* task)
+    {
+        const _task copy = *task;
+        delete task;
+        this->_run(*copy.job, copy.first, copy.last);
+    }
+
+    bool _push(_task* task)
+    {
+        n_queued_.fetch_add(1, std::memory_order_seq_cst);
+        const _worker_id& id = _this_worker();
+        if (id.owner == this)
+        {
+            if (!deques_[id.index].push(task))
+            {
+                n_queued_.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(injected_mutex_);
+            injected_.push_back(task);
+        }
+        if (n_sleeping_.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+        return true;
+    }
+
+    // take a task from the own deque, the shared queue, or another worker
+    _task* _take()
+    {
+        const _worker_id& id     = _this_worker();
+        const bool        is_own = id.owner == this;
+        _task*            task   = is_own ? deques_[id.index].pop() : nullptr;
+        if (task == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(injected_mutex_);
+            if (!injected_.empty())
+            {
+                task = injected_.front();
+                injected_.pop_front();
+            }
+        }
+        const size_t n_deques = deques_.size();
+        const size_t start    = is_own ? id.index + 1 : 0;
+        for (size_t i = 0; task == nullptr && i < n_deques; ++i)
+            task = deques_[(start + i) % n_deques].steal();
+        if (task != nullptr)
+            n_queued_.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+
+    void _worker_loop(size_t index)
+    {
+        _this_worker() = {this, index};
+        for (;;)
+        {
+            if (_task* task = this->_take())
+            {
+                this->_run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            n_sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            cv_.wait(lock, [this]
+            {
+                return stop_ || n_queued_.load(std::memory_order_seq_cst) > 0;
+            });
+            n_sleeping_.fetch_sub(1, std::memory_order_relaxed);
+            if (stop_)
+                return;
+        }
+    }
+
+    std::vector<_work_deque<_task>>  deques_;   // one per worker
+    std::vector<std::thread>         workers_;
+    std::deque<_task*>               injected_; // pushed by other threads
+    std::mutex                       injected_mutex_;
+    std::atomic<size_t>              n_queued_{0};
+    std::atomic<size_t>              n_sleeping_{0};
+    std::mutex                       mutex_;
+    std::condition_variable          cv_;
+    bool                             stop_ = false;
+};
+
+// the former name of executor
+using thread_pool = executor;
+
+// number of threads of the default pool, taken from the NDARRAY_NUM_THREADS
+// environment variable if set, or the number of hardware threads otherwise
+inline size_t _default_thread_count()
+{
+    if (const char* env = std::getenv("NDARRAY_NUM_THREADS"))
+    {
+        const long n = std::strtol(env, nullptr, 10);
+        if (n > 0)
+            return size_t(n);
+    }
+    return std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
+}
+
+// the executor used by par and par_unseq, started on first use and never
+// destroyed so that it can be used during static destruction
+inline executor& default_thread_pool()
+{
+    static executor* pool = new executor(_default_thread_count());
+    return *pool;
+}
+
+// the executor that runs the work of a parallel policy
+template<typename ExecutionPolicy>
+inline executor& _executor_of(ExecutionPolicy&& policy)
+{
+    if constexpr (std::is_same_v<remove_cvref_t<ExecutionPolicy>, executor>)
+        return const_cast<executor&>(policy); // passed like any policy, maybe as const&
+    else
+        return default_thread_pool();
+}
+
+// call fn(first, last) on ranges covering [0, n), in parallel for parallel
+// policies and as a single call otherwise
+template<typename ExecutionPolicy, typename Function>
+inline void parallel_for(ExecutionPolicy&& policy, size_t n, size_t grain, Function&& fn)
+{
+    if constexpr (_is_parallel_policy_v<ExecutionPolicy>)
+        _executor_of(policy).parallel_for(n, grain, std::forward<Function>(fn));
+    else if (n > 0)
+        fn(size_t(0), n);
+}
+
+}
+
@@ -0,0 +1,537 @@
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include <type_traits>
+
+#include "decls.h"
+#include "traits.h"
+#include "allocator.h"
+#include "array.h"
+#include "array_view.h"
+#include "array_copy.h"
+
+namespace ndarray
+{
+
+//
+// fixed_array<T, Dims...> holds Dims[0] x Dims[1] x ... elements inline,
+// without heap allocation, laid out as in an array, e.g. a 3x3 matrix is
+// fixed_array<float, 3, 3>. Its dimensions and pointer strides are
+// constants, so indexing, size checks and copies between fixed_arrays
+// fold to constant offsets and trip counts; copies of up to
+// _unrolled_copy_size_v elements to or from contiguous memory are loops
+// over a compile-time size, larger ones go through the copy engine.
+//
+// It has the interface of an array: at(), operator(), vpart() and part()
+// with spans, level iterators and element iterators, and takes part in
+// data_copy(), expressions and reductions like an array_ref. Elements are
+// value-initialized, unless constructed with default_init, and can be
+// given in row-major order by an initializer list.
+//
+// A fixed_array is identified by its elements, as the dimensions of its
+// type are shared by all of its instances. Views of a fixed_array refer to
+// those dimensions, so views of two fixed_arrays of the same type are told
+// apart by their element addresses.
+//
+
+template<typename T, size_t... Dims>
+class fixed_array
+{
+public:
+    using _my_type         = fixed_array;
+    using _elem_t          = T;
+    using _no_const_elem_t = T;
+    static constexpr size_t _depth_v = sizeof...(Dims);
+    static constexpr size_t _size_v  = (size_t(1) * ... * Dims);
+    using _dims_t          = std::array<size_t, _depth_v>;
+    using _indexers_t      = n_all_indexer_tuple_t<_depth_v>;
+    static_assert(_depth_v > 0);
+    static_assert(((Dims > 0) && ...), "dimensions of a fixed_array must be positive");
+    static_assert(!std::is_const_v<T>);
+
+    static constexpr _dims_t _dims_v{Dims...};
+
+    // largest size copied by a loop with a compile-time trip count
+    static constexpr size_t _unrolled_copy_size_v = 64;
+
+public:
+    _elem_t data_[_size_v];
+
+public:
+    fixed_array() :
+        data_{} {}
+
+    // leave the elements default-initialized, to be overwritten by the caller
+    explicit fixed_array(default_init_t) {}
+
+    // elements in row-major order, the rest are value-initialized
+    fixed_array(std::initializer_list<_elem_t> elems) :
+        data_{}
+    {
+        NDARRAY_ASSERT(elems.size() <= _size_v);
+        size_t i = 0;
+        for (auto iter = elems.begin(); iter != elems.end() && i < _size_v; ++iter, ++i)
+            data_[i] = *iter;
+    }
+
+    template<typename View, typename = std::enable_if_t<is_array_object_v<View>>>
+    fixed_array(const View& other)
+    {
+        NDARRAY_ASSERT(this->check_size_with(other));
+        other.copy_to(this->data(), _size_v);
+    }
+
+    fixed_array(const fixed_array&) = default;
+    fixed_array& operator=(const fixed_array&) = default;
+
+    // copy data from a fixed_array of another element type
+    template<typename U>
+    _my_type& operator=(const fixed_array<U, Dims...>& other)
+    {
+        other.copy_to(this->data());
+        return *this;
+    }
+
+    // copy data from another view, assuming identical dimensions
+    template<typename View>
+    _my_type& operator=(const View& other)
+    {
+        data_copy(other, *this);
+        return *this;
+    }
+
+    // total size of the array
+    static constexpr size_t size()
+    {
+        return _size_v;
+    }
+
+    // dimension of the array on the i-th level
+    template<size_t I>
+    static constexpr size_t dimension()
+    {
+        static_assert(I < _depth_v);
+        return _dims_v[I];
+    }
+
+    // array of dimensions
+    static constexpr _dims_t dimensions()
+    {
+        return _dims_v;
+    }
+
+    const size_t* _dims_data() const
+    {
+        return _dims_v.data();
+    }
+
+    const void* _identifier_ptr() const
+    {
+        return data();
+    }
+
+    // automatically calls at() or part(), depending on its arguments
+    template<typename... Anys>
+    deduce_part_or_elem_type_t<_elem_t, _elem_t, _depth_v, _indexers_t, std::tuple<Anys...>>
+        operator()(Anys&&... anys) &&
+    {
+        constexpr bool is_complete_index = sizeof...(Anys) == _depth_v && is_all_ints_v<Anys...>;
+        if constexpr (is_complete_index)
+            return this->at(std::forward<decltype(anys)>(anys)...);
+        else
+            return this->part(std::forward<decltype(anys)>(anys)...);
+    }
+
+    // automatically calls at() or vpart(), depending on its arguments
+    template<typename... Anys>
+    deduce_array_view_or_elem_type_t<_elem_t&, _elem_t, _depth_v, _indexers_t, std::tuple<Anys...>>
+        operator()(Anys&&... anys) &
+    {
+        constexpr bool is_complete_index = sizeof...(Anys) == _depth_v && is_all_ints_v<Anys...>;
+        if constexpr (is_complete_index)
+            return this->at(std::forward<decltype(anys)>(anys)...);
+        else
+            return this->vpart(std::forward<decltype(anys)>(anys)...);
+    }
+
+    // automatically calls at() or vpart(), depending on its arguments
+    template<typename... Anys>
+    deduce_array_view_or_elem_type_t<const _elem_t&, const _elem_t, _depth_v, _indexers_t, std::tuple<Anys...>>
+        operator()(Anys&&... anys) const &
+    {
+        constexpr bool is_complete_index = sizeof...(Anys) == _depth_v && is_all_ints_v<Anys...>;
+        if constexpr (is_complete_index)
+            return this->at(std::forward<decltype(anys)>(anys)...);
+        else
+            return this->vpart(std::forward<decltype(anys)>(anys)...);
+    }
+
+    // indexing with a tuple/array of integers
+    template<typename Tuple>
+    _elem_t tuple_at(const Tuple& indices) &&
+    {
+        static_assert(std::tuple_size_v<Tuple> == _depth_v, "incorrect number of indices");
+        return data_[_get_position(indices)];
+    }
+
+    // indexing with a tuple/array of integers
+    template<typename Tuple>
+    _elem_t& tuple_at(const Tuple& indices) &
+    {
+        static_assert(std::tuple_size_v<Tuple> == _depth_v, "incorrect number of indices");
+        return data_[_get_position(indices)];
+    }
+
+    // indexing with a tuple/array of integers
+    template<typename Tuple>
+    const _elem_t& tuple_at(const Tuple& indices) const &
+    {
+        static_assert(std::tuple_size_v<Tuple> == _depth_v, "incorrect number of indices");
+        return data_[_get_position(indices)];
+    }
+
+    // indexing with multiple integers
+    template<typename... Ints>
+    _elem_t at(Ints... ints) &&
+    {
+        return std::move(*this).tuple_at(std::make_tuple(ints...));
+    }
+
+    // indexing with multiple integers
+    template<typename... Ints>
+    _elem_t& at(Ints... ints) &
+    {
+        return this->tuple_at(std::make_tuple(ints...));
+    }
+
+    // indexing with multiple integers
+    template<typename... Ints>
+    const _elem_t& at(Ints... ints) const &
+    {
+        return this->tuple_at(std::make_tuple(ints...));
+    }
+
+    // linear accessing
+    _elem_t operator[](size_t pos) &&
+    {
+        NDARRAY_ASSERT(pos < _size_v);
+        return data_[pos];
+    }
+
+    // linear accessing
+    _elem_t& operator[](size_t pos) &
+    {
+        NDARRAY_ASSERT(pos < _size_v);
+        return data_[pos];
+    }
+
+    // linear accessing
+    const _elem_t& operator[](size_t pos) const &
+    {
+        NDARRAY_ASSERT(pos < _size_v);
+        return data_[pos];
+    }
+
+    _elem_t* data()
+    {
+        return data_;
+    }
+    const _elem_t* data() const
+    {
+        return data_;
+    }
+
+    // pointer to the first element, as in simple_view
+    _elem_t* base_ptr()
+    {
+        return data_;
+    }
+    const _elem_t* base_ptr() const
+    {
+        return data_;
+    }
+
+    static constexpr ptrdiff_t stride() noexcept
+    {
+        return 1;
+    }
+
+    _elem_t& _linear_at(size_t pos)
+    {
+        NDARRAY_ASSERT(pos < _size_v);
+        return data_[pos];
+    }
+    const _elem_t& _linear_at(size_t pos) const
+    {
+        NDARRAY_ASSERT(pos < _size_v);
+        return data_[pos];
+    }
+
+    simple_elem_iter<_elem_t> element_begin()
+    {
+        return {data()};
+    }
+    simple_elem_iter<_elem_t> element_end()
+    {
+        return {data() + _size_v};
+    }
+    simple_elem_const_iter<_elem_t> element_cbegin() const
+    {
+        return {data()};
+    }
+    simple_elem_const_iter<_elem_t> element_cend() const
+    {
+        return {data() + _size_v};
+    }
+    simple_elem_const_iter<_elem_t> element_begin() const
+    {
+        return this->element_cbegin();
+    }
+    simple_elem_const_iter<_elem_t> element_end() const
+    {
+        return this->element_cend();
+    }
+
+    template<bool IsExplicitConst, size_t Level>
+    auto _begin_impl()
+    {
+        static_assert(0 < Level && Level <= _depth_v);
+        if constexpr (Level == _depth_v)
+        {
+            return this->element_begin();
+        }
+        else
+        {
+            constexpr size_t ptr_stride = _total_size_impl<_depth_v, Level>();
+            auto sub_view = this->tuple_vpart(repeat_tuple_t<Level, size_t>{});
+            return regular_view_iter<decltype(sub_view), IsExplicitConst>{std::move(sub_view), ptr_stride};
+        }
+    }
+    template<bool IsExplicitConst, size_t Level>
+    auto _end_impl()
+    {
+        static_assert(0 < Level && Level <= _depth_v);
+        if constexpr (Level == _depth_v)
+        {
+            return this->element_end();
+        }
+        else
+        {
+            auto iter = this->template _begin_impl<IsExplicitConst, Level>();
+            iter.my_base_ptr_ref() += _size_v;
+            return iter;
+        }
+    }
+    template<bool IsExplicitConst, size_t Level>
+    auto _begin_impl() const
+    {
+        static_assert(0 < Level && Level <= _depth_v);
+        if constexpr (Level == _depth_v)
+        {
+            return this->element_begin();
+        }
+        else
+        {
+            constexpr size_t ptr_stride = _total_size_impl<_depth_v, Level>();
+            auto sub_view = this->tuple_vpart(repeat_tuple_t<Level, size_t>{});
+            return regular_view_iter<decltype(sub_view), IsExplicitConst>{std::move(sub_view), ptr_stride};
+        }
+    }
+    template<bool IsExplicitConst, size_t Level>
+    auto _end_impl() const
+    {
+        static_assert(0 < Level && Level <= _depth_v);
+        if constexpr (Level == _depth_v)
+        {
+            return this->element_end();
+        }
+        else
+        {
+            auto iter = this->template _begin_impl<IsExplicitConst, Level>();
+            iter.my_base_ptr_ref() += _size_v;
+            return iter;
+        }
+    }
+
+    template<size_t Level = 1>
+    auto begin()
+    {
+        return _begin_impl<false, Level>();
+    }
+    template<size_t Level = 1>
+    auto end()
+    {
+        return _end_impl<false, Level>();
+    }
+    template<size_t Level = 1>
+    auto cbegin() const
+    {
+        return _begin_impl<true, Level>();
+    }
+    template<size_t Level = 1>
+    auto cend() const
+    {
+        return _end_impl<true, Level>();
+    }
+    template<size_t Level = 1>
+    auto begin() const
+    {
+        return cbegin<Level>();
+    }
+    template<size_t Level = 1>
+    auto end() const
+    {
+        return cend<Level>();
+    }
+
+    template<typename SpanTuple>
+    deduce_array_view_type_t<_elem_t, _indexers_t, SpanTuple>
+        tuple_vpart(SpanTuple&& spans) &&
+    {
+        static_assert(_always_false_v<SpanTuple>, "cannot call tuple_vpart() on an r-value fixed_array.");
+    }
+
+    template<typename SpanTuple>
+    deduce_array_view_type_t<_elem_t, _indexers_t, SpanTuple>
+        tuple_vpart(SpanTuple&& spans) &
+    {
+        return get_collapsed_view(
+            data(), _dims_data(), _indexers_t{}, std::forward<decltype(spans)>(spans));
+    }
+
+    template<typename SpanTuple>
+    deduce_array_view_type_t<const _elem_t, _indexers_t, SpanTuple>
+        tuple_vpart(SpanTuple&& spans) const &
+    {
+        return get_collapsed_view(
+            data(), _dims_data(), _indexers_t{}, std::forward<decltype(spans)>(spans));
+    }
+
+    template<typename... Spans>
+    deduce_array_view_type_t<_elem_t, _indexers_t, std::tuple<Spans...>>
+        vpart(Spans&&... spans) &&
+    {
+        static_assert(_always_false_v<Spans...>, "cannot call vpart() on an r-value fixed_array.");
+    }
+
+    template<typename... Spans>
+    deduce_array_view_type_t<_elem_t, _indexers_t, std::tuple<Spans...>>
+        vpart(Spans&&... spans) &
+    {
+        return this->tuple_vpart(std::forward_as_tuple(spans...));
+    }
+
+    template<typename... Spans>
+    deduce_array_view_type_t<const _elem_t, _indexers_t, std::tuple<Spans...>>
+        vpart(Spans&&... spans) const &
+    {
+        return this->tuple_vpart(std::forward_as_tuple(spans...));
+    }
+
+    template<typename SpanTuple>
+    deduce_part_array_type_t<_elem_t, _indexers_t, SpanTuple>
+        tuple_part(SpanTuple&& spans) const
+    {
+        auto view = this->tuple_vpart(std::forward<decltype(spans)>(spans));
+        return make_array(view);
+    }
+
+    template<typename... Spans>
+    deduce_part_array_type_t<_elem_t, _indexers_t, std::tuple<Spans...>>
+        part(Spans&&... spans) const
+    {
+        return this->tuple_part(std::forward_as_tuple(spans...));
+    }
+
+    // check whether having same dimensions with another array, starting at specific levels
+    template<size_t MyStartLevel = 0, size_t OtherStartLevel = 0, typename OtherArray>
+    bool check_size_with(const OtherArray& other) const
+    {
+        if constexpr (MyStartLevel == _depth_v || OtherStartLevel == OtherArray::_depth_v)
+            return false;
+        else if constexpr (MyStartLevel == _depth_v - 1 && OtherStartLevel == OtherArray::_depth_v - 1)
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>();
+        else
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>() &&
+            check_size_with<MyStartLevel + 1, OtherStartLevel + 1>(other);
+    }
+
+    // copy data to destination given size as hint, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst, size_t) const
+    {
+        this->copy_to(dst);
+    }
+
+    // copy data to destination, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst) const
+    {
+        if constexpr (_size_v <= _unrolled_copy_size_v && _is_contiguous_iter_v<Iter>)
+            _unrolled_copy(this->data(), _strided_iter_traits<Iter>::ptr(dst));
+        else
+            _strided_copy_to(this->data(), 1, dst, _size_v);
+    }
+
+    // copy data from source given size as hint, assuming no aliasing
+    template<typename Iter>
+    void copy_from(Iter src, size_t)
+    {
+        this->copy_from(src);
+    }
+
+    // copy data from source, assuming no aliasing
+    template<typename Iter>
+    void copy_from(Iter src)
+    {
+        if constexpr (_size_v <= _unrolled_copy_size_v && _is_contiguous_iter_v<Iter>)
+            _unrolled_copy(_strided_iter_traits<Iter>::ptr(src), this->data());
+        else
+            _strided_copy_from(src, this->data(), 1, _size_v);
+    }
+
+public:
+
+    // element-wise copy with a trip count known at compile time, which
+    // compilers unroll or vectorize without a remainder loop
+    template<typename S, typename D>
+    static void _unrolled_copy(S* src, D* dst)
+    {
+        for (size_t i = 0; i < _size_v; ++i)
+            dst[i] = src[i];
+    }
+
+    template<size_t LastLevel = _depth_v, size_t FirstLevel = 0>
+    static constexpr size_t _total_size_impl()
+    {
+        static_assert(FirstLevel <= LastLevel && LastLevel <= _depth_v);
+        if constexpr (FirstLevel == LastLevel)
+            return size_t(1);
+        else
+            return dimension<LastLevel - 1>() * _total_size_impl<LastLevel - 1, FirstLevel>();
+    }
+
+    template<size_t I = _depth_v - size_t(1), typename Tuple>
+    static size_t _get_position(const Tuple& tuple)
+    {
+        constexpr size_t dim_i = dimension<I>();
+        size_t pos_i = _add_if_negative<size_t>(std::get<I>(tuple), dim_i);
+        NDARRAY_ASSERT(pos_i < dim_i);
+        if constexpr (I == 0)
+            return pos_i;
+        else
+            return pos_i + dim_i * _get_position<I - 1>(tuple);
+    }
+
+};
+
+
+// create array from fixed_array
+template<typename T, size_t... Dims>
+inline auto make_array(const fixed_array<T, Dims...>& arr)
+{
+    return array<T, sizeof...(Dims)>(arr);
+}
+
+}
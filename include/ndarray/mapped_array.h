@@ -0,0 +1,268 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "decls.h"
+#include "traits.h"
+#include "array_ref.h"
+#include "array_interface.h"
+
+namespace ndarray
+{
+
+//
+// mapped_array<T, Depth> maps a file into memory and exposes its elements
+// as an array_ref, so views, spans, iterators and data_copy() work on
+// datasets bigger than the physical memory. It is POSIX only.
+//
+//  type                      file opened   writes
+//---------------------------------------------------------------------
+//  mapped_array<const T, D>  read-only     not allowed
+//  mapped_array<T, D>        read-write    go to the file, and are made
+//                                          durable by flush() or sync()
+//
+// The file must hold the elements from the given byte offset on, which
+// must be a multiple of the alignment of T; a read-write mapping can also
+// create (or truncate) the file with the create_file tag. Errors are thrown
+// as std::system_error.
+//
+// The kernel is advised about the access pattern: the whole mapping is
+// read sequentially once element iterators are created, and the pages of
+// a dense view returned by vpart() or operator() are prefetched.
+//
+// Like an array, a mapped_array cannot be copied or moved while views
+// derived from it refer to its dimensions, so it is neither.
+//
+
+struct create_file_t
+{
+    explicit create_file_t() = default;
+};
+constexpr create_file_t create_file{};
+
+template<typename T, size_t Depth>
+class mapped_array : public array_ref<T, Depth>
+{
+public:
+    using _my_type   = mapped_array;
+    using _base_type = array_ref<T, Depth>;
+    using typename _base_type::_elem_t;
+    using typename _base_type::_dims_t;
+    using _base_type::_depth_v;
+    using _base_type::_is_const_v;
+    static_assert(std::is_trivially_copyable_v<std::remove_const_t<T>>,
+                  "elements of a mapped file must be trivially copyable.");
+
+public:
+    // map an existing file whose elements start at offset bytes
+    mapped_array(const std::string& path, _dims_t dims, size_t offset = 0) :
+        _base_type(nullptr, dims)
+    {
+        this->_map(path, _is_const_v ? O_RDONLY : O_RDWR, offset);
+    }
+
+    // create or truncate a file to hold the elements, which are zero
+    mapped_array(create_file_t, const std::string& path, _dims_t dims) :
+        _base_type(nullptr, dims)
+    {
+        static_assert(!_is_const_v, "cannot create a file for a read-only mapping.");
+        this->_map(path, O_RDWR | O_CREAT | O_TRUNC, 0);
+    }
+
+    mapped_array(const mapped_array&) = delete;
+    mapped_array& operator=(const mapped_array&) = delete;
+
+    ~mapped_array()
+    {
+        if (map_ptr_ != nullptr)
+            ::munmap(map_ptr_, map_size_);
+    }
+
+    // copy data from another view, assuming identical dimensions
+    template<typename View>
+    _my_type& operator=(const View& other)
+    {
+        data_copy(other, static_cast<_base_type&>(*this));
+        return *this;
+    }
+
+    // schedule writing the modified pages back to the file
+    void flush() const
+    {
+        this->_msync(MS_ASYNC);
+    }
+
+    // write the modified pages back to the file and wait for it
+    void sync() const
+    {
+        this->_msync(MS_SYNC);
+    }
+
+    // advise the kernel that the whole mapping is read sequentially
+    void advise_sequential() const
+    {
+        this->_madvise(map_ptr_, map_size_, MADV_SEQUENTIAL);
+    }
+
+    // advise the kernel that the elements of a view into this mapping
+    // are needed soon, if they are dense enough to be worth prefetching
+    template<typename View>
+    void advise_willneed(const View& view) const
+    {
+        constexpr array_obj_type type_v = array_obj_type_of_v<View>;
+        if constexpr (type_v == array_obj_type::simple || type_v == array_obj_type::regular)
+        {
+            const size_t size = view.size();
+            if (size == 0)
+                return;
+            const auto   bounds = _element_address_bounds(view, size);
+            const size_t bytes  = size_t(bounds.second - bounds.first + 1) * sizeof(_elem_t);
+            if (size * sizeof(_elem_t) * _dense_ratio_v >= bytes)
+                this->_madvise(bounds.first, bytes, MADV_WILLNEED);
+        }
+    }
+
+    // automatically calls at() or vpart(), depending on its arguments
+    template<typename... Anys>
+    decltype(auto) operator()(Anys&&... anys) const &
+    {
+        decltype(auto) ret = static_cast<const _base_type&>(*this)(std::forward<Anys>(anys)...);
+        if constexpr (is_array_object_v<decltype(ret)>)
+            this->advise_willneed(ret);
+        return ret;
+    }
+    template<typename... Anys>
+    void operator()(Anys&&... anys) const && = delete;
+
+    template<typename SpanTuple>
+    auto tuple_vpart(SpanTuple&& spans) const &
+    {
+        auto ret = _base_type::tuple_vpart(std::forward<SpanTuple>(spans));
+        this->advise_willneed(ret);
+        return ret;
+    }
+    template<typename SpanTuple>
+    void tuple_vpart(SpanTuple&& spans) const && = delete;
+
+    template<typename... Spans>
+    auto vpart(Spans&&... spans) const &
+    {
+        return this->tuple_vpart(std::forward_as_tuple(spans...));
+    }
+    template<typename... Spans>
+    void vpart(Spans&&... spans) const && = delete;
+
+    auto element_begin() const
+    {
+        this->_advise_sequential_once();
+        return _base_type::element_begin();
+    }
+    auto element_cbegin() const
+    {
+        this->_advise_sequential_once();
+        return _base_type::element_cbegin();
+    }
+
+private:
+    // views spanning more than this many times their elements' bytes are
+    // not prefetched, e.g. a column of a large matrix
+    static constexpr size_t _dense_ratio_v = 4;
+
+    void _map(const std::string& path, int flags, size_t offset)
+    {
+        if (offset % alignof(_elem_t) != 0)
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument),
+                                    "mapped_array: offset " + std::to_string(offset) +
+                                    " is not a multiple of the alignment of the elements");
+        const int fd = ::open(path.c_str(), flags, 0644);
+        if (fd < 0)
+            _throw_errno("mapped_array: cannot open " + path);
+
+        const size_t page_size  = size_t(::sysconf(_SC_PAGESIZE));
+        const size_t map_offset = offset / page_size * page_size;
+        const size_t data_bytes = this->size() * sizeof(_elem_t);
+        const size_t end_bytes  = offset + data_bytes;
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+            _close_and_throw(fd, "mapped_array: cannot stat " + path);
+        if ((flags & O_CREAT) != 0)
+        {
+            if (::ftruncate(fd, off_t(end_bytes)) != 0)
+                _close_and_throw(fd, "mapped_array: cannot resize " + path);
+        }
+        else if (size_t(st.st_size) < end_bytes)
+        {
+            ::close(fd);
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument),
+                                    "mapped_array: " + path + " is smaller than the dimensions");
+        }
+
+        map_size_ = end_bytes - map_offset;
+        if (map_size_ > 0)
+        {
+            const int prot = _is_const_v ? PROT_READ : PROT_READ | PROT_WRITE;
+            void* ptr = ::mmap(nullptr, map_size_, prot, MAP_SHARED, fd, off_t(map_offset));
+            if (ptr == MAP_FAILED)
+                _close_and_throw(fd, "mapped_array: cannot map " + path);
+            map_ptr_ = ptr;
+        }
+        ::close(fd); // the mapping keeps the file open
+        if (map_ptr_ != nullptr)
+            this->data_ = reinterpret_cast<_elem_t*>(static_cast<char*>(map_ptr_) + (offset - map_offset));
+    }
+
+    void _msync(int flags) const
+    {
+        static_assert(!_is_const_v, "a read-only mapping has nothing to write back.");
+        if (map_ptr_ != nullptr && ::msync(map_ptr_, map_size_, flags) != 0)
+            _throw_errno("mapped_array: msync failed");
+    }
+
+    // madvise() on the pages covering [ptr, ptr + bytes); it is only a hint,
+    // so errors are ignored
+    void _madvise(const void* ptr, size_t bytes, int advice) const
+    {
+        if (map_ptr_ == nullptr || bytes == 0)
+            return;
+        const size_t page_size = size_t(::sysconf(_SC_PAGESIZE));
+        const auto   first     = reinterpret_cast<uintptr_t>(ptr) / page_size * page_size;
+        const auto   last      = reinterpret_cast<uintptr_t>(ptr) + bytes;
+        ::madvise(reinterpret_cast<void*>(first), size_t(last - first), advice);
+    }
+
+    void _advise_sequential_once() const
+    {
+        if (!advised_sequential_.exchange(true, std::memory_order_relaxed))
+            this->advise_sequential();
+    }
+
+    [[noreturn]] static void _throw_errno(const std::string& what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    [[noreturn]] static void _close_and_throw(int fd, const std::string& what)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    void*                     map_ptr_  = nullptr;
+    size_t                    map_size_ = 0;
+    mutable std::atomic<bool> advised_sequential_{false};
+};
+
+}
+
@@ -1,19 +1,34 @@
-#pragma once
-
-#include "traits.h"
-#include "array.h"
-#include "span.h"
-#include "indexer.h"
-#include "array_view.h"
-#include "range_view.h"
-
-#include "array_interface.h"
-#include "array_rearrange.h"
-#include "array_construct.h"
-#include "array_functional.h"
-
-namespace ndarray
-{
-
-}
-
+#pragma once
+
+#include "traits.h"
+#include "allocator.h"
+#include "execution.h"
+#include "array.h"
+#include "array_ref.h"
+#include "fixed_array.h"
+#include "span.h"
+#include "indexer.h"
+#include "array_view.h"
+#include "range_view.h"
+
+#include "array_interface.h"
+#include "array_rearrange.h"
+#include "strided_view.h"
+#include "array_construct.h"
+#include "array_functional.h"
+#include "array_reduction.h"
+#include "array_scan.h"
+#include "array_sort.h"
+#include "array_linalg.h"
+#include "npy.h"
+#include "chunked_array.h"
+
+#if __has_include(<sys/mman.h>)
+#include "mapped_array.h"
+#endif
+
+namespace ndarray
+{
+
+}
+
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "decls.h"
+#include "traits.h"
+#include "allocator.h"
+#include "array.h"
+#include "array_interface.h"
+
+#if __has_include(<sys/mman.h>)
+#include "mapped_array.h"
+#endif
+
+namespace ndarray
+{
+
+//
+// Reading and writing NumPy .npy files.
+//
+//  function                    result
+//---------------------------------------------------------------------
+//  load_npy<T, Depth>(path)    array<T, Depth>, converted from any
+//                              bool/integer/float dtype of either byte
+//                              order, in C or Fortran order
+//  map_npy<T, Depth>(path)     mapped_array<T, Depth> over the file
+//                              without copying; the dtype must be T in
+//                              the native byte order, in C order
+//  save_npy(path, a)           writes any array object in C order
+//
+// Errors are thrown as std::runtime_error, or std::system_error by the
+// mapping. map_npy() is only available where mapped_array is.
+//
+// save_npy() writes contiguous elements directly, and streams other array
+// objects through their copy_to() into a fixed-size buffer, so views and
+// expressions are never materialized. bool elements, e.g. of comparisons or
+// std::vector<bool>, are written as one byte each; as array<bool, Depth> is
+// not supported, bool files are loaded with an integer type such as uint8_t.
+//
+
+// description of the data of a .npy file
+struct _npy_header
+{
+    char                kind      = 0;     // 'b', 'i', 'u' or 'f'
+    size_t              item_size = 0;
+    bool                swap      = false; // whether the byte order is not native
+    bool                fortran   = false;
+    std::vector<size_t> shape;
+    size_t              data_offset = 0;   // bytes before the data
+};
+
+constexpr char   _npy_magic[]       = "\x93NUMPY";
+constexpr size_t _npy_magic_size_v  = 6;
+constexpr size_t _npy_align_v       = 64;
+constexpr size_t _npy_buffer_size_v = size_t(1) << 16;
+
+inline bool _is_little_endian()
+{
+    const uint16_t one = 1;
+    unsigned char  first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+[[noreturn]] inline void _npy_error(const std::string& path, const std::string& what)
+{
+    throw std::runtime_error("npy: " + path + ": " + what);
+}
+
+// value of a key in the header dictionary, as the text after "'key':"
+inline std::string _npy_dict_value(const std::string& dict, const std::string& key,
+                                   const std::string& path)
+{
+    const size_t key_pos = dict.find("'" + key + "'");
+    if (key_pos == std::string::npos)
+        _npy_error(path, "missing '" + key + "' in the header");
+    const size_t colon = dict.find(':', key_pos);
+    if (colon == std::string::npos)
+        _npy_error(path, "malformed header");
+    size_t first = dict.find_first_not_of(" ", colon + 1);
+    if (first == std::string::npos)
+        _npy_error(path, "malformed header");
+    size_t last;
+    if (dict[first] == '\'')
+        last = dict.find('\'', first + 1) + 1;
+    else if (dict[first] == '(')
+        last = dict.find(')', first) + 1;
+    else
+        last = dict.find_first_of(",}", first);
+    if (last == std::string::npos || last == 0)
+        _npy_error(path, "malformed header");
+    return dict.substr(first, last - first);
+}
+
+inline _npy_header _read_npy_header(std::istream& in, const std::string& path)
+{
+    char magic[_npy_magic_size_v + 2];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, _npy_magic, _npy_magic_size_v) != 0)
+        _npy_error(path, "not a .npy file");
+    const int major = static_cast<unsigned char>(magic[_npy_magic_size_v]);
+    if (major < 1 || major > 3)
+        _npy_error(path, "unsupported .npy version " + std::to_string(major));
+
+    // header length is 2 bytes in version 1 and 4 bytes later, little endian
+    const size_t   len_size = major == 1 ? 2 : 4;
+    unsigned char  len_bytes[4] = {};
+    if (!in.read(reinterpret_cast<char*>(len_bytes), std::streamsize(len_size)))
+        _npy_error(path, "truncated header");
+    size_t dict_size = 0;
+    for (size_t i = len_size; i > 0; --i)
+        dict_size = dict_size * 256 + len_bytes[i - 1];
+    std::string dict(dict_size, ' ');
+    if (!in.read(&dict[0], std::streamsize(dict_size)))
+        _npy_error(path, "truncated header");
+
+    _npy_header header;
+    header.data_offset = _npy_magic_size_v + 2 + len_size + dict_size;
+
+    const std::string descr = _npy_dict_value(dict, "descr", path);
+    if (descr.size() < 5 || descr.front() != '\'' || descr.back() != '\'')
+        _npy_error(path, "unsupported dtype " + descr);
+    const char order = descr[1];
+    header.kind      = descr[2];
+    header.item_size = size_t(std::stoul(descr.substr(3, descr.size() - 4)));
+    const bool is_known_kind =
+        (header.kind == 'b' && header.item_size == 1) ||
+        ((header.kind == 'i' || header.kind == 'u') &&
+         (header.item_size == 1 || header.item_size == 2 || header.item_size == 4 || header.item_size == 8)) ||
+        (header.kind == 'f' && (header.item_size == 4 || header.item_size == 8));
+    if (!is_known_kind || (order != '<' && order != '>' && order != '|' && order != '='))
+        _npy_error(path, "unsupported dtype " + descr);
+    header.swap = header.item_size > 1 &&
+        ((order == '<' && !_is_little_endian()) || (order == '>' && _is_little_endian()));
+
+    const std::string fortran = _npy_dict_value(dict, "fortran_order", path);
+    if (fortran != "True" && fortran != "False")
+        _npy_error(path, "malformed 'fortran_order' " + fortran);
+    header.fortran = fortran == "True";
+
+    const std::string shape = _npy_dict_value(dict, "shape", path);
+    for (size_t pos = 1; pos < shape.size();)
+    {
+        pos = shape.find_first_of("0123456789", pos);
+        if (pos == std::string::npos)
+            break;
+        size_t len = 0;
+        header.shape.push_back(size_t(std::stoull(shape.substr(pos), &len)));
+        pos += len;
+    }
+    return header;
+}
+
+// convert n items of a file in type S to T
+template<typename S, typename T>
+inline void _npy_convert(const char* src, T* dst, size_t n, bool swap)
+{
+    for (size_t i = 0; i < n; ++i, src += sizeof(S))
+    {
+        char bytes[sizeof(S)];
+        if (swap)
+            for (size_t j = 0; j < sizeof(S); ++j)
+                bytes[j] = src[sizeof(S) - 1 - j];
+        else
+            std::memcpy(bytes, src, sizeof(S));
+        S value;
+        std::memcpy(&value, bytes, sizeof(S));
+        dst[i] = T(value);
+    }
+}
+
+template<typename T>
+inline void _npy_convert(const _npy_header& header, const char* src, T* dst, size_t n)
+{
+    switch (header.kind * 16 + int(header.item_size))
+    {
+    case 'b' * 16 + 1: _npy_convert<bool>    (src, dst, n, false);       break;
+    case 'i' * 16 + 1: _npy_convert<int8_t>  (src, dst, n, false);       break;
+    case 'i' * 16 + 2: _npy_convert<int16_t> (src, dst, n, header.swap); break;
+    case 'i' * 16 + 4: _npy_convert<int32_t> (src, dst, n, header.swap); break;
+    case 'i' * 16 + 8: _npy_convert<int64_t> (src, dst, n, header.swap); break;
+    case 'u' * 16 + 1: _npy_convert<uint8_t> (src, dst, n, false);       break;
+    case 'u' * 16 + 2: _npy_convert<uint16_t>(src, dst, n, header.swap); break;
+    case 'u' * 16 + 4: _npy_convert<uint32_t>(src, dst, n, header.swap); break;
+    case 'u' * 16 + 8: _npy_convert<uint64_t>(src, dst, n, header.swap); break;
+    case 'f' * 16 + 4: _npy_convert<float>   (src, dst, n, header.swap); break;
+    case 'f' * 16 + 8: _npy_convert<double>  (src, dst, n, header.swap); break;
+    default: assert(false); // rejected by _read_npy_header()
+    }
+}
+
+// dtype of T in a .npy header, e.g. '<f8'
+template<typename T>
+inline std::string _npy_descr()
+{
+    static_assert(std::is_arithmetic_v<T>, "only arithmetic types can be saved to .npy files.");
+    static_assert(!std::is_floating_point_v<T> || sizeof(T) == 4 || sizeof(T) == 8,
+                  "only float and double floating-point types can be saved to .npy files.");
+    const char order = sizeof(T) == 1 ? '|' : _is_little_endian() ? '<' : '>';
+    const char kind  = std::is_same_v<T, bool> ? 'b' :
+        std::is_floating_point_v<T> ? 'f' : std::is_signed_v<T> ? 'i' : 'u';
+    return std::string{order, kind} + std::to_string(sizeof(T));
+}
+
+template<typename T>
+inline bool _npy_is_native(const _npy_header& header)
+{
+    return !header.fortran && !header.swap && header.item_size == sizeof(T) &&
+        _npy_descr<T>()[1] == header.kind;
+}
+
+template<size_t Depth>
+inline std::array<size_t, Depth> _npy_dims(const _npy_header& header, const std::string& path)
+{
+    if (header.shape.size() != Depth)
+        _npy_error(path, "expected " + std::to_string(Depth) + " dimensions, found " +
+                   std::to_string(header.shape.size()));
+    std::array<size_t, Depth> dims;
+    std::copy(header.shape.begin(), header.shape.end(), dims.begin());
+    return dims;
+}
+
+// read a .npy file into an array, converting its elements to T
+template<typename T, size_t Depth>
+inline array<T, Depth> load_npy(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        _npy_error(path, "cannot open the file");
+    const _npy_header header = _read_npy_header(in, path);
+    const auto        dims   = _npy_dims<Depth>(header, path);
+
+    // a Fortran-order file holds the elements with reversed dimensions
+    std::array<size_t, Depth> file_dims = dims;
+    if (header.fortran)
+        std::reverse(file_dims.begin(), file_dims.end());
+    array<T, Depth> file_data(default_init, file_dims);
+
+    const size_t size = file_data.size();
+    if (_npy_is_native<T>(header))
+    {
+        if (!in.read(reinterpret_cast<char*>(file_data.data()), std::streamsize(size * sizeof(T))))
+            _npy_error(path, "truncated data");
+    }
+    else
+    {
+        const size_t      items_per_read = std::max(_npy_buffer_size_v / header.item_size, size_t(1));
+        std::vector<char> buffer(items_per_read * header.item_size);
+        for (size_t pos = 0; pos < size; pos += items_per_read)
+        {
+            const size_t n = std::min(items_per_read, size - pos);
+            if (!in.read(buffer.data(), std::streamsize(n * header.item_size)))
+                _npy_error(path, "truncated data");
+            _npy_convert(header, buffer.data(), file_data.data() + pos, n);
+        }
+    }
+
+    if (!header.fortran || Depth == 1)
+        return file_data;
+
+    // the element at (i0, i1, ...) is at i0 + d0 * (i1 + d1 * (...)) in the file
+    array<T, Depth> ret(default_init, dims);
+    std::array<size_t, Depth>    index{};
+    std::array<ptrdiff_t, Depth> strides;
+    ptrdiff_t stride = 1;
+    for (size_t i = 0; i < Depth; ++i)
+    {
+        strides[i] = stride;
+        stride *= ptrdiff_t(dims[i]);
+    }
+    const T* src    = file_data.data();
+    ptrdiff_t offset = 0;
+    for (size_t pos = 0; pos < size; ++pos)
+    {
+        ret.data()[pos] = src[offset];
+        for (size_t i = Depth; i-- > 0;)
+        {
+            offset += strides[i];
+            if (++index[i] < dims[i])
+                break;
+            offset -= strides[i] * ptrdiff_t(dims[i]);
+            index[i] = 0;
+        }
+    }
+    return ret;
+}
+
+#if __has_include(<sys/mman.h>)
+// map a .npy file without copying; the elements are read-only if T is const
+template<typename T, size_t Depth>
+inline mapped_array<T, Depth> map_npy(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        _npy_error(path, "cannot open the file");
+    const _npy_header header = _read_npy_header(in, path);
+    const auto        dims   = _npy_dims<Depth>(header, path);
+    if (!_npy_is_native<std::remove_const_t<T>>(header))
+        _npy_error(path, "cannot be mapped as " + _npy_descr<std::remove_const_t<T>>() +
+                   " in C order, use load_npy() instead");
+    in.close();
+    return mapped_array<T, Depth>(path, dims, header.data_offset);
+}
+#endif
+
+
+// output iterator that writes elements to a file through a buffer; the
+// buffer is not a std::vector, which would pack bool into bits
+template<typename T>
+class _npy_writer
+{
+public:
+    static constexpr size_t _capacity_v = _npy_buffer_size_v / sizeof(T) + 1;
+
+    explicit _npy_writer(std::ofstream& out) :
+        out_{out}, buffer_{new T[_capacity_v]} {}
+
+    ~_npy_writer()
+    {
+        this->flush();
+    }
+
+    void push(const T& value)
+    {
+        buffer_[size_++] = value;
+        if (size_ == _capacity_v)
+            this->flush();
+    }
+
+    void flush()
+    {
+        out_.write(reinterpret_cast<const char*>(buffer_.get()), std::streamsize(size_ * sizeof(T)));
+        size_ = 0;
+    }
+
+    // copies of the iterator share the writer, as copy_to() takes it by value
+    struct iterator
+    {
+        _npy_writer* writer_;
+
+        iterator& operator*()
+        {
+            return *this;
+        }
+        iterator& operator=(const T& value)
+        {
+            writer_->push(value);
+            return *this;
+        }
+        iterator& operator++()
+        {
+            return *this;
+        }
+    };
+
+    iterator begin()
+    {
+        return {this};
+    }
+
+private:
+    std::ofstream&       out_;
+    std::unique_ptr<T[]> buffer_;
+    size_t               size_ = 0;
+};
+
+// write an array object to a .npy file in C order
+template<typename Array>
+inline void save_npy(const std::string& path, const Array& src)
+{
+    using elem_t = std::remove_const_t<array_elem_of_t<Array>>;
+    static_assert(is_array_object_v<Array> || array_obj_type_of_v<Array> == array_obj_type::vector,
+                  "save_npy() takes an array object.");
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        _npy_error(path, "cannot create the file");
+
+    const auto  dims  = dimensions(src);
+    std::string shape = "(";
+    for (size_t i = 0; i < dims.size(); ++i)
+        shape += std::to_string(dims[i]) + (dims.size() == 1 ? ",)" : i + 1 < dims.size() ? ", " : ")");
+    std::string dict = "{'descr': '" + _npy_descr<elem_t>() +
+        "', 'fortran_order': False, 'shape': " + shape + ", }";
+
+    // pad with spaces and a newline to align the data
+    size_t len_size = 2;
+    size_t prefix   = _npy_magic_size_v + 2 + len_size;
+    if (prefix + dict.size() + 1 > 0xffff)
+        prefix = _npy_magic_size_v + 2 + (len_size = 4);
+    const size_t total = (prefix + dict.size() + 1 + _npy_align_v - 1) / _npy_align_v * _npy_align_v;
+    dict.append(total - prefix - dict.size() - 1, ' ');
+    dict.push_back('\n');
+
+    out.write(_npy_magic, std::streamsize(_npy_magic_size_v));
+    const char version[2] = {char(len_size == 2 ? 1 : 2), 0};
+    out.write(version, 2);
+    for (size_t i = 0, n = dict.size(); i < len_size; ++i, n /= 256)
+        out.put(char(n % 256));
+    out.write(dict.data(), std::streamsize(dict.size()));
+
+    constexpr array_obj_type type_v = array_obj_type_of_v<Array>;
+    if constexpr (type_v == array_obj_type::vector && std::is_same_v<elem_t, bool>)
+    { // std::vector<bool> has its elements packed into bits
+        _npy_writer<bool> writer(out);
+        for (bool value : src)
+            writer.push(value);
+    }
+    else if constexpr (type_v == array_obj_type::vector)
+    {
+        out.write(reinterpret_cast<const char*>(src.data()), std::streamsize(src.size() * sizeof(elem_t)));
+    }
+    else if constexpr (type_v == array_obj_type::array || type_v == array_obj_type::simple)
+    { // contiguous elements
+        out.write(reinterpret_cast<const char*>(_fixed_stride_ptr(src)),
+                  std::streamsize(src.size() * sizeof(elem_t)));
+    }
+    else
+    {
+        _npy_writer<elem_t> writer(out);
+        src.copy_to(writer.begin(), src.size());
+    }
+    if (!out.flush())
+        _npy_error(path, "cannot write the file");
+}
+
+}
+
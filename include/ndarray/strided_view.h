@@ -0,0 +1,727 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "decls.h"
+#include "traits.h"
+#include "indexer.h"
+#include "array.h"
+#include "array_view.h"
+#include "array_copy.h"
+#include "array_interface.h"
+
+namespace ndarray
+{
+
+//
+// strided_view<T, Depth> refers to elements at ptr[i0 * s0 + i1 * s1 + ...]
+// with its own dimensions and a pointer stride per level, so the levels of
+// an array can be reordered or reversed in O(1) without copying:
+//
+//  function                  result
+//---------------------------------------------------------------------
+//  make_strided_view(a)      a itself, as a strided_view
+//  vtranspose(a)             levels reversed, a(i, j, k) -> (k, j, i)
+//  vpermute<2, 0, 1>(a)      level i of the result is level Levels[i] of a
+//  vswap_levels<I, J>(a)     levels I and J exchanged
+//  vreverse<Level>(a)        elements along Level in reversed order,
+//                            by a negative stride
+//  vbroadcast(a, 4, 3)       a broadcast to dimensions [4, 3] by NumPy
+//                            rules, read-only, with zero strides on the
+//                            levels it is repeated over
+//  transpose(a), permute<...>(a), swap_levels<I, J>(a), broadcast(a, ...)
+//                            the same, materialized into an array
+//
+// The source can be an array, an array_ref, a std::vector, a strided_view
+// or a view without levels selected by irregular spans; other array
+// objects must be materialized with make_array() first.
+//
+// vpart() with scalar, simple and regular spans (including negative steps)
+// gives another strided_view. data_copy() and make_array() between two
+// objects with fixed pointer strides go through _strided_nd_copy(), which
+// copies in tiles when the innermost levels of the two sides differ.
+//
+// A strided_view keeps its dimensions, so it may outlive the views it is
+// made from, but not the elements. The constness of elements follows T.
+//
+
+template<typename T, size_t Depth>
+class strided_elem_iter
+{
+public:
+    using _my_type   = strided_elem_iter;
+    using _elem_t    = T;
+    using _dims_t    = std::array<size_t, Depth>;
+    using _strides_t = std::array<ptrdiff_t, Depth>;
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = std::remove_const_t<T>;
+    using difference_type   = ptrdiff_t;
+    using pointer           = T*;
+    using reference         = T&;
+
+protected:
+    _elem_t*   base_{};
+    _dims_t    dims_{};
+    _strides_t strides_{};
+    _elem_t*   ptr_{};
+    _dims_t    index_{};
+    size_t     pos_{};
+
+public:
+    strided_elem_iter(_elem_t* base, _dims_t dims, _strides_t strides, size_t pos) :
+        base_{base}, dims_{dims}, strides_{strides}
+    {
+        this->_seek(pos);
+    }
+
+    _my_type& operator++()
+    {
+        ++pos_;
+        for (size_t level = Depth; level-- > 0;)
+        {
+            ptr_ += strides_[level];
+            if (++index_[level] < dims_[level] || level == 0)
+                break;
+            ptr_ -= ptrdiff_t(dims_[level]) * strides_[level];
+            index_[level] = 0;
+        }
+        return *this;
+    }
+    _my_type& operator--()
+    {
+        this->_seek(pos_ - 1);
+        return *this;
+    }
+    _my_type operator++(int)
+    {
+        _my_type ret = *this;
+        ++(*this);
+        return ret;
+    }
+    _my_type operator--(int)
+    {
+        _my_type ret = *this;
+        --(*this);
+        return ret;
+    }
+    template<typename Diff>
+    _my_type& operator+=(Diff diff)
+    {
+        this->_seek(size_t(ptrdiff_t(pos_) + ptrdiff_t(diff)));
+        return *this;
+    }
+    template<typename Diff>
+    _my_type& operator-=(Diff diff)
+    {
+        this->_seek(size_t(ptrdiff_t(pos_) - ptrdiff_t(diff)));
+        return *this;
+    }
+    template<typename Diff>
+    _my_type operator+(Diff diff) const
+    {
+        _my_type ret = *this;
+        ret += diff;
+        return ret;
+    }
+    template<typename Diff>
+    _my_type operator-(Diff diff) const
+    {
+        _my_type ret = *this;
+        ret -= diff;
+        return ret;
+    }
+
+    _elem_t& operator*() const
+    {
+        return *ptr_;
+    }
+    template<typename Diff>
+    _elem_t& operator[](Diff diff) const
+    {
+        return *((*this) + diff);
+    }
+    ptrdiff_t operator-(const _my_type& other) const
+    {
+        return ptrdiff_t(pos_) - ptrdiff_t(other.pos_);
+    }
+
+    bool operator==(const _my_type& other) const
+    {
+        return pos_ == other.pos_;
+    }
+    bool operator!=(const _my_type& other) const
+    {
+        return pos_ != other.pos_;
+    }
+    bool operator<(const _my_type& other) const
+    {
+        return pos_ < other.pos_;
+    }
+    bool operator>(const _my_type& other) const
+    {
+        return pos_ > other.pos_;
+    }
+    bool operator<=(const _my_type& other) const
+    {
+        return pos_ <= other.pos_;
+    }
+    bool operator>=(const _my_type& other) const
+    {
+        return pos_ >= other.pos_;
+    }
+
+private:
+    // move to the pos-th element in row-major order
+    void _seek(size_t pos)
+    {
+        pos_   = pos;
+        ptr_   = base_;
+        index_ = _dims_t{};
+        for (size_t level = 1; level < Depth; ++level)
+            if (dims_[level] == 0)
+                return;
+        for (size_t level = Depth - 1; level > 0; --level)
+        {
+            index_[level] = pos % dims_[level];
+            pos /= dims_[level];
+            ptr_ += ptrdiff_t(index_[level]) * strides_[level];
+        }
+        index_[0] = pos;
+        ptr_ += ptrdiff_t(pos) * strides_[0];
+    }
+};
+
+
+template<typename T, size_t Depth>
+class strided_view
+{
+public:
+    using _my_type         = strided_view;
+    using _elem_t          = T;
+    using _no_const_elem_t = std::remove_const_t<_elem_t>;
+    static constexpr size_t _depth_v    = Depth;
+    static constexpr bool   _is_const_v = std::is_const_v<_elem_t>;
+    using _dims_t          = std::array<size_t, _depth_v>;
+    using _strides_t       = std::array<ptrdiff_t, _depth_v>;
+    static_assert(_depth_v > 0);
+
+public:
+    _elem_t*   data_{};
+    _dims_t    dims_{};
+    _strides_t strides_{};
+
+public:
+    strided_view(_elem_t* data, _dims_t dims, _strides_t strides) :
+        data_{data}, dims_{dims}, strides_{strides} {}
+
+    strided_view(const strided_view&) = default;
+
+    // strided_view<const T> from strided_view<T>
+    template<typename U, typename = std::enable_if_t<std::is_same_v<const U, _elem_t>>>
+    strided_view(const strided_view<U, Depth>& other) :
+        data_{other.data_}, dims_{other.dims_}, strides_{other.strides_} {}
+
+    // copy data from another view, assuming identical dimensions
+    template<typename View>
+    _my_type& operator=(const View& other)
+    {
+        data_copy(other, *this);
+        return *this;
+    }
+
+    _my_type& operator=(const strided_view& other)
+    {
+        data_copy(other, *this);
+        return *this;
+    }
+
+    // total size of the view
+    size_t size() const
+    {
+        size_t size = 1;
+        for (size_t level = 0; level < _depth_v; ++level)
+            size *= dims_[level];
+        return size;
+    }
+
+    // dimension of the view on the i-th level
+    template<size_t I>
+    size_t dimension() const
+    {
+        static_assert(I < _depth_v);
+        return dims_[I];
+    }
+
+    // array of dimensions
+    _dims_t dimensions() const
+    {
+        return dims_;
+    }
+
+    // array of pointer strides, in elements
+    _strides_t strides() const
+    {
+        return strides_;
+    }
+
+    // pointer to the element at (0, 0, ...)
+    _elem_t* data() const
+    {
+        return data_;
+    }
+
+    // pointer to the element at (0, 0, ...), as in other views
+    _elem_t* base_ptr() const
+    {
+        return data_;
+    }
+
+    const size_t* _identifier_ptr() const
+    {
+        return dims_.data();
+    }
+
+    // automatically calls at() or vpart(), depending on its arguments
+    template<typename... Anys>
+    decltype(auto) operator()(Anys&&... anys) const
+    {
+        constexpr bool is_complete_index = sizeof...(Anys) == _depth_v && is_all_ints_v<Anys...>;
+        if constexpr (is_complete_index)
+            return this->at(std::forward<decltype(anys)>(anys)...);
+        else
+            return this->vpart(std::forward<decltype(anys)>(anys)...);
+    }
+
+    // indexing with a tuple/array of integers
+    template<typename Tuple>
+    _elem_t& tuple_at(const Tuple& indices) const
+    {
+        static_assert(std::tuple_size_v<Tuple> == _depth_v, "incorrect number of indices");
+        return data_[this->_get_offset(indices, std::make_index_sequence<_depth_v>{})];
+    }
+
+    // indexing with multiple integers
+    template<typename... Ints>
+    _elem_t& at(Ints... ints) const
+    {
+        return this->tuple_at(std::make_tuple(ints...));
+    }
+
+    strided_elem_iter<_elem_t, _depth_v> element_begin() const
+    {
+        return {data_, dims_, strides_, 0};
+    }
+    strided_elem_iter<_elem_t, _depth_v> element_end() const
+    {
+        return {data_, dims_, strides_, size()};
+    }
+    strided_elem_iter<const _elem_t, _depth_v> element_cbegin() const
+    {
+        return {data_, dims_, strides_, 0};
+    }
+    strided_elem_iter<const _elem_t, _depth_v> element_cend() const
+    {
+        return {data_, dims_, strides_, size()};
+    }
+
+    // a strided_view of the elements selected by scalar, simple or regular spans
+    template<typename SpanTuple>
+    auto tuple_vpart(const SpanTuple& spans) const
+    {
+        constexpr size_t n_spans_v = std::tuple_size_v<SpanTuple>;
+        static_assert(n_spans_v <= _depth_v, "Too many span specifications.");
+        constexpr size_t depth_v = span_tuple_depth_v<SpanTuple> + (_depth_v - n_spans_v);
+        static_assert(depth_v > 0, "use at() to access a single element.");
+
+        strided_view<_elem_t, depth_v> ret{data_, {}, {}};
+        this->_collapse_levels(spans, ret, std::make_index_sequence<_depth_v>{});
+        return ret;
+    }
+
+    template<typename... Spans>
+    auto vpart(Spans&&... spans) const
+    {
+        return this->tuple_vpart(std::forward_as_tuple(spans...));
+    }
+
+    template<typename SpanTuple>
+    auto tuple_part(const SpanTuple& spans) const
+    {
+        return make_array(this->tuple_vpart(spans));
+    }
+
+    template<typename... Spans>
+    auto part(Spans&&... spans) const
+    {
+        return this->tuple_part(std::forward_as_tuple(spans...));
+    }
+
+    // check whether having same dimensions with another array, starting at specific levels
+    template<size_t MyStartLevel = 0, size_t OtherStartLevel = 0, typename OtherArray>
+    bool check_size_with(const OtherArray& other) const
+    {
+        if constexpr (MyStartLevel == _depth_v || OtherStartLevel == OtherArray::_depth_v)
+            return false;
+        else if constexpr (MyStartLevel == _depth_v - 1 && OtherStartLevel == OtherArray::_depth_v - 1)
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>();
+        else
+            return this->template dimension<MyStartLevel>() == other.template dimension<OtherStartLevel>() &&
+            check_size_with<MyStartLevel + 1, OtherStartLevel + 1>(other);
+    }
+
+    // the same elements with the levels reordered: level i of the result is
+    // level levels[i] of this view
+    strided_view _permuted(const std::array<size_t, _depth_v>& levels) const
+    {
+        strided_view ret{data_, {}, {}};
+        for (size_t i = 0; i < _depth_v; ++i)
+        {
+            NDARRAY_ASSERT(levels[i] < _depth_v);
+            ret.dims_[i]    = dims_[levels[i]];
+            ret.strides_[i] = strides_[levels[i]];
+        }
+        return ret;
+    }
+
+    // the same elements in reversed order along a level
+    strided_view _reversed(size_t level) const
+    {
+        strided_view ret = *this;
+        if (dims_[level] > 0)
+            ret.data_ += ptrdiff_t(dims_[level] - 1) * strides_[level];
+        ret.strides_[level] = -strides_[level];
+        return ret;
+    }
+
+    // passes the elements in order as runs of fn(ptr, stride, len), where a
+    // run spans the last level, merged with outer levels that continue it
+    template<typename Function>
+    void traverse_runs(Function fn) const
+    {
+        if (this->size() == 0)
+            return;
+
+        // merge levels from the last one while they continue each other
+        size_t    inner_level  = _depth_v - 1;
+        size_t    inner_len    = dims_[inner_level];
+        ptrdiff_t inner_stride = strides_[inner_level];
+        while (inner_level > 0)
+        {
+            const size_t    dim    = dims_[inner_level - 1];
+            const ptrdiff_t stride = strides_[inner_level - 1];
+            if (dim == 1)
+                ;
+            else if (inner_len == 1)
+                inner_stride = stride, inner_len = dim;
+            else if (stride == ptrdiff_t(inner_len) * inner_stride)
+                inner_len *= dim;
+            else
+                break;
+            --inner_level;
+        }
+
+        _dims_t index{};
+        _elem_t* ptr = data_;
+        for (;;)
+        {
+            fn(ptr, inner_stride, inner_len);
+
+            size_t level = inner_level;
+            for (; level > 0; --level)
+            {
+                const size_t l = level - 1;
+                ptr += strides_[l];
+                if (++index[l] < dims_[l])
+                    break;
+                ptr -= ptrdiff_t(dims_[l]) * strides_[l];
+                index[l] = 0;
+            }
+            if (level == 0)
+                return;
+        }
+    }
+
+    // least and greatest offsets of the elements from data(), or (0, -1)
+    // if the view is empty
+    std::pair<ptrdiff_t, ptrdiff_t> _offset_bounds() const
+    {
+        if (this->size() == 0)
+            return {0, -1};
+        std::pair<ptrdiff_t, ptrdiff_t> bounds{0, 0};
+        for (size_t level = 0; level < _depth_v; ++level)
+        {
+            const ptrdiff_t last = ptrdiff_t(dims_[level] - 1) * strides_[level];
+            bounds.first  += std::min<ptrdiff_t>(last, 0);
+            bounds.second += std::max<ptrdiff_t>(last, 0);
+        }
+        return bounds;
+    }
+
+    // copy data to destination, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst) const
+    {
+        auto copy_to_fn = [&dst](_elem_t* ptr, ptrdiff_t stride, size_t len)
+        {
+            if constexpr (_strided_iter_traits<Iter>::value)
+            {
+                _strided_copy_to(ptr, stride, dst, len);
+                dst += ptrdiff_t(len);
+            }
+            else
+            {
+                for (size_t i = 0; i < len; ++i, ++dst, ptr += stride)
+                    *dst = *ptr;
+            }
+        };
+        this->template traverse_runs<decltype((copy_to_fn))>(copy_to_fn); // pass by reference type
+    }
+
+    // copy data to destination with size ignored, assuming no aliasing
+    template<typename Iter>
+    void copy_to(Iter dst, size_t) const
+    {
+        this->copy_to(dst);
+    }
+
+    // copy data from source, assuming no aliasing
+    template<typename Iter>
+    void copy_from(Iter src) const
+    {
+        static_assert(!_is_const_v);
+        auto copy_from_fn = [&src](_elem_t* ptr, ptrdiff_t stride, size_t len)
+        {
+            if constexpr (_strided_iter_traits<Iter>::value)
+            {
+                _strided_copy_from(src, ptr, stride, len);
+                src += ptrdiff_t(len);
+            }
+            else
+            {
+                for (size_t i = 0; i < len; ++i, ++src, ptr += stride)
+                    *ptr = *src;
+            }
+        };
+        this->template traverse_runs<decltype((copy_from_fn))>(copy_from_fn); // pass by reference type
+    }
+
+    // copy data from source with size ignored, assuming no aliasing
+    template<typename Iter>
+    void copy_from(Iter src, size_t) const
+    {
+        this->copy_from(src);
+    }
+
+private:
+    template<typename Tuple, size_t... Levels>
+    ptrdiff_t _get_offset(const Tuple& indices, std::index_sequence<Levels...>) const
+    {
+        return (ptrdiff_t(0) + ... + (ptrdiff_t(this->template _get_level_pos<Levels>(indices)) * strides_[Levels]));
+    }
+
+    template<size_t Level, typename Tuple>
+    size_t _get_level_pos(const Tuple& indices) const
+    {
+        const size_t pos = _add_if_negative<size_t>(std::get<Level>(indices), dims_[Level]);
+        NDARRAY_ASSERT(pos < dims_[Level]);
+        return pos;
+    }
+
+    template<typename SpanTuple, typename Result, size_t... Levels>
+    void _collapse_levels(const SpanTuple& spans, Result& ret, std::index_sequence<Levels...>) const
+    {
+        size_t new_level = 0;
+        (this->template _collapse_level<Levels>(spans, ret, new_level), ...);
+    }
+
+    // moves ret.data_ to the first element selected on a level, and adds
+    // the level to ret unless it is selected by a scalar
+    template<size_t Level, typename SpanTuple, typename Result>
+    void _collapse_level(const SpanTuple& spans, Result& ret, size_t& new_level) const
+    {
+        using span_t = remove_cvref_t<decltype(_take_ith_span<Level>(spans))>;
+        static_assert(classify_span_type_v<span_t> != span_type::irregular,
+                      "a strided_view cannot be indexed by an irregular span.");
+        const auto collapsed = collapse_indexer(dims_[Level], all_indexer{}, _take_ith_span<Level>(spans));
+        ret.data_ += ptrdiff_t(collapsed.first) * strides_[Level];
+        if constexpr (!std::is_same_v<remove_cvref_t<decltype(collapsed.second)>, scalar_indexer>)
+        {
+            ret.dims_[new_level]    = collapsed.second.size(dims_[Level]);
+            ret.strides_[new_level] = strides_[Level] * collapsed.second.step();
+            ++new_level;
+        }
+    }
+};
+
+
+// create array from strided_view
+template<typename T, size_t Depth>
+inline auto make_array(const strided_view<T, Depth>& view)
+{
+    array<std::remove_const_t<T>, Depth> ret(default_init, view.dimensions());
+    no_alias_data_copy(view, ret, ret.size());
+    return ret;
+}
+
+// refer to the elements of an array object with fixed pointer strides on
+// each level as a strided_view
+template<typename Array>
+inline auto make_strided_view(Array&& src)
+{
+    using array_t = remove_cvref_t<Array>;
+    constexpr array_obj_type type_v = array_obj_type_of_v<array_t>;
+    static_assert(!std::is_rvalue_reference_v<Array&&> ||
+                  (type_v != array_obj_type::array && type_v != array_obj_type::vector),
+                  "cannot refer to the elements of an r-value array.");
+    static_assert(_is_strided_operand<array_t>(),
+                  "elements must have fixed pointer strides on each level; call make_array() first.");
+    const auto layout = _operand_layout(src);
+    using elem_t = std::remove_pointer_t<remove_cvref_t<decltype(layout.first)>>;
+    return strided_view<elem_t, array_depth_of_v<array_t>>{layout.first, ndarray::dimensions(src), layout.second};
+}
+
+template<size_t... Levels>
+constexpr bool _is_level_permutation()
+{
+    constexpr size_t n = sizeof...(Levels);
+    const size_t levels[] = {Levels...};
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (levels[i] >= n)
+            return false;
+        for (size_t j = 0; j < i; ++j)
+            if (levels[j] == levels[i])
+                return false;
+    }
+    return true;
+}
+
+// the levels of an array object in reversed order, without copying
+template<typename Array>
+inline auto vtranspose(Array&& src)
+{
+    const auto view = make_strided_view(std::forward<Array>(src));
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    std::array<size_t, depth_v> levels{};
+    for (size_t i = 0; i < depth_v; ++i)
+        levels[i] = depth_v - 1 - i;
+    return view._permuted(levels);
+}
+
+// the levels of an array object reordered, where level i of the result is
+// level Levels[i] of src, without copying
+template<size_t... Levels, typename Array>
+inline auto vpermute(Array&& src)
+{
+    static_assert(sizeof...(Levels) == array_depth_of_v<Array> && _is_level_permutation<Levels...>(),
+                  "Levels must be a permutation of the levels of the array.");
+    const auto view = make_strided_view(std::forward<Array>(src));
+    return view._permuted({Levels...});
+}
+
+// two levels of an array object exchanged, without copying
+template<size_t I, size_t J, typename Array>
+inline auto vswap_levels(Array&& src)
+{
+    constexpr size_t depth_v = array_depth_of_v<Array>;
+    static_assert(I < depth_v && J < depth_v, "level out of range");
+    const auto view = make_strided_view(std::forward<Array>(src));
+    std::array<size_t, depth_v> levels{};
+    for (size_t i = 0; i < depth_v; ++i)
+        levels[i] = i;
+    std::swap(levels[I], levels[J]);
+    return view._permuted(levels);
+}
+
+// the elements of an array object in reversed order along a level, without copying
+template<size_t Level = 0, typename Array>
+inline auto vreverse(Array&& src)
+{
+    static_assert(Level < array_depth_of_v<Array>, "level out of range");
+    const auto view = make_strided_view(std::forward<Array>(src));
+    return view._reversed(Level);
+}
+
+// src broadcast to the given dimensions, without copying: the levels of src
+// are aligned to the last ones, and each must have the same dimension or 1;
+// levels of size 1 and the missing leading levels repeat their elements
+// with a zero stride
+template<typename Array, typename... Ints>
+inline auto vbroadcast(Array&& src, Ints... dims)
+{
+    constexpr size_t src_depth_v = array_depth_of_v<Array>;
+    constexpr size_t depth_v     = sizeof...(Ints);
+    static_assert(src_depth_v <= depth_v, "cannot broadcast to fewer levels.");
+    const auto view = make_strided_view(std::forward<Array>(src));
+    using elem_t = const typename decltype(view)::_no_const_elem_t;
+    strided_view<elem_t, depth_v> ret{view.data_, {size_t(dims)...}, {}};
+    for (size_t level = 0; level < src_depth_v; ++level)
+    {
+        const size_t ret_level = level + (depth_v - src_depth_v);
+        NDARRAY_ASSERT(view.dims_[level] == ret.dims_[ret_level] || view.dims_[level] == 1);
+        if (view.dims_[level] == ret.dims_[ret_level])
+            ret.strides_[ret_level] = view.strides_[level];
+    }
+    return ret;
+}
+
+// an array of the levels of src in reversed order
+template<typename Array>
+inline auto transpose(const Array& src)
+{
+    return make_array(vtranspose(src));
+}
+template<typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto transpose(ExecutionPolicy&& policy, const Array& src)
+{
+    return make_array(policy, vtranspose(src));
+}
+
+// an array of the levels of src reordered, where level i is level Levels[i] of src
+template<size_t... Levels, typename Array>
+inline auto permute(const Array& src)
+{
+    return make_array(vpermute<Levels...>(src));
+}
+template<size_t... Levels, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto permute(ExecutionPolicy&& policy, const Array& src)
+{
+    return make_array(policy, vpermute<Levels...>(src));
+}
+
+// an array of src with levels I and J exchanged
+template<size_t I, size_t J, typename Array>
+inline auto swap_levels(const Array& src)
+{
+    return make_array(vswap_levels<I, J>(src));
+}
+template<size_t I, size_t J, typename ExecutionPolicy, typename Array,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto swap_levels(ExecutionPolicy&& policy, const Array& src)
+{
+    return make_array(policy, vswap_levels<I, J>(src));
+}
+
+// an array of src broadcast to the given dimensions
+template<typename Array, typename... Ints,
+         std::enable_if_t<!is_execution_policy_v<Array>, int> = 0>
+inline auto broadcast(const Array& src, Ints... dims)
+{
+    return make_array(vbroadcast(src, dims...));
+}
+template<typename ExecutionPolicy, typename Array, typename... Ints,
+         _enable_if_execution_policy_t<ExecutionPolicy> = 0>
+inline auto broadcast(ExecutionPolicy&& policy, const Array& src, Ints... dims)
+{
+    return make_array(policy, vbroadcast(src, dims...));
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+
+//
+// Minimal checking helpers shared by the test programs in this directory.
+// Each test is a standalone program that returns non-zero on failure:
+//
+//     g++ -std=c++17 -O1 -pthread -Iinclude test/test_xxx.cpp && ./a.out
+//
+
+inline int& _check_failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(expr)                                                          \
+    do                                                                       \
+    {                                                                        \
+        if (!(expr))                                                         \
+        {                                                                    \
+            ++_check_failures();                                             \
+            std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #expr); \
+        }                                                                    \
+    } while (0)
+
+inline int check_result(const char* name)
+{
+    std::printf("%s: %d failure(s)\n", name, _check_failures());
+    return _check_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+template<typename T, size_t Depth>
+array<T, Depth> iota_array(const std::array<size_t, Depth>& dims)
+{
+    array<T, Depth> a(dims);
+    std::iota(a.data(), a.data() + a.size(), T(1));
+    return a;
+}
+
+template<typename T, size_t Depth>
+bool same_array(const array<T, Depth>& a, const array<T, Depth>& b)
+{
+    return a.dimensions() == b.dimensions() && std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+// assign(a) copies a part of a into another part of a; the result is that
+// of the same assignment from a copy of a, made with seq and with par
+template<typename T, size_t Depth, typename Assign, typename ParAssign>
+bool same_as_unaliased(const array<T, Depth>& a, Assign assign, ParAssign par_assign)
+{
+    auto aliased = a;
+    assign(aliased, aliased);
+    auto unaliased = a;
+    const auto source = a;
+    assign(unaliased, source);
+    auto par_aliased = a;
+    par_assign(par_aliased, par_aliased);
+    return same_array(aliased, unaliased) && same_array(par_aliased, unaliased) &&
+           !same_array(aliased, a);
+}
+
+// the same assignment written as operator= and as data_copy(par, ...)
+#define ASSIGNMENT(dst_part, src_part)                                                      \
+    [&](auto& dst, const auto& src) { dst dst_part = src src_part; },                     \
+    [&](auto& dst, const auto& src) { auto view = dst dst_part; data_copy(par, src src_part, view); }
+
+void test_one_level(size_t n)
+{
+    const auto a = iota_array<double, 1>({n});
+    const std::vector<size_t> list{3, 0, 4, 1, 2, 5};
+    const std::vector<size_t> shifted{1, 2, 3, 4, 5, 6};
+
+    // forward and backward overlap of views of the same type
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(1, n)), (span(0, n - 1)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, n - 1)), (span(1, n)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(5, n)), (span(0, n - 5)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, n - 5)), (span(5, n)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(2, 0, 2)), (span(0, n - 2, 2)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, n - 2, 2)), (span(2, 0, 2)))));
+
+    // negative and mismatched strides
+    CHECK(same_as_unaliased(a, ASSIGNMENT((Reversed), (span()))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, n - 3)), (span(-1, 2, -1)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, 0, 2)), (span(0, (n + 1) / 2)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(n / 2, n)), (span(0, 0, 2)))));
+
+    // index lists on either side, or both
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(list)), (span(0, 6)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, 6)), (span(list)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(shifted)), (span(list)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(list)), (span(shifted)))));
+}
+
+void test_two_levels(size_t n)
+{
+    const auto a = iota_array<int, 2>({n, n});
+    const std::vector<size_t> rows{2, 0, 1};
+    const std::vector<size_t> next_rows{1, 2, 3};
+
+    // a column from a row, and a row from a column, which share one element
+    CHECK(same_as_unaliased(a, ASSIGNMENT((All, 0), (0))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((0), (All, 0))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((All, n - 1), (n - 1, Reversed))));
+
+    // overlapping blocks of rows, forward and backward
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(1, n)), (span(0, n - 1)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, n - 1), span(1, n)), (span(1, n), span(0, n - 1)))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(1, n), span(1, n)), (span(0, n - 1), span(0, n - 1)))));
+
+    // the transpose, and irregular views
+    CHECK(same_as_unaliased(a,
+        [&](auto& dst, const auto& src) { dst(span(), span()) = vtranspose(src); },
+        [&](auto& dst, const auto& src) { auto view = dst(span(), span()); data_copy(par, vtranspose(src), view); }));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(rows), span()), (span(next_rows), span()))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(next_rows), Reversed), (span(0, 3), span()))));
+    CHECK(same_as_unaliased(a, ASSIGNMENT((span(0, 3), span(rows)), (span(next_rows), span(0, 3)))));
+}
+
+int main()
+{
+    for (size_t n : {8, 31, 300})
+    {
+        test_one_level(n);
+        test_two_levels(n);
+    }
+
+    // an assignment between views of the same type copies the elements,
+    // and a copy of a view refers to the same elements
+    {
+        auto a = iota_array<double, 1>({10});
+        auto dst = a(span(1, 10));
+        const auto src = a(span(0, 9));
+        auto same = dst;
+        dst = src;
+        CHECK(a.at(0) == 1.0 && a.at(1) == 1.0 && a.at(9) == 9.0 && same.at(0) == 1.0);
+        auto moved = std::move(same);
+        CHECK(moved.at(8) == 9.0 && &moved.at(0) == &a.at(1));
+    }
+
+    // the scratch buffer grows, and is released after a large copy
+    {
+        auto big = iota_array<float, 2>({2048, 2048});
+        const auto expected = make_array(vtranspose(big));
+        big = vtranspose(big);
+        CHECK(same_array(big, expected));
+        auto small = iota_array<float, 2>({4, 4});
+        small = vtranspose(small);
+        CHECK(small.at(1, 0) == 2.0f && small.at(3, 2) == 12.0f);
+    }
+
+    return check_result("test_alias");
+}
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// arrays with a custom allocator behave as arrays with std::allocator, and
+// the vector overloads accept std::vector with any allocator
+template<typename Alloc>
+void test_allocator(const Alloc& alloc)
+{
+    array<int, 2, Alloc> a({3, 4}, alloc);
+    CHECK(a.size() == 12 && a.at(2, 3) == 0);
+    std::iota(a.data(), a.data() + a.size(), 0);
+    CHECK(sum(a) == 66);
+
+    array<int, 2> ref({3, 4});
+    std::iota(ref.data(), ref.data() + ref.size(), 0);
+    CHECK(std::equal(a.data(), a.data() + 12, ref.data()));
+
+    auto r = reshape<1>(std::move(a), {12});
+    static_assert(std::is_same_v<decltype(r), array<int, 1, Alloc>>);
+    CHECK(r.at(11) == 11);
+
+    std::vector<int, Alloc> vec = get_vector(std::move(r));
+    CHECK(vec.size() == 12 && vec[5] == 5);
+    CHECK(dimensions(vec)[0] == 12);
+    std::vector<int, Alloc> copy = get_vector(vec);
+    CHECK(copy == vec);
+
+    auto b = make_array(std::move(vec));
+    static_assert(std::is_same_v<decltype(b), array<int, 1, Alloc>>);
+    CHECK(b.size() == 12 && b.at(7) == 7);
+
+    array<double, 1, typename std::allocator_traits<Alloc>::template rebind_alloc<double>>
+        d(default_init, std::array<size_t, 1>{5});
+    d = range(5.0);
+    CHECK(d.at(4) == 4.0);
+}
+
+int main()
+{
+    test_allocator(std::allocator<int>());
+    test_allocator(aligned_allocator<int>());
+    test_allocator(aligned_allocator<int, 256>());
+    test_allocator(huge_page_allocator<int>());
+    test_allocator(pool_allocator<int>());
+    memory_pool pool;
+    test_allocator(pool_allocator<int>(pool));
+    test_allocator(default_init_allocator<int>());
+    test_allocator(default_init_allocator<int, aligned_allocator<int>>());
+
+    // the default storage is a std::vector, which moves in and out of an
+    // array without a copy
+    static_assert(std::is_same_v<array<int, 2>, array<int, 2, std::allocator<int>>>);
+    {
+        std::vector<int> vec(1000, 3);
+        const int* const data = vec.data();
+        auto a = make_array(std::move(vec));
+        static_assert(std::is_same_v<decltype(a), array<int, 1>>);
+        CHECK(a.data() == data && a.at(999) == 3);
+        std::vector<int> back = get_vector(std::move(a));
+        static_assert(std::is_same_v<decltype(get_vector(std::move(a))), std::vector<int>>);
+        CHECK(back.data() == data && back.size() == 1000);
+        array<int, 2> b(std::move(back), {10, 100});
+        CHECK(b.data() == data && b.at(9, 99) == 3);
+    }
+
+    // the plain constructors and resize() value-initialize
+    array<int, 2> z({50, 50});
+    CHECK(std::all_of(z.data(), z.data() + z.size(), [](int x) { return x == 0; }));
+    z.dims_ = {60, 60};
+    z.resize();
+    CHECK(std::all_of(z.data(), z.data() + z.size(), [](int x) { return x == 0; }));
+    std::vector<int, default_init_allocator<int>> other(6, 7);
+    array<int, 2> fp(other, {2, 3});
+    CHECK(fp.at(1, 2) == 7);
+    CHECK(table_const(3, 2, 2).at(1, 1) == 3);
+
+    // aligned storage is aligned
+    array<float, 1, aligned_allocator<float, 128>> f(std::array<size_t, 1>{100});
+    CHECK(reinterpret_cast<uintptr_t>(f.data()) % 128 == 0);
+    return check_result("test_allocator");
+}
@@ -0,0 +1,118 @@
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// a buffer of n doubles 1, 2, ...
+std::vector<double> iota_buffer(size_t n)
+{
+    std::vector<double> buffer(n);
+    std::iota(buffer.begin(), buffer.end(), 1.0);
+    return buffer;
+}
+
+// copy from src to dst, which overlap in buffer, against the same copy from
+// the elements of src gathered first
+template<typename Copy>
+bool same_as_unaliased(size_t n, Copy copy)
+{
+    auto aliased = iota_buffer(n);
+    copy(aliased.data(), aliased.data());
+    auto unaliased = iota_buffer(n);
+    const auto source = iota_buffer(n);
+    copy(const_cast<double*>(source.data()), unaliased.data());
+    return aliased == unaliased && aliased != iota_buffer(n);
+}
+
+int main()
+{
+    // an external buffer, through vpart(), at() and iterators
+    {
+        double buffer[60];
+        std::iota(buffer, buffer + 60, 0.0);
+        auto r = make_array_ref(buffer, 3, 4, 5);
+        static_assert(std::is_same_v<decltype(r), array_ref<double, 3>>);
+        CHECK(r.data() == buffer && r.size() == 60);
+        CHECK(r.at(2, 3, 4) == 59.0 && r.at(-1, 0, -2) == 43.0 && r(1, 2, 3) == 33.0);
+
+        const auto row = r.vpart(1, 2);
+        CHECK(row.size() == 5 && row.at(0) == 30.0 && &row.at(4) == buffer + 34);
+        const std::vector<size_t> cols{4, 0};
+        const auto irregular = r.vpart(span(), -1, span(cols));
+        CHECK(irregular.at(0, 0) == 19.0 && irregular.at(2, 1) == 55.0);
+        CHECK(r.vpart(Reversed, 0, 0).at(0) == 40.0);
+
+        double total = 0;
+        size_t count = 0;
+        for (auto iter = r.element_cbegin(); iter != r.element_cend(); ++iter, ++count)
+            total += *iter;
+        CHECK(count == 60 && total == 1770.0);
+        count = 0;
+        for (auto sub : r)
+            count += sub.size();
+        CHECK(count == 60 && sum(r) == 1770.0);
+        CHECK(make_array(r.vpart(span(), 1)).at(2, 3) == 48.0);
+
+        r.vpart(0, 0) = r.vpart(2, 3);
+        CHECK(buffer[0] == 55.0 && buffer[4] == 59.0);
+
+        const auto cr = make_array_ref(static_cast<const double*>(buffer), std::array<size_t, 2>{6, 10});
+        static_assert(std::is_same_v<decltype(cr), const array_ref<const double, 2>>);
+        CHECK(cr.at(5, 9) == 59.0);
+    }
+
+    // vectors and arrays are referred to without a copy
+    {
+        std::vector<int> vec(10, 2);
+        auto r = make_array_ref(vec);
+        CHECK(r.data() == vec.data() && r.size() == 10);
+        array<int, 2> a(std::array<size_t, 2>{3, 4});
+        auto ra = make_array_ref(a);
+        CHECK(ra.data() == a.data() && ra.dimensions() == a.dimensions());
+    }
+
+    // overlapping array_refs over the same buffer, forward and backward, and
+    // with views of them of different strides or index lists
+    const size_t n = 1000;
+    CHECK(same_as_unaliased(n, [](double* src, double* dst)
+    {
+        auto to = make_array_ref(dst + 1, n - 1);
+        data_copy(make_array_ref(static_cast<const double*>(src), n - 1), to);
+    }));
+    CHECK(same_as_unaliased(n, [](double* src, double* dst)
+    {
+        auto to = make_array_ref(dst, n - 7);
+        data_copy(make_array_ref(static_cast<const double*>(src) + 7, n - 7), to);
+    }));
+    CHECK(same_as_unaliased(n, [](double* src, double* dst)
+    {
+        auto to = make_array_ref(dst + 3, 10, 99);
+        data_copy(par, make_array_ref(static_cast<const double*>(src), 10, 99), to);
+    }));
+    CHECK(same_as_unaliased(n, [](double* src, double* dst)
+    {
+        auto to = make_array_ref(dst, 500);
+        const auto from = make_array_ref(static_cast<const double*>(src), n);
+        data_copy(from.vpart(span(0, 0, 2)), to);
+    }));
+    CHECK(same_as_unaliased(n, [](double* src, double* dst)
+    {
+        auto to = make_array_ref(dst, 10, 100);
+        const auto from = make_array_ref(static_cast<const double*>(src), 100, 10);
+        data_copy(par, vtranspose(from), to);
+    }));
+    CHECK(same_as_unaliased(n, [](double* src, double* dst)
+    {
+        const std::vector<size_t> rows{5, 1, 0, 3};
+        auto to_ref = make_array_ref(dst, 10, 100);
+        auto to = to_ref.vpart(span(0, 4), span());
+        const auto from = make_array_ref(static_cast<const double*>(src), 10, 100);
+        data_copy(from.vpart(span(rows), span()), to);
+    }));
+
+    return check_result("test_array_ref");
+}
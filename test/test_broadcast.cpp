@@ -0,0 +1,124 @@
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+template<typename T, size_t Depth>
+array<T, Depth> iota_array(const std::array<size_t, Depth>& dims, T scale)
+{
+    array<T, Depth> a(dims);
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = T(i) * scale;
+    return a;
+}
+
+// whether creating the expression throws std::invalid_argument
+template<typename MakeExpr>
+bool throws_invalid_argument(MakeExpr make_expr)
+{
+    try
+    {
+        make_expr();
+    }
+    catch (const std::invalid_argument&)
+    {
+        return true;
+    }
+    return false;
+}
+
+// [N] + [M, N]: the [N] operand repeats over the rows
+void test_leading_levels(size_t m, size_t n)
+{
+    const auto a = iota_array<double, 2>({m, n}, 1.0);
+    const auto v = iota_array<double, 1>({n}, 100.0);
+
+    const array<double, 2> r1 = v + a;
+    const array<double, 2> r2 = a * 2.0 - v;
+    array<double, 2> r3(std::array<size_t, 2>{m, n});
+    data_copy(par, a + v, r3);
+    bool ok = r1.dimensions() == a.dimensions() && r2.dimensions() == a.dimensions();
+    for (size_t i = 0; i < m && ok; ++i)
+        for (size_t j = 0; j < n; ++j)
+            ok &= r1.at(i, j) == v.at(j) + a.at(i, j) && r2.at(i, j) == a.at(i, j) * 2.0 - v.at(j) &&
+                  r3.at(i, j) == r1.at(i, j);
+    CHECK(ok);
+
+    // copy_to() of a prefix that ends within a row writes only the prefix
+    const size_t prefix = m * n / 2 + 1;
+    std::vector<double> head(prefix);
+    (a + v).copy_to(head.data(), prefix);
+    ok = true;
+    for (size_t i = 0; i < prefix; ++i)
+        ok &= head[i] == a.data()[i] + v.at(i % n);
+    CHECK(ok);
+
+    // [M, N] and [N] operands of a [K, M, N] expression
+    const size_t k = 3;
+    const auto c = iota_array<double, 3>({k, m, n}, 0.5);
+    const array<double, 3> r4 = c + a * v;
+    ok = true;
+    for (size_t l = 0; l < k; ++l)
+        for (size_t i = 0; i < m; ++i)
+            for (size_t j = 0; j < n; ++j)
+                ok &= r4.at(l, i, j) == c.at(l, i, j) + a.at(i, j) * v.at(j);
+    CHECK(ok);
+}
+
+// [M, 1] + [M, N]: levels of size 1 are stretched by vbroadcast() only
+void test_size_one_levels(size_t m, size_t n)
+{
+    const auto a   = iota_array<double, 2>({m, n}, 1.0);
+    const auto col = iota_array<double, 2>({m, 1}, 1000.0);
+    const auto row = iota_array<double, 2>({1, n}, 10.0);
+
+    const array<double, 2> r1 = vbroadcast(col, m, n) + a;
+    const array<double, 2> r2 = a - vbroadcast(row, m, n);
+    bool ok = true;
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            ok &= r1.at(i, j) == col.at(i, 0) + a.at(i, j) && r2.at(i, j) == a.at(i, j) - row.at(0, j);
+    CHECK(ok);
+
+    if (n != 1)
+    {
+        CHECK(throws_invalid_argument([&] { return col + a; }));
+        CHECK(throws_invalid_argument([&] { return a * col; }));
+    }
+    if (m != 1)
+        CHECK(throws_invalid_argument([&] { return row + a; }));
+}
+
+// operands whose dimensions do not match
+void test_mismatched(size_t m, size_t n)
+{
+    const auto a  = iota_array<double, 2>({m, n}, 1.0);
+    const auto b  = iota_array<double, 2>({m, n + 1}, 1.0);
+    const auto c  = iota_array<double, 2>({m + 1, n}, 1.0);
+    const auto v  = iota_array<double, 1>({n + 1}, 1.0);
+    const auto c3 = iota_array<double, 3>({2, m, n}, 1.0);
+
+    CHECK(throws_invalid_argument([&] { return a + b; }));
+    CHECK(throws_invalid_argument([&] { return c - a; }));
+    CHECK(throws_invalid_argument([&] { return a * v; }));
+    CHECK(throws_invalid_argument([&] { return v + a; }));
+    CHECK(throws_invalid_argument([&] { return c3 + c; }));
+    CHECK(throws_invalid_argument([&] { return c3 + (a + v); }));
+    CHECK(!throws_invalid_argument([&] { return c3 + (a + a(0, span())); }));
+}
+
+int main()
+{
+    for (size_t m : {1, 4, 33})
+        for (size_t n : {1, 7, 300})
+        {
+            test_leading_levels(m, n);
+            test_size_one_levels(m, n);
+            test_mismatched(m, n);
+        }
+    return check_result("test_broadcast");
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+template<typename A, typename B>
+bool same_elems(const A& a, const B& b)
+{
+    return a.size() == b.size() && std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+// bytes decompressed by the codec are the bytes compressed
+bool lz_round_trip(const std::vector<unsigned char>& src)
+{
+    const auto encoded = _lz_compress(src.data(), src.size());
+    std::vector<unsigned char> decoded(src.size());
+    _lz_decompress(encoded.data(), encoded.size(), decoded.data(), decoded.size());
+    return decoded == src;
+}
+
+// a chunked_array reads back as the array it was made of, through every
+// kind of access
+template<typename T, size_t Depth>
+void test_round_trip(const array<T, Depth>& a, std::array<size_t, Depth> chunk_dims)
+{
+    const chunked_array<T, Depth> c(a, chunk_dims);
+    CHECK(c.size() == a.size() && c.dimensions() == a.dimensions());
+    CHECK(same_elems(make_array(c), a));
+    CHECK(same_elems(make_array(chunked_array<T, Depth>(par, a, chunk_dims)), a));
+
+    std::vector<T> walked(c.element_cbegin(), c.element_cend());
+    CHECK(walked.size() == a.size() && std::equal(walked.begin(), walked.end(), a.data()));
+
+    array<T, Depth> copied(a.dimensions());
+    data_copy(par, c, copied);
+    CHECK(same_elems(copied, a));
+}
+
+int main()
+{
+    std::mt19937 rng(1);
+
+    // the codec on its own: literal runs and matches of 255 bytes or more,
+    // and matches at offsets up to the limit of 65535
+    {
+        std::vector<unsigned char> data(1000);
+        for (auto& byte : data)
+            byte = static_cast<unsigned char>(rng());
+        CHECK(lz_round_trip(data));                      // literals only, 1000 of them
+        data.resize(5000, 7);                            // a match of 4000 bytes
+        CHECK(lz_round_trip(data));
+        CHECK(_lz_compress(data.data(), data.size()).size() < 1100);
+        for (size_t n : {0, 1, 3, 4, 5, 15, 16, 19, 254, 255, 256, 270, 271, 509, 510})
+        {
+            std::vector<unsigned char> short_data(data.begin(), data.begin() + n);
+            CHECK(lz_round_trip(short_data));
+            short_data.resize(n + 4 + n, 0);             // n literals then a match of 4 + n
+            CHECK(lz_round_trip(short_data));
+        }
+
+        for (size_t offset : {65534, 65535, 65536, 70000})
+        {
+            std::vector<unsigned char> far(offset + 64, 0);
+            for (size_t i = 0; i < 64; ++i)
+                far[i] = far[offset + i] = static_cast<unsigned char>(rng() | 1);
+            CHECK(lz_round_trip(far));
+            // the second copy costs a few bytes as a match within reach, and
+            // its 64 bytes as literals beyond it
+            const size_t encoded = _lz_compress(far.data(), far.size()).size();
+            std::fill_n(far.begin() + offset, 64, 0);
+            const size_t without = _lz_compress(far.data(), far.size()).size();
+            CHECK(offset <= _lz_max_offset_v ? encoded < without + 16 : encoded >= without + 64);
+        }
+    }
+
+    // round trips with tiles that cover the dimensions exactly or not
+    {
+        array<double, 3> a(std::array<size_t, 3>{13, 17, 9});
+        std::iota(a.data(), a.data() + a.size(), 0.25);
+        test_round_trip(a, {4, 5, 3});
+        test_round_trip(a, {13, 17, 9});
+        test_round_trip(a, {1, 1, 1});
+        test_round_trip(a, {20, 20, 20});
+
+        array<int, 2> b(std::array<size_t, 2>{37, 45});
+        for (size_t i = 0; i < b.size(); ++i)
+            b.data()[i] = int(i % 7) - 3;
+        test_round_trip(b, {16, 16});
+        test_round_trip(b, {37, 1});
+
+        array<short, 1> e(std::array<size_t, 1>{0});
+        test_round_trip(e, {8});
+    }
+
+    // at() with negative indices, and part() with every kind of span
+    {
+        array<float, 3> a(std::array<size_t, 3>{13, 17, 9});
+        std::iota(a.data(), a.data() + a.size(), 1.0f);
+        const chunked_array<float, 3> c(a, {4, 5, 3});
+        bool ok = true;
+        for (size_t i = 0; i < 13; ++i)
+            for (size_t j = 0; j < 17; ++j)
+                for (size_t k = 0; k < 9; ++k)
+                    ok &= c.at(i, j, k) == a.at(i, j, k) && c(i, j, k) == a.at(i, j, k);
+        CHECK(ok);
+        CHECK(c.at(-1, -1, -1) == a.at(12, 16, 8) && c.at(-13, 5, -9) == a.at(0, 5, 0));
+        CHECK(c(-2, 3, -4) == a.at(11, 3, 5));
+
+        const std::vector<size_t> rows{12, 0, 5, 5};
+        CHECK(same_elems(c.part(span(2, 9), 3, span(1, 8, 3)), make_array(a.vpart(span(2, 9), 3, span(1, 8, 3)))));
+        CHECK(same_elems(c.part(span(rows), span(), -1), make_array(a.vpart(span(rows), span(), -1))));
+        CHECK(same_elems(c.part(Reversed, span(-1, 0, -4), span()), make_array(a.vpart(Reversed, span(-1, 0, -4), span()))));
+        CHECK(same_elems(c(5), make_array(a.vpart(5))));
+    }
+
+    // incompressible tiles are stored raw, and copy_to() of a prefix stops
+    // at the given size
+    {
+        std::vector<int> noise(10000);
+        for (auto& x : noise)
+            x = int(rng());
+        const chunked_array<int, 1> c(noise, {1000});
+        CHECK(c.compressed_bytes() == noise.size() * sizeof(int) + 10);
+        std::vector<int> back(10000);
+        c.copy_to(back.begin());
+        CHECK(back == noise);
+
+        array<int, 1> prefix(std::array<size_t, 1>{2500});
+        c.copy_to(prefix.data(), prefix.size());
+        CHECK(std::equal(prefix.data(), prefix.data() + 2500, noise.data()));
+    }
+
+    // sparse data compresses well
+    {
+        array<float, 2> z(std::array<size_t, 2>{512, 512});
+        for (size_t i = 0; i < 512; i += 37)
+            z.at(i, i) = float(i);
+        const chunked_array<float, 2> c(z, {64, 64});
+        CHECK(c.compressed_bytes() * 20 < z.size() * sizeof(float));
+        CHECK(same_elems(make_array(c), z));
+    }
+
+    // the cache keeps at most its budget, but always the last tile used
+    {
+        array<double, 2> a(std::array<size_t, 2>{40, 40});
+        std::iota(a.data(), a.data() + a.size(), 0.0);
+        const size_t tile_bytes = 8 * 8 * sizeof(double);
+        chunked_array<double, 2> c(a, {8, 8}, 3 * tile_bytes);
+        CHECK(c.cache_budget() == 3 * tile_bytes && c.cache_bytes() == 0);
+
+        bool ok = true;
+        for (size_t i = 0; i < 40; ++i)
+            for (size_t j = 0; j < 40; ++j)
+            {
+                ok &= c.at(i, j) == a.at(i, j);
+                ok &= c.cache_bytes() <= 3 * tile_bytes;
+            }
+        CHECK(ok && c.cache_bytes() == 3 * tile_bytes);
+
+        c.set_cache_budget(tile_bytes / 2);
+        CHECK(c.cache_bytes() == tile_bytes);
+        CHECK(c.at(39, 0) == a.at(39, 0) && c.cache_bytes() == tile_bytes);
+        c.set_cache_budget(0);
+        CHECK(c.at(0, 39) == a.at(0, 39) && c.cache_bytes() == tile_bytes);
+
+        c.clear_cache();
+        CHECK(c.cache_bytes() == 0);
+        c.set_cache_budget(size_t(1) << 20);
+        CHECK(same_elems(make_array(c), a) && c.cache_bytes() == 0);  // make_array() bypasses the cache
+        std::vector<double> walked(c.element_cbegin(), c.element_cend());
+        CHECK(c.cache_bytes() == 25 * tile_bytes);
+    }
+
+    return check_result("test_chunked");
+}
@@ -0,0 +1,190 @@
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// dst[i * dst_stride] = src[i * src_stride] by a scalar loop
+template<typename S, typename D>
+void scalar_copy(const S* src, ptrdiff_t src_stride, D* dst, ptrdiff_t dst_stride, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        dst[ptrdiff_t(i) * dst_stride] = D(src[ptrdiff_t(i) * src_stride]);
+}
+
+// _strided_copy() against the scalar loop, over sizes around the vector
+// widths and positive and negative strides; the elements between the
+// strided positions of the destination must be left untouched
+template<typename S, typename D>
+void test_strided_copy()
+{
+    for (size_t size : {0, 1, 7, 8, 15, 16, 17, 31, 33, 100, 1000})
+        for (ptrdiff_t src_stride : {1, 2, 3, 17, -1, -5})
+            for (ptrdiff_t dst_stride : {1, 2, -3})
+            {
+                const size_t src_span = size * size_t(src_stride < 0 ? -src_stride : src_stride) + 1;
+                const size_t dst_span = size * size_t(dst_stride < 0 ? -dst_stride : dst_stride) + 1;
+                std::vector<S> src(src_span);
+                for (size_t i = 0; i < src_span; ++i)
+                    src[i] = S(i * 3 + 1);
+                std::vector<D> dst(dst_span, D(-7)), expected(dst_span, D(-7));
+                const S* src_first = src.data() + (src_stride < 0 ? src_span - 1 : 0);
+                const size_t dst_offset = dst_stride < 0 ? dst_span - 1 : 0;
+                _strided_copy(src_first, src_stride, dst.data() + dst_offset, dst_stride, size);
+                scalar_copy(src_first, src_stride, expected.data() + dst_offset, dst_stride, size);
+                CHECK(dst == expected);
+            }
+}
+
+#if defined(NDARRAY_X86_SIMD)
+
+// a gather or scatter kernel against the scalar loop, over the elements it
+// reports as copied, which leave a tail shorter than one vector
+template<typename T, typename Kernel>
+void test_gather_kernel(Kernel kernel)
+{
+    for (size_t size : {0, 3, 8, 16, 17, 40, 1001})
+        for (ptrdiff_t stride : {1, 2, 9, -4})
+        {
+            const size_t span_size = size * size_t(stride < 0 ? -stride : stride) + 1;
+            std::vector<T> src(span_size), dst(size, T(-1)), expected(size, T(-1));
+            for (size_t i = 0; i < span_size; ++i)
+                src[i] = T(i + 5);
+            const T* first = src.data() + (stride < 0 ? span_size - 1 : 0);
+            const size_t done = kernel(first, stride, dst.data(), size);
+            scalar_copy(first, stride, expected.data(), 1, done);
+            CHECK(done <= size && size - done < 16 && dst == expected);
+        }
+}
+
+template<typename T, typename Kernel>
+void test_scatter_kernel(Kernel kernel)
+{
+    for (size_t size : {0, 3, 8, 16, 17, 40, 1001})
+        for (ptrdiff_t stride : {1, 2, 9, -4})
+        {
+            const size_t span_size = size * size_t(stride < 0 ? -stride : stride) + 1;
+            std::vector<T> src(size), dst(span_size, T(-1)), expected(span_size, T(-1));
+            for (size_t i = 0; i < size; ++i)
+                src[i] = T(i + 5);
+            const size_t offset = stride < 0 ? span_size - 1 : 0;
+            const size_t done = kernel(src.data(), dst.data() + offset, stride, size);
+            scalar_copy(src.data(), 1, expected.data() + offset, stride, done);
+            CHECK(done <= size && size - done < 16 && dst == expected);
+        }
+}
+
+#endif
+
+// copies between arrays and views, which reach the kernels through
+// copy_to(), copy_from() and data_copy()
+template<typename T>
+void test_views()
+{
+    const size_t m = 37, n = 64;
+    array<T, 2> a(std::array<size_t, 2>{m, n});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = T(i);
+
+    // contiguous
+    array<T, 2> b(std::array<size_t, 2>{m, n});
+    data_copy(a, b);
+    CHECK(std::equal(a.data(), a.data() + a.size(), b.data()));
+
+    // a column, a strided row and a reversed row gathered into arrays
+    const array<T, 1> col = a(span(), 5).part();
+    const array<T, 1> row = a(3, span(1, 0, 3)).part();
+    const array<T, 1> rev = a(4, Reversed).part();
+    bool ok = col.size() == m && row.size() == (n + 1) / 3 && rev.size() == n;
+    for (size_t i = 0; i < col.size(); ++i)
+        ok &= col.at(i) == a.at(i, 5);
+    for (size_t i = 0; i < row.size(); ++i)
+        ok &= row.at(i) == a.at(3, 1 + 3 * i);
+    for (size_t i = 0; i < rev.size(); ++i)
+        ok &= rev.at(i) == a.at(4, n - 1 - i);
+    CHECK(ok);
+
+    // scattered into a column and a strided sub-block
+    array<T, 2> c(std::array<size_t, 2>{m, n});
+    for (size_t i = 0; i < c.size(); ++i)
+        c.data()[i] = T(-1);
+    c(span(), 7) = col;
+    c(span(0, 0, 2), span(1, 0, 2)) = a(span(0, (m + 1) / 2), span(0, n / 2));
+    ok = true;
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+        {
+            T expected = T(-1);
+            if (i % 2 == 0 && j % 2 == 1)
+                expected = a.at(i / 2, j / 2);
+            else if (j == 7)
+                expected = a.at(i, 5);
+            ok &= c.at(i, j) == expected;
+        }
+    CHECK(ok);
+
+    // irregular views take the scalar path
+    const std::vector<size_t> idx{9, 0, 63, 2, 2, 40};
+    const array<T, 2> d = a(span(1, 0, 5), span(idx)).part();
+    ok = d.template dimension<1>() == idx.size();
+    for (size_t i = 0; i < d.template dimension<0>(); ++i)
+        for (size_t j = 0; j < idx.size(); ++j)
+            ok &= d.at(i, j) == a.at(1 + 5 * i, idx[j]);
+    CHECK(ok);
+
+    // from element iterators of a regular view
+    array<T, 1> e(std::array<size_t, 1>{m});
+    const auto view = a(span(), 9);
+    e.copy_from(view.element_cbegin());
+    ok = true;
+    for (size_t i = 0; i < m; ++i)
+        ok &= e.at(i) == a.at(i, 9);
+    CHECK(ok);
+
+    // with a conversion of the element type
+    array<double, 2> f(std::array<size_t, 2>{m, n / 2});
+    f = a(span(), span(0, 0, 2));
+    ok = true;
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n / 2; ++j)
+            ok &= f.at(i, j) == double(a.at(i, 2 * j));
+    CHECK(ok);
+}
+
+int main()
+{
+    test_strided_copy<float, float>();
+    test_strided_copy<double, double>();
+    test_strided_copy<int32_t, int32_t>();
+    test_strided_copy<int64_t, int64_t>();
+    test_strided_copy<int16_t, int16_t>();
+    test_strided_copy<float, double>();
+    test_strided_copy<int32_t, float>();
+
+#if defined(NDARRAY_X86_SIMD)
+    const simd_level_type level = simd_level();
+    if (level != simd_level_type::scalar)
+    {
+        test_gather_kernel<int32_t>(_gather_copy_avx2_32);
+        test_gather_kernel<int64_t>(_gather_copy_avx2_64);
+    }
+    if (level == simd_level_type::avx512)
+    {
+        test_gather_kernel<int32_t>(_gather_copy_avx512_32);
+        test_gather_kernel<int64_t>(_gather_copy_avx512_64);
+        test_scatter_kernel<int32_t>(_scatter_copy_avx512_32);
+        test_scatter_kernel<int64_t>(_scatter_copy_avx512_64);
+    }
+#endif
+
+    test_views<float>();
+    test_views<double>();
+    test_views<int32_t>();
+    test_views<int64_t>();
+    test_views<int16_t>();
+
+    return check_result("test_copy");
+}
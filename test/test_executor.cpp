@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// the ranges of parallel_for() are disjoint, cover [0, n), and are at
+// least grain long unless n is shorter
+void test_ranges(executor& ex, size_t n, size_t grain)
+{
+    std::mutex mutex;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ex.parallel_for(n, grain, [&](size_t first, size_t last)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ranges.emplace_back(first, last);
+    });
+    std::sort(ranges.begin(), ranges.end());
+    size_t next = 0;
+    bool   ok   = true;
+    for (const auto& range : ranges)
+    {
+        ok = ok && range.first == next && range.first < range.second;
+        ok = ok && (range.second - range.first >= grain || ranges.size() == 1);
+        next = range.second;
+    }
+    CHECK(ok && next == n);
+}
+
+int main()
+{
+    executor ex(4);
+    for (size_t n : {0, 1, 2, 7, 8, 9, 15, 16, 17, 100, 1000, 4097, 100000})
+        for (size_t grain : {1, 2, 3, 5, 8, 64, 1000})
+            test_ranges(ex, n, grain);
+
+    // nested loops run to completion
+    std::atomic<size_t> count{0};
+    ex.parallel_for(16, 1, [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            ex.parallel_for(1000, 10, [&](size_t f, size_t l) { count += l - f; });
+    });
+    CHECK(count == 16000);
+
+    // exceptions are rethrown by the calling thread
+    bool threw = false;
+    try
+    {
+        ex.parallel_for(100, 1, [](size_t first, size_t) {
+            if (first == 0)
+                throw std::runtime_error("piece");
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // the calling thread sleeps while a worker runs the only other piece
+    executor two(2);
+    const std::clock_t cpu_start = std::clock();
+    two.parallel_for(2, 1, [](size_t first, size_t)
+    {
+        if (first == 1)
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    });
+    const double cpu = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    CHECK(cpu < 0.1);
+
+    return check_result("test_executor");
+}
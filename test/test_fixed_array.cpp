@@ -0,0 +1,124 @@
+#include <array>
+#include <type_traits>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// level iterators of a const fixed_array, which must be those of cbegin()/cend()
+void test_const_iterators()
+{
+    fixed_array<int, 2, 3> f;
+    for (size_t i = 0; i < f.size(); ++i)
+        f[i] = int(i);
+    const auto& cf = f;
+
+    static_assert(std::is_same_v<decltype(cf.begin<2>()), decltype(cf.cbegin<2>())>);
+    static_assert(std::is_same_v<decltype(cf.end<2>()), decltype(cf.cend<2>())>);
+    static_assert(std::is_same_v<decltype(cf.begin<1>()), decltype(cf.cbegin<1>())>);
+
+    int expected = 0;
+    bool ok = true;
+    for (auto iter = cf.begin<2>(); iter != cf.end<2>(); ++iter)
+        ok &= *iter == expected++;
+    CHECK(ok && expected == 6);
+
+    size_t rows = 0;
+    for (auto row : cf)
+        CHECK(row.size() == 3 && row(0) == int(3 * rows++));
+    CHECK(rows == 2);
+}
+
+// two fixed_arrays of the same type must not be taken for one another
+void test_identity()
+{
+    fixed_array<int, 4, 4> a, b;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = int(i);
+        b[i] = -1;
+    }
+    CHECK(a._identifier_ptr() != b._identifier_ptr());
+    CHECK(a._identifier_ptr() == a._identifier_ptr());
+
+    // irregular views of distinct fixed_arrays
+    const auto& ca = a;
+    b(span(0, 4, 2), span()) = ca(span(1, 4, 2), span());
+    bool ok = true;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            ok &= b(i, j) == (i % 2 == 0 ? a(i + 1, j) : -1);
+    CHECK(ok);
+
+    // an aliased copy within one fixed_array
+    a = vtranspose(a);
+    ok = true;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            ok &= a(i, j) == 4 * j + i;
+    CHECK(ok);
+
+    fixed_array<int, 4> v{1, 2, 3, 4};
+    v(span(1, 3)) = v(span(0, 2));
+    CHECK(v(0) == 1 && v(1) == 1 && v(2) == 2 && v(3) == 4);
+}
+
+// copies by the compile-time path and by the copy engine
+template<size_t M, size_t N>
+void test_copies()
+{
+    fixed_array<float, M, N> f;
+    for (size_t i = 0; i < f.size(); ++i)
+        f[i] = float(i) + 0.5f;
+
+    fixed_array<double, M, N> d;
+    d = f;
+    bool ok = true;
+    for (size_t i = 0; i < d.size(); ++i)
+        ok &= d[i] == double(f[i]);
+    CHECK(ok);
+
+    fixed_array<float, M, N> g(d);
+    ok = true;
+    for (size_t i = 0; i < g.size(); ++i)
+        ok &= g[i] == f[i];
+    CHECK(ok);
+
+    std::vector<float> buffer(f.size() + 1, -1.0f);
+    f.copy_to(buffer.data());
+    CHECK(buffer[0] == 0.5f && buffer[f.size() - 1] == f[f.size() - 1] && buffer[f.size()] == -1.0f);
+
+    for (auto& x : buffer)
+        x *= 2.0f;
+    g.copy_from(buffer.data());
+    CHECK(g[0] == 1.0f && g[f.size() - 1] == 2.0f * f[f.size() - 1]);
+
+    array<float, 2> a = make_array(f);
+    CHECK(a.size() == f.size() && a.at(M - 1, N - 1) == f.at(M - 1, N - 1));
+    g = a;
+    ok = true;
+    for (size_t i = 0; i < g.size(); ++i)
+        ok &= g[i] == f[i];
+    CHECK(ok);
+
+    // a strided destination takes the copy engine
+    array<float, 2> wide(std::array<size_t, 2>{M, 2 * N});
+    wide.vpart(span(), span(0, 2 * N, 2)) = f;
+    ok = true;
+    for (size_t i = 0; i < M; ++i)
+        for (size_t j = 0; j < N; ++j)
+            ok &= wide.at(i, 2 * j) == f.at(i, j);
+    CHECK(ok);
+}
+
+int main()
+{
+    test_const_iterators();
+    test_identity();
+    test_copies<3, 3>();
+    test_copies<4, 16>();
+    test_copies<20, 30>();
+    return check_result("test_fixed_array");
+}
@@ -0,0 +1,160 @@
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// the element iterators of a 3D view against at() in row-major order,
+// stepping forwards, backwards and by jumps
+template<typename View>
+void test_iter(const View& view)
+{
+    const size_t d0 = view.template dimension<0>(), d1 = view.template dimension<1>(), d2 = view.template dimension<2>();
+    std::vector<int> expected;
+    for (size_t i = 0; i < d0; ++i)
+        for (size_t j = 0; j < d1; ++j)
+            for (size_t k = 0; k < d2; ++k)
+                expected.push_back(view.at(i, j, k));
+    const size_t size = expected.size();
+    CHECK(view.size() == size);
+
+    const auto begin = view.element_cbegin();
+    const auto end   = view.element_cend();
+    CHECK(size_t(end - begin) == size);
+
+    bool ok = true;
+    size_t n = 0;
+    for (auto iter = begin; iter != end; ++iter, ++n)
+        ok &= n < size && *iter == expected[n];
+    CHECK(ok && n == size);
+
+    ok = true;
+    auto iter = end;
+    for (size_t i = size; i-- > 0;)
+        ok &= *--iter == expected[i];
+    CHECK(ok && iter == begin);
+
+    ok = true;
+    for (size_t step : {1, 2, 3, 7, 50})
+        for (size_t pos = 0; pos < size; pos += step)
+        {
+            const auto jump = begin + ptrdiff_t(pos);
+            ok &= *jump == expected[pos] && begin[ptrdiff_t(pos)] == expected[pos] &&
+                  size_t(jump - begin) == pos && (end - ptrdiff_t(size - pos)) == jump;
+            ok &= pos == 0 || (begin < jump && jump > begin && begin <= jump);
+        }
+    CHECK(ok);
+}
+
+// the level-2 iterators of a 3D view, whose elements are rows, stepping
+// backwards by jumps from the end
+template<typename View>
+void test_level_iter(const View& view)
+{
+    const size_t d0 = view.template dimension<0>(), d1 = view.template dimension<1>();
+    const size_t rows = d0 * d1;
+    const auto begin = view.template begin<2>();
+    const auto end   = view.template end<2>();
+    CHECK(size_t(end - begin) == rows);
+
+    bool ok = true;
+    for (size_t k = 1; k <= rows; ++k)
+    {
+        const size_t pos = rows - k;
+        const auto row = *(end - ptrdiff_t(k));
+        ok &= row.at(0) == view.at(pos / d1, pos % d1, 0) && (end - ptrdiff_t(k)) == begin + ptrdiff_t(pos);
+    }
+    CHECK(ok);
+}
+
+template<typename T>
+constexpr bool is_irregular_view_iter_v = false;
+template<typename SubView, typename BaseView, bool IsExplicitConst>
+constexpr bool is_irregular_view_iter_v<irregular_view_iter<SubView, BaseView, IsExplicitConst>> = true;
+
+// the level iterators of an irregular 3D view, whose elements are sub-views,
+// compared with each other at every pair of positions
+template<size_t Level, typename View>
+void test_view_iter(const View& view)
+{
+    const auto begin = view.template begin<Level>();
+    const auto end   = view.template end<Level>();
+    static_assert(is_irregular_view_iter_v<remove_cvref_t<decltype(begin)>>);
+    const size_t n = size_t(end - begin);
+    const size_t d1 = view.template dimension<1>();
+    CHECK(n == (Level == 1 ? view.template dimension<0>() : view.template dimension<0>() * d1));
+
+    bool ok = true;
+    size_t count = 0;
+    for (auto iter = begin; iter != end; ++iter, ++count)
+    {
+        const auto sub = *iter;
+        if constexpr (Level == 1)
+            ok &= sub.at(0, 0) == view.at(count, 0, 0);
+        else
+            ok &= sub.at(0) == view.at(count / d1, count % d1, 0);
+    }
+    CHECK(ok && count == n);
+
+    ok = true;
+    for (size_t i = 0; i <= n; ++i)
+        for (size_t j = 0; j <= n; ++j)
+        {
+            const auto x = begin + ptrdiff_t(i), y = end - ptrdiff_t(n - j);
+            ok &= (x == y) == (i == j) && (x != y) == (i != j);
+            ok &= (x < y) == (i < j) && (x > y) == (i > j);
+            ok &= (x <= y) == (i <= j) && (x >= y) == (i >= j);
+            ok &= x - y == ptrdiff_t(i) - ptrdiff_t(j);
+        }
+    CHECK(ok);
+}
+
+int main()
+{
+    array<int, 3> a(std::array<size_t, 3>{6, 9, 11});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = int(i);
+
+    const std::vector<size_t> rows{5, 0, 3, 3};
+    const std::vector<size_t> mids{8, 0, 4, 1};
+    const std::vector<size_t> cols{10, 0, 4, 1, 9};
+    const std::vector<size_t> one{2};
+
+    test_iter(a(span(rows), span(), span()));
+    test_iter(a(span(), span(rows), span()));
+    test_iter(a(span(), span(), span(cols)));
+    test_iter(a(span(rows), span(1, 0, 3), span(cols)));
+    test_iter(a(span(1, 5), span(mids), Reversed));
+    test_iter(a(Reversed, span(one), span(cols)));
+    test_iter(a(span(rows), span(one), span(one)));
+
+    test_level_iter(a(span(rows), span(), span(cols)));
+    test_level_iter(a(span(), span(mids), span(1, 0, 2)));
+
+    test_view_iter<1>(a(span(rows), span(), span(cols)));
+    test_view_iter<2>(a(span(rows), span(mids), span(cols)));
+    test_view_iter<2>(a(span(1, 5), span(mids), Reversed));
+
+    // an irregular view of a regular view of a strided base
+    auto base = a(span(0, 0, 2), span(), span(1, 0, 2));
+    test_iter(base(span(std::vector<size_t>{2, 0}), span(8, 0, -3), span(std::vector<size_t>{4, 0, 1})));
+
+    // writes through the iterator
+    auto view = a(span(std::vector<size_t>{5, 0, 3}), span(2, 3), span(cols));
+    for (auto iter = view.element_begin(); iter != view.element_end(); ++iter)
+        *iter = -*iter;
+    bool ok = true;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        const size_t i0 = i / 99, i1 = i / 11 % 9, i2 = i % 11;
+        bool in_view = i1 == 2 && (i0 == 5 || i0 == 0 || i0 == 3);
+        in_view &= i2 == 10 || i2 == 0 || i2 == 4 || i2 == 1 || i2 == 9;
+        ok &= a.data()[i] == (in_view ? -int(i) : int(i));
+    }
+    CHECK(ok);
+
+    return check_result("test_irregular_iter");
+}
@@ -0,0 +1,148 @@
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+std::mt19937 rng(3);
+
+// matrix of small integers, whose products are exact in floating point
+template<typename T>
+array<T, 2> random_matrix(size_t m, size_t n)
+{
+    array<T, 2> a(std::array<size_t, 2>{m, n});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = T(int(rng() % 21) - 10);
+    return a;
+}
+
+// the product of two matrices by the definition
+template<typename R, typename A, typename B>
+array<R, 2> naive_matmul(const A& a, const B& b)
+{
+    const size_t m = a.template dimension<0>(), k = a.template dimension<1>(), n = b.template dimension<1>();
+    array<R, 2> c(std::array<size_t, 2>{m, n});
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+        {
+            R s{};
+            for (size_t p = 0; p < k; ++p)
+                s += R(a.at(i, p)) * R(b.at(p, j));
+            c.at(i, j) = s;
+        }
+    return c;
+}
+
+template<typename A, typename B>
+bool same(const A& a, const B& b)
+{
+    return a.dimensions() == b.dimensions() && std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+int main()
+{
+    // square and non-square shapes, empty ones, and shapes around the
+    // cache blocks and register tiles
+    const std::vector<std::array<size_t, 3>> shapes = {
+        {1, 1, 1}, {0, 3, 4}, {3, 0, 4}, {5, 7, 3}, {4, 8, 8}, {97, 300, 130},
+        {200, 513, 2100}, {3, 1000, 17}, {130, 17, 5000}, {257, 31, 9}};
+    for (const auto& [m, k, n] : shapes)
+    {
+        auto a = random_matrix<double>(m, k);
+        auto b = random_matrix<double>(k, n);
+        const auto ref = naive_matmul<double>(a, b);
+        CHECK(same(matmul(a, b), ref));
+        CHECK(same(matmul(par, a, b), ref));
+        CHECK(same(dot(a, b), ref));
+        auto ai = random_matrix<int>(m, k);
+        auto bf = random_matrix<float>(k, n);
+        CHECK(same(matmul(par, ai, bf), naive_matmul<float>(ai, bf)));
+    }
+
+    // strided and sliced views as operands
+    auto big = random_matrix<double>(300, 400);
+    auto va  = big.vpart(span(10, 110), span(5, 305, 3)); // 100 x 100
+    auto vb  = big.vpart(span(0, 300, 3), span(1, 81));   // 100 x 80
+    CHECK(same(matmul(va, vb), naive_matmul<double>(va, vb)));
+    CHECK(same(matmul(par, va, vb), naive_matmul<double>(va, vb)));
+    CHECK(same(matmul(big.vpart(span(), span(0, 400, 4)), vb), naive_matmul<double>(big.vpart(span(), span(0, 400, 4)), vb)));
+
+    array<float, 3> cube(std::array<size_t, 3>{40, 50, 60});
+    for (size_t i = 0; i < cube.size(); ++i)
+        cube.data()[i] = float(int(rng() % 7) - 3);
+    auto s1 = cube.vpart(span(), 7, span());     // 40 x 60
+    auto s2 = cube.vpart(3, span(), span(0, 40)); // 50 x 40
+    auto s3 = cube.vpart(span(), span(), 2);     // 40 x 50
+    CHECK(same(matmul(s2, s1), naive_matmul<float>(s2, s1)));
+    CHECK(same(matmul(s3, s2), naive_matmul<float>(s3, s2)));
+    auto irr = big.vpart(span(std::vector<size_t>{5, 1, 9}), span(0, 100));
+    CHECK(same(matmul(irr, vb), naive_matmul<double>(irr, vb)));
+
+    // batched products
+    array<double, 3> ba(std::array<size_t, 3>{5, 30, 40}), bb(std::array<size_t, 3>{5, 40, 20});
+    for (size_t i = 0; i < ba.size(); ++i)
+        ba.data()[i] = double(rng() % 9);
+    for (size_t i = 0; i < bb.size(); ++i)
+        bb.data()[i] = double(rng() % 9);
+    auto bc = matmul(par, ba, bb);
+    auto bd = matmul(ba, bb.vpart(2));
+    for (size_t i = 0; i < 5; ++i)
+    {
+        CHECK(same(make_array(bc.vpart(i)), naive_matmul<double>(ba.vpart(i), bb.vpart(i))));
+        CHECK(same(make_array(bd.vpart(i)), naive_matmul<double>(ba.vpart(i), bb.vpart(2))));
+    }
+
+    // matrix-vector and vector-matrix products, with strided operands
+    std::vector<double> x(40);
+    for (auto& v : x)
+        v = double(rng() % 5);
+    auto y = dot(ba.vpart(1), x);
+    for (size_t i = 0; i < 30; ++i)
+    {
+        double s = 0;
+        for (size_t p = 0; p < 40; ++p)
+            s += ba.at(1, i, p) * x[p];
+        CHECK(y.at(i) == s);
+    }
+    auto z = dot(par, x, big.vpart(span(0, 40), span(0, 400, 7)));
+    for (size_t j = 0; j < z.size(); ++j)
+    {
+        double s = 0;
+        for (size_t p = 0; p < 40; ++p)
+            s += x[p] * big.at(p, 7 * j);
+        CHECK(z.at(j) == s);
+    }
+
+    // inner products, including strided vectors
+    CHECK(dot(x, x) == std::inner_product(x.begin(), x.end(), x.begin(), 0.0));
+    auto row = big.vpart(3, span(0, 80, 2));
+    CHECK(dot(x, row) == std::inner_product(x.begin(), x.end(), make_array(row).data(), 0.0));
+
+    // long inner products agree bit for bit across policies
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> u((size_t(1) << 20) + 5), v(u.size());
+    for (size_t i = 0; i < u.size(); ++i)
+    {
+        u[i] = dist(rng);
+        v[i] = dist(rng);
+    }
+    executor ex2(2), ex5(5);
+    const float uv = dot(seq, u, v);
+    const auto bits = [](float f) { uint32_t b; std::memcpy(&b, &f, 4); return b; };
+    CHECK(bits(uv) == bits(dot(par, u, v)));
+    CHECK(bits(uv) == bits(dot(ex2, u, v)));
+    CHECK(bits(uv) == bits(dot(ex5, u, v)));
+    double ref = 0;
+    for (size_t i = 0; i < u.size(); ++i)
+        ref += double(u[i]) * double(v[i]);
+    CHECK(std::abs(double(uv) - ref) < 1e-3);
+
+    return check_result("test_linalg");
+}
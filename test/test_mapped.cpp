@@ -0,0 +1,87 @@
+#include <array>
+#include <cstdio>
+#include <string>
+#include <system_error>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// the std::errc of the std::system_error thrown by fn, or no error
+template<typename Fn>
+std::error_code thrown_error(Fn fn)
+{
+    try
+    {
+        fn();
+    }
+    catch (const std::system_error& e)
+    {
+        return e.code();
+    }
+    return {};
+}
+
+int main()
+{
+    const std::string path = "test_mapped.bin";
+
+    // write through a created file, then read it back read-only
+    {
+        mapped_array<double, 2> m(create_file, path, {100, 50});
+        CHECK(m.size() == 5000 && m.at(99, 49) == 0.0);
+        for (size_t i = 0; i < m.size(); ++i)
+            m[i] = double(i);
+        CHECK(m.vpart(3).at(2) == 152.0 && m(span(), 1).at(2) == 101.0);
+        m.vpart(0) = m.vpart(1);    // an aliased copy within the mapping
+        m(5, 5) = -1.0;
+        m.sync();
+    }
+    {
+        const mapped_array<const double, 2> r(path, {100, 50});
+        CHECK(r.at(0, 0) == 50.0 && r.at(0, 49) == 99.0 && r.at(1, 0) == 50.0);
+        CHECK(r.at(5, 5) == -1.0 && r.at(99, 49) == 4999.0);
+        CHECK(*r.element_cbegin() == 50.0);
+
+        const array<double, 2> c = make_array(r);
+        bool ok = true;
+        for (size_t i = 50; i < c.size(); ++i)
+            ok &= c.data()[i] == (i == 255 ? -1.0 : double(i));
+        CHECK(ok && c.at(0, 7) == 57.0);
+        CHECK(sum(r(span(10, 20), span())) == sum(c(span(10, 20), span())));
+    }
+
+    // offsets that are not multiples of the page size
+    {
+        const mapped_array<const double, 1> row(path, {50}, 50 * sizeof(double));
+        CHECK(row[0] == 50.0 && row[49] == 99.0);
+        const mapped_array<const double, 2> tail(path, {3, 7}, 4321 * sizeof(double));
+        CHECK(tail.at(0, 0) == 4321.0 && tail.at(2, 6) == 4341.0);
+        const mapped_array<const double, 1> last(path, {1}, 4999 * sizeof(double));
+        CHECK(last[0] == 4999.0);
+        const mapped_array<const double, 1> none(path, {0}, 5000 * sizeof(double));
+        CHECK(none.size() == 0);
+
+        mapped_array<double, 1> rw(path, {10}, 1000 * sizeof(double));
+        rw[0] = 7.5;
+        rw.sync();
+    }
+    {
+        const mapped_array<const double, 2> r(path, {100, 50});
+        CHECK(r.at(20, 0) == 7.5 && r.at(20, 1) == 1001.0);
+    }
+
+    // errors
+    const auto invalid = std::make_error_code(std::errc::invalid_argument);
+    CHECK(thrown_error([&] { mapped_array<const double, 1> m(path, {5001}); }) == invalid);
+    CHECK(thrown_error([&] { mapped_array<const double, 1> m(path, {10}, 4991 * sizeof(double)); }) == invalid);
+    CHECK(thrown_error([&] { mapped_array<const double, 1> m(path, {10}, 4); }) == invalid);
+    CHECK(thrown_error([&] { mapped_array<const int, 1> m(path, {10}, 6); }) == invalid);
+    CHECK(!thrown_error([&] { mapped_array<const int, 1> m(path, {10}, 12); }));
+    CHECK(thrown_error([&] { mapped_array<const double, 1> m("/nonexistent/test_mapped.bin", {1}); }) ==
+          std::make_error_code(std::errc::no_such_file_or_directory));
+
+    std::remove(path.c_str());
+    return check_result("test_mapped");
+}
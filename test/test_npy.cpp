@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// write a one-byte-per-element '|b1' .npy file of the given raw bytes
+void write_bool_npy(const std::string& path, const std::vector<size_t>& shape,
+                    const std::vector<uint8_t>& bytes, bool fortran)
+{
+    std::string dict = "{'descr': '|b1', 'fortran_order': " + std::string(fortran ? "True" : "False") +
+        ", 'shape': (";
+    for (size_t i = 0; i < shape.size(); ++i)
+        dict += std::to_string(shape[i]) + (shape.size() == 1 ? "," : i + 1 < shape.size() ? ", " : "");
+    dict += "), }";
+    while ((10 + dict.size() + 1) % 64 != 0)
+        dict.push_back(' ');
+    dict.push_back('\n');
+
+    std::ofstream out(path, std::ios::binary);
+    out.write("\x93NUMPY\x01\x00", 8);
+    out.put(char(dict.size() % 256));
+    out.put(char(dict.size() / 256));
+    out.write(dict.data(), std::streamsize(dict.size()));
+    out.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+}
+
+// the data bytes of a .npy file
+std::vector<uint8_t> npy_data(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const size_t header = 10 + size_t(file[8]) + 256 * size_t(file[9]);
+    return std::vector<uint8_t>(file.begin() + ptrdiff_t(header), file.end());
+}
+
+int main()
+{
+    const std::string path = "test_npy_bool.npy";
+
+    // std::vector<bool>, longer than the write buffer
+    std::vector<bool> flags(100003);
+    for (size_t i = 0; i < flags.size(); ++i)
+        flags[i] = (i * 7919) % 13 < 5;
+    save_npy(path, flags);
+    auto loaded = load_npy<uint8_t, 1>(path);
+    CHECK(loaded.size() == flags.size());
+    bool equal = true;
+    for (size_t i = 0; i < flags.size(); ++i)
+        equal = equal && loaded.at(i) == uint8_t(flags[i]);
+    CHECK(equal);
+
+    // bool expressions are streamed in C order as bytes of 0 and 1
+    array<int, 2> a(std::array<size_t, 2>{301, 257});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = int((i * 2654435761u) % 1000) - 500;
+    save_npy(path, a > 0);
+    const auto bytes = npy_data(path);
+    CHECK(bytes.size() == a.size());
+    bool binary = true;
+    for (uint8_t byte : bytes)
+        binary = binary && byte <= 1;
+    CHECK(binary);
+
+    auto c = load_npy<uint8_t, 2>(path);
+    CHECK(c.dimensions() == a.dimensions());
+    equal = true;
+    for (size_t i = 0; i < 301; ++i)
+        for (size_t j = 0; j < 257; ++j)
+            equal = equal && c.at(i, j) == uint8_t(a.at(i, j) > 0);
+    CHECK(equal);
+    auto ci = load_npy<int, 2>(path);
+    CHECK(ci.at(300, 256) == int(a.at(300, 256) > 0));
+
+    // bool expression of a strided view
+    save_npy(path, a.vpart(span(0, 301, 3), Reversed) <= 0);
+    auto s = load_npy<uint8_t, 2>(path);
+    CHECK(s.dimension<0>() == 101 && s.dimension<1>() == 257);
+    CHECK(s.at(5, 0) == uint8_t(a.at(15, 256) <= 0) && s.at(100, 256) == uint8_t(a.at(300, 0) <= 0));
+
+    // the same elements in Fortran order load into the same array
+    std::vector<uint8_t> fortran_bytes;
+    for (size_t j = 0; j < 257; ++j)
+        for (size_t i = 0; i < 301; ++i)
+            fortran_bytes.push_back(uint8_t(a.at(i, j) > 0));
+    write_bool_npy(path, {301, 257}, fortran_bytes, true);
+    auto f = load_npy<uint8_t, 2>(path);
+    CHECK(f.dimensions() == c.dimensions());
+    CHECK(std::equal(f.data(), f.data() + f.size(), c.data()));
+
+    // and a C-order file written by hand reads the same as save_npy()
+    write_bool_npy(path, {301, 257}, bytes, false);
+    auto h = load_npy<uint8_t, 2>(path);
+    CHECK(std::equal(h.data(), h.data() + h.size(), c.data()));
+
+    std::remove(path.c_str());
+    return check_result("test_npy");
+}
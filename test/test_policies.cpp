@@ -0,0 +1,91 @@
+#include <cstring>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+template<typename T, size_t Depth, typename Alloc>
+bool same_bits(const array<T, Depth, Alloc>& a, const array<T, Depth, Alloc>& b)
+{
+    return a.dimensions() == b.dimensions() &&
+        std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// the operations that take an execution policy give the same elements with
+// policy as with seq; the sizes are large enough for every operation to go
+// parallel
+template<typename ExecutionPolicy>
+void test_policy(ExecutionPolicy& policy)
+{
+    const size_t m = 300, n = 517;
+    array<double, 2> a = table([](int i, int j) { return (i * 7 + j * 3) % 101 - 50.0; }, int(m), int(n));
+    array<double, 2> b = table([](int i, int j) { return (i * 5 + j) % 13 - 6.0; }, int(n), 70);
+    array<int, 3>    c = table([](int i, int j, int k) { return (i * 31 + j * 17 + k) % 23 - 11; }, 40, 60, 70);
+    const array<double, 1> row = a(7, span());
+
+    std::vector<size_t> rows;
+    for (size_t i = 0; i < m; i += 3)
+        rows.push_back(m - 1 - i);
+
+    // materializing views
+    CHECK(same_bits(make_array(seq, a), make_array(policy, a)));
+    CHECK(same_bits(make_array(seq, a(span(1, 0, 2), span())), make_array(policy, a(span(1, 0, 2), span()))));
+    CHECK(same_bits(make_array(seq, a(span(), span(0, 0, 3))), make_array(policy, a(span(), span(0, 0, 3)))));
+    CHECK(same_bits(make_array(seq, a(Reversed, Reversed)), make_array(policy, a(Reversed, Reversed))));
+    CHECK(same_bits(make_array(seq, a(span(rows), span())), make_array(policy, a(span(rows), span()))));
+    CHECK(same_bits(make_array(seq, vtranspose(a)), make_array(policy, vtranspose(a))));
+    CHECK(same_bits(make_array(seq, a * 2.0 + a), make_array(policy, a * 2.0 + a)));
+    CHECK(same_bits(make_array(seq, vrepeat(row, 40, 3)), make_array(policy, vrepeat(row, 40, 3))));
+
+    // copying into views
+    {
+        array<double, 2> s(std::array<size_t, 2>{m, 2 * n}), p(std::array<size_t, 2>{m, 2 * n});
+        auto sv = s(span(), span(1, 0, 2));
+        auto pv = p(span(), span(1, 0, 2));
+        data_copy(seq, a + row, sv);
+        data_copy(policy, a + row, pv);
+        CHECK(same_bits(s, p));
+        auto sb = s(span(0, 70), span(0, 300));
+        data_copy(seq, vtranspose(b)(span(0, 0, 1), span(0, 300)), sb);
+        auto pb = p(span(0, 70), span(0, 300));
+        data_copy(policy, vtranspose(b)(span(0, 0, 1), span(0, 300)), pb);
+        CHECK(same_bits(s, p));
+    }
+
+    // constructors
+    CHECK(same_bits(range(seq, -5.0, 200000.0, 0.5), range(policy, -5.0, 200000.0, 0.5)));
+    CHECK(same_bits(range(seq, 100000), range(policy, 100000)));
+    auto fn = [](int i, double x, int k) { return i * 1000 + x * k; };
+    CHECK(same_bits(table(seq, fn, 90, row, 20), table(policy, fn, 90, row, 20)));
+    CHECK(same_bits(table(seq, fn, 90, vrange(0.0, 50.0, 0.25), 20), table(policy, fn, 90, vrange(0.0, 50.0, 0.25), 20)));
+    CHECK(same_bits(repeat(seq, row, 40, 3), repeat(policy, row, 40, 3)));
+    CHECK(same_bits(repeat(seq, a(span(0, 0, 5), span()), 7), repeat(policy, a(span(0, 0, 5), span()), 7)));
+    CHECK(same_bits(broadcast(seq, row, m, n), broadcast(policy, row, m, n)));
+
+    // rearrangements
+    CHECK(same_bits(transpose(seq, a), transpose(policy, a)));
+    CHECK(same_bits(permute<2, 0, 1>(seq, c), permute<2, 0, 1>(policy, c)));
+    CHECK(same_bits(swap_levels<0, 2>(seq, c), swap_levels<0, 2>(policy, c)));
+
+    // products, scans and sorts; the elements are small integers, so the
+    // sums are exact in any order
+    CHECK(same_bits(matmul(seq, a, b), matmul(policy, a, b)));
+    CHECK(same_bits(cumsum(seq, c), cumsum(policy, c)));
+    CHECK(same_bits(cumsum<1>(seq, c), cumsum<1>(policy, c)));
+    CHECK(same_bits(sort(seq, a), sort(policy, a)));
+    CHECK(same_bits(sort<0>(seq, a), sort<0>(policy, a)));
+}
+
+int main()
+{
+    executor ex1(1), ex2(2), ex5(5);
+    test_policy(par);
+    test_policy(par_unseq);
+    test_policy(ex1);
+    test_policy(ex2);
+    test_policy(ex5);
+
+    return check_result("test_policies");
+}
@@ -0,0 +1,101 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+template<typename T>
+bool same_bits(const T& a, const T& b)
+{
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template<typename T, size_t Depth>
+bool same_bits(const array<T, Depth>& a, const array<T, Depth>& b)
+{
+    return a.dimensions() == b.dimensions() &&
+        std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// reductions of src with seq, par and executors of several sizes agree
+// bit for bit
+template<typename Array>
+void test_policies(const Array& src)
+{
+    executor ex1(1), ex2(2), ex5(5);
+
+    const auto s = sum(seq, src);
+    CHECK(same_bits(s, sum(src)));
+    CHECK(same_bits(s, sum(par, src)));
+    CHECK(same_bits(s, sum(par_unseq, src)));
+    CHECK(same_bits(s, sum(ex1, src)));
+    CHECK(same_bits(s, sum(ex2, src)));
+    CHECK(same_bits(s, sum(ex5, src)));
+
+    const auto k = sum(seq, src, kahan_summation);
+    CHECK(same_bits(k, sum(ex2, src, kahan_summation)));
+    CHECK(same_bits(k, sum(ex5, src, kahan_summation)));
+    const auto n = sum(seq, src, naive_summation);
+    CHECK(same_bits(n, sum(ex2, src, naive_summation)));
+    CHECK(same_bits(n, sum(ex5, src, naive_summation)));
+
+    const auto m = mean(seq, src);
+    CHECK(same_bits(m, mean(ex2, src)));
+    CHECK(same_bits(m, mean(ex5, src)));
+    CHECK(same_bits(prod(seq, src), prod(ex5, src)));
+    CHECK(same_bits(min(seq, src), min(ex5, src)));
+    CHECK(same_bits(max(seq, src), max(ex5, src)));
+
+    if constexpr (array_depth_of_v<Array> > 1)
+    {
+        CHECK(same_bits(sum<0>(seq, src), sum<0>(ex2, src)));
+        CHECK(same_bits(sum<0>(seq, src), sum<0>(ex5, src)));
+        CHECK(same_bits(sum<1>(seq, src), sum<1>(ex2, src)));
+        CHECK(same_bits(sum<1>(seq, src), sum<1>(ex5, src)));
+        CHECK(same_bits(sum<1>(seq, src, kahan_summation), sum<1>(ex5, src, kahan_summation)));
+    }
+}
+
+int main()
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    // long enough to be split into many chunks, with a partial last chunk
+    array<float, 1> a(std::array<size_t, 1>{(size_t(1) << 20) + 17});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = dist(gen) * float(1 + i % 1000);
+    test_policies(a);
+    test_policies(a.vpart(span(0, a.size(), 3)));
+
+    array<float, 2> b(std::array<size_t, 2>{1001, 777});
+    for (size_t i = 0; i < b.size(); ++i)
+        b.data()[i] = dist(gen);
+    test_policies(b);
+    test_policies(b.vpart(span(), span(0, 777, 2)));
+    std::vector<size_t> rows(900);
+    for (size_t i = 0; i < rows.size(); ++i)
+        rows[i] = (i * 7) % 1001;
+    test_policies(b.vpart(span(rows), span()));
+
+    array<double, 3> c(std::array<size_t, 3>{64, 100, 50});
+    for (size_t i = 0; i < c.size(); ++i)
+        c.data()[i] = double(dist(gen));
+    test_policies(c);
+
+    // the chunked sum stays close to a sum in double precision
+    double ref = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+        ref += double(a.data()[i]);
+    CHECK(std::abs(double(sum(a)) - ref) < 1e-6 * std::abs(ref) + 1.0);
+
+    array<int, 1> d(std::array<size_t, 1>{300000});
+    for (size_t i = 0; i < d.size(); ++i)
+        d.data()[i] = i % 7 == 0 ? -1 : 1;
+    test_policies(d);
+
+    return check_result("test_reduction");
+}
@@ -0,0 +1,111 @@
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// every element of a repeat() result is the element at the same position of
+// the lazy vrepeat() of the same sub-array, read through at()
+template<typename T, size_t Depth, typename Sub>
+bool same_as_vrepeat(const array<T, Depth>& r, const Sub& sub, size_t n0, size_t n1)
+{
+    const auto lazy = vrepeat(sub, n0, n1);
+    if (r.dimensions() != lazy.dimensions())
+        return false;
+    bool ok = true;
+    auto iter = lazy.element_cbegin();
+    for (size_t i = 0; i < r.size(); ++i, ++iter)
+        ok &= r.data()[i] == *iter;
+    for (size_t i = 0; i < n0; ++i)
+        for (size_t j = 0; j < n1; ++j)
+            ok &= r.at(i, j, -1, -1) == lazy.at(i, j, -1, -1) && r.at(i, j, 0, 1) == lazy.at(i, j, 0, 1);
+    return ok;
+}
+
+// _replicate_block() writes n_copies of the block, also when a run is
+// capped, and leaves the memory after them alone
+template<typename T>
+bool replicates(size_t block_size, size_t n_copies)
+{
+    std::vector<T> src(block_size);
+    std::iota(src.begin(), src.end(), T(1));
+    std::vector<T> dst(block_size * n_copies + 1, T(-1));
+    _replicate_block(src.data(), dst.data(), block_size, n_copies);
+    bool ok = dst.back() == T(-1);
+    for (size_t i = 0; i + 1 < dst.size(); ++i)
+        ok &= dst[i] == src[i % block_size];
+
+    // the first block may be the source itself
+    if (n_copies == 0)
+        return ok;
+    std::vector<T> in_place(block_size * n_copies);
+    std::copy(src.begin(), src.end(), in_place.begin());
+    _replicate_block(in_place.data(), in_place.data(), block_size, n_copies);
+    for (size_t i = 0; i < in_place.size(); ++i)
+        ok &= in_place[i] == src[i % block_size];
+    return ok;
+}
+
+int main()
+{
+    // the doubling, with runs below and at the cap of _replicate_max_bytes_v
+    const size_t capped = _replicate_max_bytes_v / sizeof(double) / 64;
+    for (size_t n : {1, 2, 3, 5, 8, 17, 100})
+    {
+        CHECK(replicates<double>(1, n) && replicates<double>(7, n) && replicates<double>(64, n));
+        CHECK(replicates<char>(3, n * 1000));
+    }
+    CHECK(replicates<double>(64, capped + 1) && replicates<double>(64, 3 * capped - 1));
+    CHECK(replicates<double>(_replicate_max_bytes_v / sizeof(double) + 5, 3));
+    CHECK(replicates<int>(0, 5) && replicates<int>(5, 0));
+
+    array<float, 2> a(std::array<size_t, 2>{3, 5});
+    std::iota(a.data(), a.data() + a.size(), 0.5f);
+
+    // arrays, with seq and par, and against make_array() of the lazy view
+    for (size_t n : {1, 2, 3, 7, 64, 1000})
+    {
+        CHECK(same_as_vrepeat(repeat(a, 2, n), a, 2, n));
+        CHECK(same_as_vrepeat(repeat(par, a, n, 3), a, n, 3));
+        CHECK(same_as_vrepeat(make_array(vrepeat(a, n, 2)), a, n, 2));
+        CHECK(same_as_vrepeat(make_array(par, vrepeat(a, 3, n)), a, 3, n));
+    }
+
+    // sources other than arrays are copied once into the first block
+    {
+        array<int, 3> b(std::array<size_t, 3>{4, 6, 9});
+        std::iota(b.data(), b.data() + b.size(), 0);
+        const std::vector<size_t> rows{5, 0, 3};
+        const auto strided   = b(1, span(0, 0, 2), Reversed);
+        const auto irregular = b(2, span(rows), span(1, 8));
+        for (size_t n : {1, 4, 33})
+        {
+            CHECK(same_as_vrepeat(repeat(strided, n, 2), make_array(strided), n, 2));
+            CHECK(same_as_vrepeat(repeat(par, strided, 2, n), make_array(strided), 2, n));
+            CHECK(same_as_vrepeat(repeat(irregular, n, 3), make_array(irregular), n, 3));
+            CHECK(same_as_vrepeat(repeat(par, irregular, 3, n), make_array(irregular), 3, n));
+            CHECK(same_as_vrepeat(repeat(par, vtranspose(b(0)), n, 1), make_array(vtranspose(b(0))), n, 1));
+            CHECK(same_as_vrepeat(repeat(b(3) + 1, 1, n), make_array(b(3) + 1), 1, n));
+        }
+    }
+
+    // the result keeps the allocator type of an array argument
+    {
+        array<double, 1, default_init_allocator<double>> d(std::array<size_t, 1>{4});
+        std::iota(d.data(), d.data() + 4, 1.0);
+        const auto r = repeat(par, d, 5);
+        static_assert(std::is_same_v<decltype(r), const array<double, 2, default_init_allocator<double>>>);
+        CHECK(r.size() == 20 && r.at(4, 3) == 4.0);
+    }
+
+    // empty results, from no copies or an empty source
+    CHECK(repeat(a, 0, 4).size() == 0 && repeat(par, a, 4, 0).size() == 0);
+    const array<float, 2> e(std::array<size_t, 2>{0, 5});
+    CHECK(repeat(e, 3).size() == 0 && repeat(par, e, 3).size() == 0);
+    CHECK(make_array(par, vrepeat(a, 0)).size() == 0);
+
+    return check_result("test_repeat");
+}
@@ -0,0 +1,96 @@
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+template<typename A, typename B>
+bool same_elems(const A& a, const B& b)
+{
+    if (a.size() != b.size())
+        return false;
+    auto ia = a.element_cbegin();
+    auto ib = b.element_cbegin();
+    for (size_t i = 0; i < a.size(); ++i, ++ia, ++ib)
+        if (*ia != *ib)
+            return false;
+    return true;
+}
+
+int main()
+{
+    array<int, 3> a(std::array<size_t, 3>{4, 6, 10});
+    std::iota(a.data(), a.data() + a.size(), 0);
+
+    // arrays are referred to, with new dimensions
+    {
+        auto r = vreshape<2>(a, {24, 10});
+        static_assert(std::is_same_v<decltype(r), array_ref<int, 2>>);
+        CHECK(r.data() == a.data() && r.dimensions() == (std::array<size_t, 2>{24, 10}));
+        CHECK(r.at(23, 9) == 239 && r.at(7, 3) == 73);
+
+        auto f = vflatten(a);
+        static_assert(std::is_same_v<decltype(f), array_ref<int, 1>>);
+        CHECK(f.data() == a.data() && f.size() == 240 && f.at(100) == 100);
+
+        auto p = vpartition(a, 2);
+        static_assert(std::is_same_v<decltype(p), array_ref<int, 4>>);
+        CHECK(p.data() == a.data() && p.dimensions() == (std::array<size_t, 4>{2, 2, 6, 10}));
+        CHECK(p.at(1, 0, 2, 3) == a.at(2, 2, 3));
+        auto p2 = vpartition<2>(a, {2, 3});
+        CHECK(p2.data() == a.data() && p2.dimensions() == (std::array<size_t, 5>{2, 2, 2, 3, 10}));
+
+        // writes go to the array, and constness is kept
+        r.at(0, 1) = -1;
+        CHECK(a.at(0, 0, 1) == -1);
+        const auto& ca = a;
+        static_assert(std::is_same_v<decltype(vflatten(ca)), array_ref<const int, 1>>);
+        CHECK(vflatten(ca).data() == a.data());
+        a.at(0, 0, 1) = 1;
+    }
+
+    // simple views are referred to as well
+    {
+        auto view = a(span(1, 3));
+        auto r = vreshape<2>(view, {6, 20});
+        static_assert(std::is_same_v<decltype(r), array_ref<int, 2>>);
+        CHECK(r.data() == &a.at(1, 0, 0) && r.at(0, 0) == 60 && r.at(5, 19) == 179);
+        CHECK(vflatten(a(2)).data() == &a.at(2, 0, 0) && vflatten(a(2)).size() == 60);
+        CHECK(vpartition(a(span(0, 2)), 1).data() == a.data());
+    }
+
+    // other views are copied, as by reshape()
+    {
+        const auto regular = a(span(), span(0, 0, 2));
+        auto r = vreshape<2>(regular, {4, 30});
+        static_assert(std::is_same_v<decltype(r), array<int, 2>>);
+        CHECK(r.data() != a.data() && same_elems(vflatten(r), regular));
+
+        const std::vector<size_t> rows{3, 0};
+        const auto irregular = a(span(rows));
+        auto f = vflatten(irregular);
+        static_assert(std::is_same_v<decltype(f), array<int, 1>>);
+        CHECK(f.at(0) == 180 && f.at(60) == 0 && same_elems(f, irregular));
+
+        auto p = vpartition(a(Reversed), 2);
+        static_assert(std::is_same_v<decltype(p), array<int, 4>>);
+        CHECK(p.at(0, 0, 0, 0) == 180 && p.at(1, 1, 5, 9) == 59);
+    }
+
+    // reshape() of an array copies, or moves an r-value array
+    {
+        auto c = reshape<2>(a, {24, 10});
+        CHECK(c.data() != a.data() && same_elems(c, a));
+        auto moved = a;
+        const int* const data = moved.data();
+        auto m = flatten(std::move(moved));
+        CHECK(m.data() == data && m.size() == 240 && m.at(239) == 239);
+        auto q = partition(a, 4);
+        CHECK(q.dimensions() == (std::array<size_t, 4>{1, 4, 6, 10}) && same_elems(q, a));
+    }
+
+    return check_result("test_reshape");
+}
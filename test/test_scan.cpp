@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// the elements of an array object in row-major order
+template<typename Array>
+std::vector<long> elements(const Array& a)
+{
+    std::vector<long> ret;
+    auto iter = a.element_cbegin();
+    for (size_t i = 0; i < a.size(); ++i, ++iter)
+        ret.push_back(long(*iter));
+    return ret;
+}
+
+// scan of the elements of a 3-level array object along level, by hand;
+// every element is combined with the result at the previous index on level
+template<typename Array, typename Op>
+std::vector<long> scan_by_hand(const Array& src, size_t level, Op op, bool is_exclusive, long init)
+{
+    const auto dims = dimensions(src);
+    const auto a    = elements(src);
+    std::array<size_t, 3> strides{dims[1] * dims[2], dims[2], 1};
+    std::vector<long> ret(a.size());
+    for (size_t i = 0; i < dims[0]; ++i)
+        for (size_t j = 0; j < dims[1]; ++j)
+            for (size_t k = 0; k < dims[2]; ++k)
+            {
+                const size_t index[3] = {i, j, k};
+                const size_t pos  = i * strides[0] + j * strides[1] + k;
+                const size_t prev = pos - strides[level];
+                if (index[level] == 0)
+                    ret[pos] = is_exclusive ? init : a[pos];
+                else
+                    ret[pos] = op(ret[prev], is_exclusive ? a[prev] : a[pos]);
+            }
+    return ret;
+}
+
+// scan of all elements in order, by hand
+template<typename Array, typename Op>
+std::vector<long> flat_scan_by_hand(const Array& src, Op op, bool is_exclusive, long init)
+{
+    const auto a = elements(src);
+    std::vector<long> ret(a.size());
+    long carry = init;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (is_exclusive)
+        {
+            ret[i] = carry;
+            carry  = op(carry, a[i]);
+        }
+        else
+        {
+            carry  = i == 0 ? a[0] : op(carry, a[i]);
+            ret[i] = carry;
+        }
+    }
+    return ret;
+}
+
+// cumsum, cummax and exclusive_scan of src along each level and over all
+// elements, with seq and par, against the scans by hand
+template<typename Array>
+void test_scans(const Array& src)
+{
+    const auto plus    = [](long x, long y) { return x + y; };
+    const auto greater = [](long x, long y) { return std::max(x, y); };
+
+    for (size_t level = 0; level < 3; ++level)
+    {
+        const auto sums  = scan_by_hand(src, level, plus, false, 0);
+        const auto maxes = scan_by_hand(src, level, greater, false, 0);
+        const auto exc   = scan_by_hand(src, level, plus, true, 5);
+        if (level == 0)
+        {
+            CHECK(elements(cumsum<0>(src)) == sums && elements(cumsum<0>(par, src)) == sums);
+            CHECK(elements(cummax<0>(src)) == maxes && elements(cummax<0>(par, src)) == maxes);
+            CHECK(elements(exclusive_scan<0>(src, 5L, plus)) == exc);
+            CHECK(elements(exclusive_scan<0>(par, src, 5L, plus)) == exc);
+        }
+        else if (level == 1)
+        {
+            CHECK(elements(cumsum<1>(src)) == sums && elements(cumsum<1>(par, src)) == sums);
+            CHECK(elements(cummax<1>(src)) == maxes && elements(cummax<1>(par, src)) == maxes);
+            CHECK(elements(exclusive_scan<1>(src, 5L, plus)) == exc);
+            CHECK(elements(exclusive_scan<1>(par, src, 5L, plus)) == exc);
+        }
+        else
+        {
+            CHECK(elements(cumsum<2>(src)) == sums && elements(cumsum<2>(par, src)) == sums);
+            CHECK(elements(cummax<2>(src)) == maxes && elements(cummax<2>(par, src)) == maxes);
+            CHECK(elements(exclusive_scan<2>(src, 5L, plus)) == exc);
+            CHECK(elements(exclusive_scan<2>(par, src, 5L, plus)) == exc);
+        }
+    }
+
+    const auto sums  = flat_scan_by_hand(src, plus, false, 0);
+    const auto maxes = flat_scan_by_hand(src, greater, false, 0);
+    const auto exc   = flat_scan_by_hand(src, plus, true, 7);
+    CHECK(elements(cumsum(src)) == sums && elements(cumsum(par, src)) == sums);
+    CHECK(elements(cummax(src)) == maxes && elements(cummax(par, src)) == maxes);
+    CHECK(elements(exclusive_scan(src, 7L, plus)) == exc);
+    CHECK(elements(exclusive_scan(par, src, 7L, plus)) == exc);
+
+    // the results have the dimensions of the source, or one level of all
+    // elements
+    CHECK(dimensions(cumsum<1>(src)) == dimensions(src));
+    CHECK(cumsum(src).size() == src.size());
+}
+
+int main()
+{
+    array<int, 3> a(std::array<size_t, 3>{37, 23, 41});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = int((i * 7919) % 1000) - 500;
+    const std::vector<size_t> rows{3, 1, 4, 1, 5, 9, 2, 6};
+
+    test_scans(a);
+    test_scans(a(span(1, 30), span(0, 0, 2), span(3, 40)));
+    test_scans(a(Reversed, span(), span(-1, 0, -3)));
+    test_scans(a(span(rows), span(), span(2, 30)));
+    test_scans(vpermute<2, 0, 1>(a));
+    test_scans(a + a);
+
+    // types of the results
+    const std::vector<short> v{1, 2, 3, 4};
+    const auto cv = cumsum(v);
+    static_assert(std::is_same_v<decltype(cv), const array<int, 1>>);
+    CHECK(cv.size() == 4 && cv[3] == 10);
+    CHECK(cumprod(par, vrange(1, 11))[9] == 3628800);
+
+    // empty arrays, and empty levels
+    const array<double, 1> e(std::array<size_t, 1>{0});
+    CHECK(cumsum(e).size() == 0 && cumsum(par, e).size() == 0);
+    CHECK(exclusive_scan(e, 1.0, [](double x, double y) { return x + y; }).size() == 0);
+    const array<int, 3> z(std::array<size_t, 3>{4, 0, 5});
+    CHECK(cumsum<0>(z).size() == 0 && cummax<1>(par, z).size() == 0 && cumsum(z).size() == 0);
+    CHECK(dimensions(cumsum<2>(z)) == dimensions(z));
+
+    return check_result("test_scan");
+}
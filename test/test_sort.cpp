@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// line l of a 2-level array along Level
+template<size_t Level, typename T>
+std::vector<T> line_of(const array<T, 2>& a, size_t l)
+{
+    std::vector<T> ret;
+    if constexpr (Level == 1)
+        for (size_t i = 0; i < a.template dimension<1>(); ++i)
+            ret.push_back(a.at(l, i));
+    else
+        for (size_t i = 0; i < a.template dimension<0>(); ++i)
+            ret.push_back(a.at(i, l));
+    return ret;
+}
+
+template<typename T>
+bool same_values(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template<typename T, size_t Depth>
+bool same_array(const array<T, Depth>& a, const array<T, Depth>& b)
+{
+    return a.dimensions() == b.dimensions() && std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+// positions that sort a line stably, by std::stable_sort()
+template<typename T, typename Compare>
+std::vector<size_t> stable_positions(const std::vector<T>& line, Compare comp)
+{
+    std::vector<size_t> ret(line.size());
+    std::iota(ret.begin(), ret.end(), size_t(0));
+    std::stable_sort(ret.begin(), ret.end(), [&](size_t i, size_t j) { return comp(line[i], line[j]); });
+    return ret;
+}
+
+// sort, argsort, nth_element and topk of the lines of a along Level, with
+// seq and par, against std::sort() and std::stable_sort() of each line
+template<size_t Level, typename T, typename Compare>
+void test_lines(const array<T, 2>& a, Compare comp)
+{
+    const size_t n_lines = a.template dimension<1 - Level>();
+    const size_t len     = a.template dimension<Level>();
+    const auto sorted     = sort<Level>(a, comp);
+    const auto sorted_par = sort<Level>(par, a, comp);
+    const auto positions     = argsort<Level>(a, comp);
+    const auto positions_par = argsort<Level>(par, a, comp);
+    CHECK(sorted.dimensions() == a.dimensions() && positions.dimensions() == a.dimensions());
+
+    bool ok = true;
+    for (size_t l = 0; l < n_lines; ++l)
+    {
+        const auto line = line_of<Level>(a, l);
+        auto expected = line;
+        std::sort(expected.begin(), expected.end(), comp);
+        ok &= same_values(line_of<Level>(sorted, l), expected);
+        ok &= same_values(line_of<Level>(sorted_par, l), expected);
+        ok &= line_of<Level>(positions, l) == stable_positions(line, comp);
+        ok &= line_of<Level>(positions_par, l) == stable_positions(line, comp);
+    }
+    CHECK(ok);
+
+    if (len == 0)
+        return;
+    ok = true;
+    for (size_t nth : {size_t(0), len / 2, len - 1})
+    {
+        const auto parted = nth_element<Level>(a, nth, comp);
+        for (size_t l = 0; l < n_lines; ++l)
+        {
+            auto expected = line_of<Level>(a, l);
+            std::sort(expected.begin(), expected.end(), comp);
+            const auto line = line_of<Level>(parted, l);
+            ok &= line[nth] == expected[nth];
+            for (size_t i = 0; i < len; ++i)
+                ok &= i < nth ? !comp(line[nth], line[i]) : !comp(line[i], line[nth]);
+        }
+    }
+    for (size_t k : {size_t(0), size_t(1), len / 3, len})
+    {
+        const auto top     = topk<Level>(a, k, comp);
+        const auto top_par = topk<Level>(par, a, k, comp);
+        for (size_t l = 0; l < n_lines; ++l)
+        {
+            auto expected = line_of<Level>(a, l);
+            std::sort(expected.begin(), expected.end(), comp);
+            expected.resize(k);
+            ok &= same_values(line_of<Level>(top, l), expected);
+            ok &= same_values(line_of<Level>(top_par, l), expected);
+        }
+    }
+    CHECK(ok);
+}
+
+// lines of every length around the limits of the sorting methods: merge
+// network, insertion, std::sort() and radix
+template<typename T, typename Gen>
+void test_lengths(Gen gen)
+{
+    for (size_t len : {0, 1, 2, 7, 31, 32, 33, 100, 1023, 1024, 1025, 5000})
+    {
+        const size_t n_lines = len <= 33 ? 100 : 3;
+        array<T, 2> a(std::array<size_t, 2>{n_lines, len});
+        for (size_t i = 0; i < a.size(); ++i)
+            a.data()[i] = gen();
+        test_lines<1>(a, std::less<>{});
+        test_lines<1>(a, std::greater<>{});
+        test_lines<1>(a, [](T x, T y) { return x < y; });
+
+        array<T, 2> b(std::array<size_t, 2>{len, std::min(n_lines, size_t(5))});
+        for (size_t i = 0; i < b.size(); ++i)
+            b.data()[i] = gen();
+        test_lines<0>(b, std::less<>{});
+        test_lines<0>(b, std::greater<>{});
+    }
+}
+
+int main()
+{
+    std::mt19937_64 rng(3);
+
+    test_lengths<int>([&] { return int(rng() % 200) - 100; });
+    test_lengths<float>([&] { return float(int(rng() % 2001) - 1000) * 0.25f; });
+
+    // signed zeros are equivalent, and keep their order in argsort()
+    test_lengths<double>([&]
+    {
+        const uint64_t r = rng() % 8;
+        return r == 0 ? -0.0 : r == 1 ? 0.0 : double(int64_t(rng() % 100) - 50);
+    });
+
+    // extremes of 64-bit integers
+    const int64_t least = std::numeric_limits<int64_t>::min(), greatest = std::numeric_limits<int64_t>::max();
+    test_lengths<int64_t>([&]
+    {
+        const uint64_t r = rng() % 6;
+        return r == 0 ? least : r == 1 ? greatest : r == 2 ? least + 1 : int64_t(rng());
+    });
+    test_lengths<uint16_t>([&] { return uint16_t(rng()); });
+
+    // sorting moves values, so all negative zeros survive
+    {
+        array<double, 1> z(std::array<size_t, 1>{3000});
+        for (size_t i = 0; i < z.size(); ++i)
+            z.data()[i] = i % 3 == 0 ? -0.0 : i % 3 == 1 ? 0.0 : -1.0;
+        const auto s = sort(z);
+        size_t negative_zeros = 0;
+        for (size_t i = 0; i < s.size(); ++i)
+            negative_zeros += s.at(i) == 0.0 && std::signbit(s.at(i));
+        CHECK(negative_zeros == 1000 && s.at(999) == -1.0 && s.at(1000) == 0.0);
+    }
+
+    // argsort() of a one-level object is an index list that sorts it
+    {
+        array<float, 1> a(std::array<size_t, 1>{2000});
+        for (size_t i = 0; i < a.size(); ++i)
+            a.data()[i] = float(rng() % 500);
+        const std::vector<size_t> positions = argsort(a);
+        const auto view = a.vpart(span(positions));
+        const auto sorted = sort(a);
+        bool ok = view.size() == a.size();
+        for (size_t i = 0; i < a.size(); ++i)
+            ok &= view.at(i) == sorted.at(i);
+        CHECK(ok);
+        CHECK(argsort(par, a) == positions);
+    }
+
+    // sources other than arrays, and three levels
+    {
+        array<int, 3> a(std::array<size_t, 3>{6, 40, 7});
+        for (size_t i = 0; i < a.size(); ++i)
+            a.data()[i] = int(rng() % 1000);
+        const auto view = a(span(0, 0, 2), Reversed, span());
+        const auto copy = make_array(view);
+        const auto s = sort<1>(view);
+        CHECK(s.dimensions() == copy.dimensions() && same_array(argsort<1>(view), argsort<1>(copy)));
+        bool ok = true;
+        for (size_t i = 0; i < 3; ++i)
+            for (size_t k = 0; k < 7; ++k)
+            {
+                std::vector<int> line;
+                for (size_t j = 0; j < 40; ++j)
+                    line.push_back(copy.at(i, j, k));
+                std::sort(line.begin(), line.end());
+                for (size_t j = 0; j < 40; ++j)
+                    ok &= s.at(i, j, k) == line[j];
+            }
+        CHECK(ok);
+        CHECK(same_array(sort<0>(a + 1), sort<0>(par, make_array(a + 1))));
+    }
+
+    return check_result("test_sort");
+}
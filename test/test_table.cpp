@@ -0,0 +1,101 @@
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// elements of a 1D argument of table(), by position
+template<typename Array>
+auto arg_at(const Array& arr, size_t i)
+{
+    return arr.at(i);
+}
+inline int arg_at(int, size_t i)
+{
+    return int(i);
+}
+template<typename Array>
+size_t arg_size(const Array& arr)
+{
+    return arr.size();
+}
+inline size_t arg_size(int n)
+{
+    return size_t(n);
+}
+
+// table() against nested loops over the same arguments, with and without a policy
+template<typename Function, typename A, typename B>
+void test_table2(Function fn, const A& a, const B& b)
+{
+    const auto t = table(fn, a, b);
+    const auto p = table(par, fn, a, b);
+    const size_t m = arg_size(a), n = arg_size(b);
+    bool ok = t.template dimension<0>() == m && t.template dimension<1>() == n &&
+              p.template dimension<0>() == m && p.template dimension<1>() == n;
+    for (size_t i = 0; i < m && ok; ++i)
+        for (size_t j = 0; j < n; ++j)
+            ok &= t.at(i, j) == fn(arg_at(a, i), arg_at(b, j)) && p.at(i, j) == t.at(i, j);
+    CHECK(ok);
+}
+
+template<typename Function, typename A, typename B, typename C>
+void test_table3(Function fn, const A& a, const B& b, const C& c)
+{
+    const auto t = table(fn, a, b, c);
+    const auto p = table(par, fn, a, b, c);
+    const size_t m = arg_size(a), n = arg_size(b), k = arg_size(c);
+    bool ok = t.size() == m * n * k && p.size() == m * n * k;
+    for (size_t i = 0; i < m && ok; ++i)
+        for (size_t j = 0; j < n; ++j)
+            for (size_t l = 0; l < k; ++l)
+                ok &= t.at(i, j, l) == fn(arg_at(a, i), arg_at(b, j), arg_at(c, l)) && p.at(i, j, l) == t.at(i, j, l);
+    CHECK(ok);
+}
+
+int main()
+{
+    auto add  = [](auto x, auto y) { return x * 1000 + y; };
+    auto add3 = [](auto x, auto y, auto z) { return (x * 1000 + y) * 1000 + z; };
+
+    // integer arguments and integer ranges, generated without a buffer
+    for (int n : {0, 1, 5, 37, 1000})
+        for (int m : {0, 1, 3, 129})
+        {
+            test_table2(add, n, m);
+            test_table2(add, vrange(-3, n - 3), vrange(m));
+            test_table2(add, vrange(n, -n, -2), vrange(2, 2 + 3 * m, 3));
+            test_table3([](int i, int j, int l) { return int64_t(i) * 1000000 + j * 1000 + l; }, n, m, 7);
+        }
+    test_table3(add3, vrange(4), vrange(100, 40, -7), 33);
+
+    // floating-point ranges, whose elements must be those of the range itself
+    for (int n : {1, 9, 300})
+    {
+        const auto xs = vrange(0.0f, 1.0f, 1.0f / float(n));
+        const auto ys = vrange(-2.5, 2.5 + n);
+        test_table2([](float x, double y) { return double(x) * y; }, xs, ys);
+        test_table2([](double y, float x) { return y - double(x); }, ys, xs);
+        test_table2([](float x, float y) { return x * y + 1.0f; }, xs, xs);
+    }
+
+    // arrays, vectors, simple views and views gathered into a buffer
+    array<double, 2> a(std::array<size_t, 2>{20, 31});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = 0.25 * double(i);
+    std::vector<float> v{1.0f, 2.0f, 3.0f};
+    auto mul = [](auto x, auto y) { return double(x) * double(y); };
+    test_table2(mul, v, a(3, span()));
+    test_table2(mul, a(span(0, 20, 3), 4), vrange(0.5, 9.5));
+    test_table2(mul, vtranspose(a)(2, span()), 7);
+    test_table3([](float x, int i, double y) { return double(x) * i + y; },
+                v, vrange(5, 50, 4), a(span(1, 19, 2), 0));
+
+    const auto t = table([](float x, int i) { return x * float(i); }, v, vrange(2, 4));
+    CHECK(t.dimension<0>() == 3 && t.dimension<1>() == 2 && t.at(2, 1) == 9.0f);
+
+    return check_result("test_table");
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// the transpose of a matrix by the definition
+template<typename T>
+array<T, 2> scalar_transpose(const array<T, 2>& a)
+{
+    const size_t m = a.template dimension<0>(), n = a.template dimension<1>();
+    array<T, 2> t(std::array<size_t, 2>{n, m});
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < n; ++j)
+            t.data()[j * m + i] = a.data()[i * n + j];
+    return t;
+}
+
+template<typename T>
+bool equal_arrays(const array<T, 2>& a, const array<T, 2>& b)
+{
+    return a.template dimension<0>() == b.template dimension<0>() &&
+        a.template dimension<1>() == b.template dimension<1>() &&
+        std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+template<typename T>
+void test_transpose(size_t m, size_t n)
+{
+    array<T, 2> a(std::array<size_t, 2>{m, n});
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = T(i * 7 + 1);
+    const array<T, 2> expected = scalar_transpose(a);
+
+    CHECK(equal_arrays(make_array(vtranspose(a)), expected));
+    CHECK(equal_arrays(transpose(a), expected));
+    CHECK(equal_arrays(transpose(par, a), expected));
+
+    // a transposed sub-block assigned into a sub-block of another array
+    if (m > 3 && n > 5)
+    {
+        array<T, 2> d(std::array<size_t, 2>{n + 2, m + 3});
+        d.vpart(span(1, n - 1), span(2, m - 1)) = vtranspose(a.vpart(span(2, m - 1), span(1, n - 1)));
+        bool ok = true;
+        for (size_t i = 1; i < n - 1; ++i)
+            for (size_t j = 2; j < m - 1; ++j)
+                ok &= d.at(i, j) == expected.at(i, j);
+        CHECK(ok);
+    }
+
+    // permutations of a 3D array
+    array<T, 3> b(std::array<size_t, 3>{3, m, n});
+    for (size_t i = 0; i < b.size(); ++i)
+        b.data()[i] = T(i);
+    auto p = permute<0, 2, 1>(b);
+    auto q = permute<2, 1, 0>(b);
+    bool ok = true;
+    for (size_t k = 0; k < 3; ++k)
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < m; ++j)
+                ok &= p.at(k, i, j) == b.at(k, j, i) && q.at(i, j, k) == b.at(k, j, i);
+    CHECK(ok);
+
+    // a square matrix transposed onto itself
+    array<T, 2> s(std::array<size_t, 2>{m, m});
+    for (size_t i = 0; i < s.size(); ++i)
+        s.data()[i] = T(i);
+    const array<T, 2> s_expected = scalar_transpose(s);
+    s = vtranspose(s);
+    CHECK(equal_arrays(s, s_expected));
+}
+
+#if defined(NDARRAY_X86_SIMD)
+
+// a transpose kernel against the scalar definition, on padded strides and
+// with the destination guard elements left untouched
+template<typename T, typename Kernel>
+void test_kernel(Kernel kernel, size_t block)
+{
+    const size_t m = block * 3, n = block * 2;
+    const size_t src_stride = m + 5, dst_stride = n + 3;
+    std::vector<T> src(n * src_stride), dst(m * dst_stride, T(0));
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = T(i + 1);
+    kernel(src.data(), ptrdiff_t(src_stride), dst.data(), ptrdiff_t(dst_stride), m, n);
+    bool ok = true;
+    for (size_t i = 0; i < m; ++i)
+        for (size_t j = 0; j < dst_stride; ++j)
+            ok &= dst[i * dst_stride + j] == (j < n ? src[i + j * src_stride] : T(0));
+    CHECK(ok);
+}
+
+#endif
+
+int main()
+{
+    for (size_t m : {1, 5, 8, 17, 33, 64, 100})
+        for (size_t n : {1, 3, 16, 31, 70})
+        {
+            test_transpose<float>(m, n);
+            test_transpose<double>(m, n);
+            test_transpose<int16_t>(m, n);
+            test_transpose<int32_t>(m, n);
+            test_transpose<int64_t>(m, n);
+        }
+    test_transpose<float>(257, 515);
+    test_transpose<double>(515, 257);
+
+#if defined(NDARRAY_X86_SIMD)
+    const simd_level_type level = simd_level();
+    if (level != simd_level_type::scalar)
+    {
+        test_kernel<float>(_transpose_copy_avx2_32, 8);
+        test_kernel<double>(_transpose_copy_avx2_64, 4);
+    }
+    if (level == simd_level_type::avx512)
+    {
+        test_kernel<float>(_transpose_copy_avx512_32, 16);
+        test_kernel<double>(_transpose_copy_avx512_64, 8);
+    }
+#endif
+
+    return check_result("test_transpose");
+}
@@ -0,0 +1,99 @@
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include "ndarray/ndarray.h"
+#include "check.h"
+
+using namespace ndarray;
+
+// at() of every position of view refers to the element of the array at the
+// offset computed by offset_of() from the position
+template<typename View, typename OffsetOf>
+void test_at(const View& view, const int* data, OffsetOf offset_of)
+{
+    const auto dims = dimensions(view);
+    size_t size = 1;
+    for (size_t dim : dims)
+        size *= dim;
+
+    bool ok = view.size() == size;
+    auto pos = dims;
+    for (size_t n = 0; n < size && ok; ++n)
+    {
+        size_t rest = n;
+        for (size_t l = dims.size(); l-- > 0;)
+        {
+            pos[l] = rest % dims[l];
+            rest /= dims[l];
+        }
+        const int* elem = &std::apply([&](auto... ints) -> auto& { return view.at(ints...); }, pos);
+        ok = ok && elem == data + offset_of(pos);
+        ok = ok && &view.tuple_at(std::tuple_cat(pos)) == elem;
+    }
+    CHECK(ok);
+}
+
+int main()
+{
+    const std::array<size_t, 6> dims{6, 5, 4, 7, 3, 2};
+    std::array<size_t, 6> strides;
+    strides[5] = 1;
+    for (size_t l = 5; l > 0; --l)
+        strides[l - 1] = strides[l] * dims[l];
+
+    array<int, 6> a(dims);
+    for (size_t i = 0; i < a.size(); ++i)
+        a.data()[i] = int(i);
+    const int* data = a.data();
+    const std::vector<size_t> list{3, 0, 2, 2};
+
+    // six levels, every kind of indexer
+    test_at(a(span(), span(), span(), span(), span(), span()), data, [&](const auto& p)
+    {
+        size_t offset = 0;
+        for (size_t l = 0; l < 6; ++l)
+            offset += p[l] * strides[l];
+        return offset;
+    });
+    test_at(a(span(1, 0, 2), Reversed, span(list), span(2, 6), span(0, 0, 2), span()), data, [&](const auto& p)
+    {
+        return (1 + 2 * p[0]) * strides[0] + (4 - p[1]) * strides[1] + list[p[2]] * strides[2] +
+               (2 + p[3]) * strides[3] + 2 * p[4] * strides[4] + p[5];
+    });
+
+    // five and four levels, with levels collapsed by scalar indices
+    test_at(a(span(), 3, span(list), span(-1, 0, -3), span(), span()), data, [&](const auto& p)
+    {
+        return p[0] * strides[0] + 3 * strides[1] + list[p[1]] * strides[2] +
+               (6 - 3 * p[2]) * strides[3] + p[3] * strides[4] + p[4];
+    });
+    test_at(a(span(list), span(1, 4), 2, span(), 1, Reversed), data, [&](const auto& p)
+    {
+        return list[p[0]] * strides[0] + (1 + p[1]) * strides[1] + 2 * strides[2] +
+               p[2] * strides[3] + strides[4] + (1 - p[3]);
+    });
+
+    // views of views
+    const auto v = a(span(1, 0, 2), span(), span(list), Reversed, span(), span());
+    test_at(v(Reversed, span(0, 0, 2), span(), span(1, 5), 2, span()), data, [&](const auto& p)
+    {
+        return (5 - 2 * p[0]) * strides[0] + 2 * p[1] * strides[1] + list[p[2]] * strides[2] +
+               (5 - p[3]) * strides[3] + 2 * strides[4] + p[4];
+    });
+    test_at(v(span(), span(list), 1, span(), span(), span()), data, [&](const auto& p)
+    {
+        return (1 + 2 * p[0]) * strides[0] + list[p[1]] * strides[1] + list[1] * strides[2] +
+               (6 - p[2]) * strides[3] + p[3] * strides[4] + p[4];
+    });
+
+    // the const view of a const array
+    const array<int, 6>& ca = a;
+    test_at(ca(span(1, 3), span(), span(list), 6, span(0, 0, 2), span()), data, [&](const auto& p)
+    {
+        return (1 + p[0]) * strides[0] + p[1] * strides[1] + list[p[2]] * strides[2] +
+               6 * strides[3] + 2 * p[3] * strides[4] + p[4];
+    });
+
+    return check_result("test_view_at");
+}